@@ -0,0 +1,24 @@
+# Finds libnuma and defines the imported target nope::numa
+#
+# Result variables:
+#   NUMA_FOUND, NUMA_INCLUDE_DIR, NUMA_LIBRARY
+#
+# The module is installed next to nopeConfig.cmake, so applications linking
+# the static core library resolve libnuma on their own machine.
+find_path(NUMA_INCLUDE_DIR numa.h)
+find_library(NUMA_LIBRARY numa)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(NUMA
+    REQUIRED_VARS NUMA_LIBRARY NUMA_INCLUDE_DIR
+)
+mark_as_advanced(NUMA_INCLUDE_DIR NUMA_LIBRARY)
+
+if(NUMA_FOUND AND NOT TARGET nope::numa)
+    add_library(nope::numa UNKNOWN IMPORTED)
+    set_target_properties(nope::numa
+        PROPERTIES
+            IMPORTED_LOCATION "${NUMA_LIBRARY}"
+            INTERFACE_INCLUDE_DIRECTORIES "${NUMA_INCLUDE_DIR}"
+    )
+endif()
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nope {
+/**
+ * \brief NUMA placement of large tensor allocations.
+ */
+enum class NumaPlacement : uint8_t {
+    /// Pages are placed on the node of the thread touching them first
+    FirstTouch = 0,
+    /// Pages are distributed round-robin across all nodes
+    Interleave = 1,
+    /// All pages are placed on the \a AllocationPolicy::numa_node
+    Bind = 2
+};
+
+/**
+ * \brief Placement policy of tensor storages owning large contiguous blocks.
+ *
+ * Blocks of at least \a huge_pages_threshold bytes are mapped directly from
+ * the OS, aligned to the huge page size and advised to be backed by
+ * transparent huge pages. Smaller blocks are allocated from the heap.
+ */
+struct AllocationPolicy {
+    /// Minimal size of the block in bytes mapped with huge pages
+    size_t huge_pages_threshold{size_t{32} << 20};
+    /// Touch pages of the mapped block in parallel with the same static
+    /// partitioning as parallelFor over the elements, so each page is placed
+    /// on the node of the thread processing it in parallel kernels
+    bool parallel_first_touch{true};
+    NumaPlacement numa_placement{NumaPlacement::FirstTouch};
+    /// Target node for NumaPlacement::Bind
+    int numa_node{0};
+};
+
+AllocationPolicy getAllocationPolicy();
+
+/**
+ * \brief Changes policy of the following allocations. Already allocated
+ * storages are not affected.
+ */
+void setAllocationPolicy(const AllocationPolicy& policy);
+
+/**
+ * \brief Checks whenever library is built with libnuma and the machine has
+ * more than one NUMA node. Otherwise NUMA placements other than first touch
+ * have no effect.
+ */
+bool isNumaAvailable() noexcept;
+} // namespace nope
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Element-wise binary arithmetic operations. Integer operations wrap
+ * around on overflow, Div is defined for floating point types only.
+ */
+enum class BinaryOp : uint8_t { Add, Sub, Mul, Div };
+
+/**
+ * \brief Layout of operands recognized by the execution plan of a binary
+ * operation after broadcasting and coalescing of dimensions.
+ */
+enum class BroadcastPattern : uint8_t {
+    /// Strided runs, contiguous runs are vectorized
+    Generic,
+    /// Operand is a single value, it is kept in a register
+    ScalarLhs,
+    ScalarRhs,
+    /// Operand is a row repeated over the outer dimensions (bias add), it is
+    /// processed in column blocks, so the block stays in cache
+    RowLhs,
+    RowRhs,
+    /// Operand has a single value per row (per channel scale), the value is
+    /// kept in a register for the whole row
+    ColumnLhs,
+    ColumnRhs
+};
+
+/**
+ * \brief Applies \a op to \a lhs and \a rhs broadcasted to a common shape.
+ *
+ * \return Contiguous tensor of the broadcasted shape and operands data type.
+ *
+ * \throw TypesMismatchError if data types are different or not supported by
+ *      \a op.
+ * \throw std::length_error if shapes are not broadcastable.
+ */
+Tensor applyBinary(BinaryOp op, const Tensor& lhs, const Tensor& rhs);
+
+/**
+ * \brief Writes \a op applied to \a lhs and \a rhs broadcasted to the shape
+ * of \a out into \a out.
+ *
+ * \a out might be one of the operands for in-place evaluation, other kinds of
+ * memory overlap produce unspecified results.
+ *
+ * \throw TypesMismatchError if data types are different or not supported by
+ *      \a op.
+ * \throw std::length_error if operands are not broadcastable to \a out shape.
+ */
+void applyBinary(BinaryOp op, const Tensor& lhs, const Tensor& rhs, Tensor& out);
+
+/**
+ * \brief Pattern selected for \a lhs and \a rhs broadcasted to the shape of
+ * \a out. Generic if pattern kernels are disabled.
+ *
+ * \throw std::length_error if operands are not broadcastable to \a out shape.
+ */
+BroadcastPattern
+selectBroadcastPattern(const Tensor& lhs, const Tensor& rhs, const Tensor& out);
+
+/**
+ * \brief Enables or disables kernels specialized for broadcast patterns,
+ * disabled kernels make every operation take the generic path. Intended for
+ * benchmarking and debugging, enabled by default.
+ */
+void setBroadcastPatternKernelsEnabled(bool enabled) noexcept;
+
+bool broadcastPatternKernelsEnabled() noexcept;
+} // namespace nope
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Joins \a tensors along the existing \a axis.
+ *
+ * Output is allocated once. Contiguous inputs are copied as blocks of
+ * contiguous bytes, their total size is split into equal ranges processed in
+ * parallel, so both many small inputs and a few large ones occupy all threads.
+ * Other inputs are copied with \a copyStrided.
+ *
+ * \param tensors Non-empty list of tensors with the same data type, number of
+ *      dimensions and shape except \a axis.
+ * \param axis Axis to join along, might be negative.
+ *
+ * \return Contiguous tensor.
+ *
+ * \throw std::invalid_argument if \a tensors is empty.
+ * \throw TypesMismatchError if data types are different.
+ * \throw std::length_error if shapes are incompatible or tensors are 0-d.
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+Tensor concatenate(const std::vector<Tensor>& tensors, int64_t axis = 0);
+
+/**
+ * \brief Joins \a tensors of the same shape along the new \a axis of the output.
+ *
+ * \overload \a concatenate of \a tensors viewed with extent 1 at \a axis.
+ *
+ * \param axis Position of the new axis in the output, might be negative.
+ *
+ * \throw std::length_error if shapes are different.
+ */
+Tensor stack(const std::vector<Tensor>& tensors, int64_t axis = 0);
+
+/**
+ * \brief Splits \a src along \a axis into views of \a split_size elements,
+ * the last one is smaller if the axis extent is not divisible by \a split_size.
+ * Views share storage with \a src, nothing is copied.
+ *
+ * \throw std::invalid_argument if \a split_size is not positive.
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+std::vector<Tensor> split(const Tensor& src, int64_t split_size, int64_t axis = 0);
+
+/**
+ * \brief Splits \a src along \a axis into views with extents \a sizes.
+ *
+ * \throw std::invalid_argument if \a sizes are negative or their sum is not
+ *      equal to the axis extent.
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+std::vector<Tensor>
+splitWithSizes(const Tensor& src, const std::vector<int64_t>& sizes, int64_t axis = 0);
+
+/**
+ * \brief Splits \a src along \a axis into at most \a chunks views of the same
+ * extent rounded up, the last one might be smaller.
+ *
+ * \throw std::invalid_argument if \a chunks is not positive.
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+std::vector<Tensor> chunk(const Tensor& src, int64_t chunks, int64_t axis = 0);
+
+/**
+ * \brief Views of \a src at every position along \a axis with \a axis removed.
+ *
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+std::vector<Tensor> unbind(const Tensor& src, int64_t axis = 0);
+} // namespace nope
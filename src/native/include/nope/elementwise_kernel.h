@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "nope/tensor.h"
+#include "nope/tensor_data_type.h"
+
+namespace nope {
+/**
+ * \brief Inner loop of a user-defined element-wise operation.
+ *
+ * Computes \a count output elements from elements of the inputs. \a data
+ * holds pointers to the first elements of the inputs followed by the output
+ * pointer, \a strides holds their byte strides in the same order. Stride of
+ * a broadcasted input is 0. Inputs are only read.
+ *
+ * The function is called concurrently from several threads for disjoint
+ * parts of the output, so it should be thread-safe. It is a plain C function,
+ * so it might be compiled by any language with C calling convention.
+ */
+using ElementwiseLoopFunction = void (*)(std::byte* const* data,
+                                         const int64_t* strides,
+                                         int64_t count,
+                                         void* user_data);
+
+/**
+ * \brief Element-wise operation with user-supplied inner loops executed by the
+ * library broadcasting engine: inputs are broadcasted, dimensions with
+ * compatible layouts are coalesced into long runs and runs are split between
+ * threads.
+ *
+ * Loops are registered per data type of the inputs, all inputs of a call
+ * should have the same data type. Each loop declares the data type of its
+ * output.
+ */
+class ElementwiseKernel {
+public:
+    /// Maximal number of inputs of an operation
+    static constexpr int64_t kMaxInputs = 8;
+
+    /// Default minimal number of output elements processed by a single thread
+    static constexpr int64_t kDefaultGrainSize = 32 * 1024;
+
+    /**
+     * \param name Name used in error messages.
+     * \param n_inputs Number of inputs in [1, kMaxInputs].
+     * \param grain_size Minimal number of output elements processed by a single
+     *      thread, lower values suit expensive per element computations.
+     *
+     * \throw std::invalid_argument if \a n_inputs or \a grain_size is out of range.
+     */
+    ElementwiseKernel(std::string name,
+                      int64_t n_inputs,
+                      int64_t grain_size = kDefaultGrainSize);
+
+    /**
+     * \brief Registers \a function as the inner loop for inputs of \a dtype,
+     * replacing previously registered one.
+     *
+     * \param dtype Data type of the inputs.
+     * \param function Inner loop function.
+     * \param out_dtype Data type of the output, the same as \a dtype if not set.
+     * \param user_data Opaque pointer passed to every call of \a function.
+     *
+     * \throw std::invalid_argument if \a function is null.
+     */
+    void registerLoop(TensorDataType dtype,
+                      ElementwiseLoopFunction function,
+                      std::optional<TensorDataType> out_dtype = std::nullopt,
+                      void* user_data = nullptr);
+
+    bool hasLoop(TensorDataType dtype) const noexcept;
+
+    /**
+     * \brief Applies the operation to \a inputs broadcasted to a common shape.
+     *
+     * \return Contiguous tensor of the broadcasted shape.
+     *
+     * \throw std::invalid_argument if number of inputs is wrong.
+     * \throw std::length_error if input shapes are not broadcastable.
+     * \throw TypesMismatchError if inputs have different data types or there
+     *      is no loop for their data type.
+     */
+    Tensor operator()(const std::vector<Tensor>& inputs) const;
+
+    /**
+     * \brief Writes result of the operation applied to \a inputs broadcasted
+     * to the shape of \a out into \a out.
+     *
+     * \a out might be one of the inputs for in-place evaluation, other kinds of
+     * memory overlap produce unspecified results.
+     *
+     * \throw std::invalid_argument if number of inputs is wrong.
+     * \throw std::length_error if inputs are not broadcastable to \a out shape.
+     * \throw TypesMismatchError if inputs have different data types, there is
+     *      no loop for their data type or \a out data type is not the one
+     *      declared by the loop.
+     */
+    void operator()(const std::vector<Tensor>& inputs, Tensor& out) const;
+
+    const std::string& name() const noexcept {
+        return name_;
+    }
+
+    int64_t inputsCount() const noexcept {
+        return n_inputs_;
+    }
+
+    int64_t grainSize() const noexcept {
+        return grain_size_;
+    }
+
+private:
+    struct Loop {
+        ElementwiseLoopFunction function{nullptr};
+        TensorDataType out_dtype;
+        void* user_data{nullptr};
+    };
+
+    const Loop& findLoop(const std::vector<Tensor>& inputs) const;
+
+    std::string name_;
+    int64_t n_inputs_;
+    int64_t grain_size_;
+    std::array<std::optional<Loop>, TensorDataType::kTypesCount> loops_{};
+};
+} // namespace nope
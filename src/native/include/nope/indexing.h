@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Takes slices of \a src along \a axis at positions given by \a indices.
+ *
+ * Equivalent of NumPy \a take, output shape is
+ * \code src.shape[:axis] + indices.shape + src.shape[axis + 1:] \endcode
+ * Each slice is copied as a single block when it is contiguous in \a src.
+ *
+ * \param src Source tensor.
+ * \param indices Tensor of any integer data type. Negative indices are counted
+ *      from the end of the axis.
+ * \param axis Axis to take slices along, might be negative.
+ *
+ * \return Contiguous tensor with taken slices.
+ *
+ * \throw std::out_of_range if \a axis or any of \a indices is out of bounds.
+ * \throw TypesMismatchError if \a indices data type is not an integer one.
+ */
+Tensor take(const Tensor& src, const Tensor& indices, int64_t axis);
+
+/**
+ * \brief Selects slices of \a src along \a axis at positions given by 1-D
+ * \a indices. Output has the same number of dimensions as \a src.
+ *
+ * \overload \a take for 1-D indices.
+ *
+ * \throw std::length_error if \a indices is not 1-D.
+ */
+Tensor indexSelect(const Tensor& src, int64_t axis, const Tensor& indices);
+
+/**
+ * \brief Adds values of \a src into \a out at positions along \a axis given by
+ * \a index. For 3-D tensors and axis 1:
+ * \code out[i][index[i][j][k]][k] += src[i][j][k] \endcode
+ *
+ * Accumulation is atomic-free: each thread owns either a range of output
+ * columns (all coordinates except \a axis are fixed) or, when there are fewer
+ * columns than threads, a range of positions along \a axis. Every output
+ * element is updated in the same order regardless of number of threads.
+ *
+ * \param out Accumulator tensor, updated in place.
+ * \param axis Axis to scatter along, might be negative.
+ * \param index Tensor of any integer data type with the same shape as \a src.
+ *      Its extent in every dimension except \a axis can't exceed \a out one.
+ * \param src Added values with the same data type as \a out.
+ *
+ * \throw TypesMismatchError if data types are incompatible.
+ * \throw std::length_error if shapes are incompatible.
+ * \throw std::out_of_range if \a axis or any of \a index is out of bounds.
+ */
+void scatterAdd(Tensor& out, int64_t axis, const Tensor& index, const Tensor& src);
+
+/**
+ * \brief Gathers elements of \a src where \a mask is non-zero into 1-D tensor
+ * preserving the row-major order.
+ *
+ * Compaction is performed in 2 parallel passes: selected elements are counted
+ * per chunk, then each chunk writes its elements at the known offset. 4 and 8
+ * bytes elements are compressed with AVX-512 or AVX2 when CPU supports them.
+ *
+ * \param src Source tensor.
+ * \param mask Bool or UInt8 tensor with the same shape as \a src.
+ *
+ * \throw TypesMismatchError if \a mask data type is not Bool or UInt8.
+ * \throw std::length_error if shapes are different.
+ */
+Tensor maskedSelect(const Tensor& src, const Tensor& mask);
+} // namespace nope
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Element-wise transcendental functions of Float32 and Float64 tensors.
+ *
+ * On CPUs with AVX2 and FMA functions are evaluated by vectorized polynomial
+ * approximations, 8 Float32 or 4 Float64 elements at once. Maximal errors in
+ * units in the last place (ULP) measured against correctly rounded results,
+ * the same for both data types:
+ *  - Exp, Log, Erf: 1
+ *  - Tanh, Sigmoid: 3
+ *  - Gelu: 5
+ *
+ * Bounds hold for the whole domain including subnormal results, except for
+ * Gelu of inputs below -13.8 (Float32) or -38.6 (Float64), whose results
+ * underflow to zero. Special values follow C library conventions: NaNs are
+ * propagated, Log of negative numbers is NaN and Log of zero is -infinity.
+ * Other CPUs use C library functions.
+ */
+enum class MathOp : uint8_t {
+    Exp,
+    Log,
+    Tanh,
+    /// \code 1 / (1 + exp(-x)) \endcode
+    Sigmoid,
+    Erf,
+    /// \code x * (1 + erf(x / sqrt(2))) / 2 \endcode
+    Gelu
+};
+
+/**
+ * \brief Applies \a op to every element of \a src.
+ *
+ * Every element is read and written once, composite functions (Sigmoid and
+ * Gelu) are evaluated in registers without intermediate tensors.
+ * Strided tensors are processed without making them contiguous, work is split
+ * between threads.
+ *
+ * \return Contiguous tensor of the same shape and data type as \a src.
+ *
+ * \throw TypesMismatchError if \a src is neither Float32 nor Float64.
+ */
+Tensor applyMath(MathOp op, const Tensor& src);
+
+/**
+ * \brief Writes \a op of \a src elements broadcasted to the shape of \a dst
+ * into \a dst.
+ *
+ * \a dst might be \a src itself for in-place evaluation, other kinds of
+ * memory overlap produce unspecified results.
+ *
+ * \throw TypesMismatchError if data types are different or not floating
+ *      point.
+ * \throw std::length_error if \a src is not broadcastable to \a dst shape.
+ */
+void applyMath(MathOp op, const Tensor& src, Tensor& dst);
+} // namespace nope
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nope {
+/**
+ * \brief Snapshot of tensor storage memory counters.
+ *
+ * Owned bytes are allocated by the library, external bytes are referred by
+ * storages wrapping foreign memory released with custom \a BytesFree (or not
+ * released at all with \a freeNothing).
+ */
+struct MemoryStats {
+    /// Bytes of currently alive storages, owned + external
+    int64_t live_bytes{0};
+    /// High-watermark of \a live_bytes since start or the last reset
+    int64_t peak_bytes{0};
+    /// Number of currently alive storages
+    int64_t live_allocations{0};
+    /// Total number of created storages
+    int64_t allocations{0};
+    int64_t owned_bytes{0};
+    int64_t external_bytes{0};
+};
+
+/**
+ * \brief Global counters of all tensor storages.
+ */
+MemoryStats memoryStats();
+
+/**
+ * \brief Counters of storages created inside \a MemoryTagGuard scopes of the
+ * \a tag. Zero stats if the tag was never used.
+ */
+MemoryStats memoryStats(const std::string& tag);
+
+/**
+ * \brief Counters of every tag used so far.
+ */
+std::map<std::string, MemoryStats> memoryStatsByTag();
+
+/**
+ * \brief Resets peak bytes of global and per-tag counters to the current live
+ * bytes.
+ */
+void resetPeakMemoryStats();
+
+/**
+ * \brief Attributes storages created by the current thread during the guard
+ * lifetime to \a tag. Scopes can be nested, the innermost tag is used.
+ * Storages are accounted to their tag until destruction even if they are
+ * released outside of the scope.
+ */
+class MemoryTagGuard {
+public:
+    explicit MemoryTagGuard(const std::string& tag);
+
+    MemoryTagGuard(const MemoryTagGuard&) = delete;
+    MemoryTagGuard& operator=(const MemoryTagGuard&) = delete;
+
+    ~MemoryTagGuard();
+};
+
+/**
+ * \brief Information about an alive storage recorded in debug mode.
+ */
+struct AllocationRecord {
+    int64_t bytes{0};
+    bool external{false};
+    std::string tag;
+    std::string site;
+};
+
+/**
+ * \brief Returns description of the current allocation site, e.g. stack
+ * trace of the caller.
+ */
+using AllocationSiteProvider = std::function<std::string()>;
+
+/**
+ * \brief Enables recording of every storage allocation with its tag and site
+ * given by \a site_provider (might be empty). Recording is slow and intended
+ * for hunting leaked long-lived tensors.
+ */
+void enableMemoryDebugMode(AllocationSiteProvider site_provider = {});
+
+void disableMemoryDebugMode();
+
+bool isMemoryDebugModeEnabled() noexcept;
+
+/**
+ * \brief Records of storages allocated in debug mode and still alive.
+ */
+std::vector<AllocationRecord> liveAllocations();
+} // namespace nope
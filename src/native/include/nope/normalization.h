@@ -0,0 +1,84 @@
+#pragma once
+
+#include <optional>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Softmax of Float32 or Float64 \a src over the last axis.
+ *
+ * Rows are processed in parallel, each one in blocks fitting into L1 and in
+ * 2 passes over its memory. The first pass finds the maximum and the sum of
+ * exponents online (the sum is rescaled when the maximum grows) and stores
+ * exponents into the output, the second one rescales them. Exponents are
+ * computed by the vectorized Exp of \a applyMath. Rows might be strided.
+ *
+ * \return Contiguous tensor of the same shape and data type as \a src.
+ *
+ * \throw TypesMismatchError if \a src is neither Float32 nor Float64.
+ * \throw std::length_error if \a src is 0-dimensional.
+ */
+Tensor softmax(const Tensor& src);
+
+/**
+ * \brief Writes softmax of \a src over the last axis into \a out of the same
+ * shape, \a out might be \a src for in-place evaluation.
+ *
+ * \throw TypesMismatchError if data types are different or not floating
+ *      point.
+ * \throw std::length_error if shapes are different or \a src is 0-dimensional.
+ */
+void softmax(const Tensor& src, Tensor& out);
+
+/**
+ * \brief Logarithm of softmax of \a src over the last axis. The first pass
+ * finds the maximum and the sum of exponents online, the second one writes
+ * \code x - max - log(sum) \endcode
+ *
+ * \overload \a softmax
+ */
+Tensor logSoftmax(const Tensor& src);
+
+void logSoftmax(const Tensor& src, Tensor& out);
+
+/**
+ * \brief Layer normalization of \a src over the last axis:
+ * \code (x - mean) / sqrt(var + eps) * gamma + beta \endcode
+ *
+ * The first pass computes mean and biased variance of each block relative to
+ * the block mean and combines them into the row ones in double precision. The
+ * second pass writes the normalized row subtracting the mean as a rounded
+ * value and its residual, so precision does not suffer from means much larger
+ * than the standard deviation.
+ *
+ * \param src Float32 or Float64 tensor.
+ * \param gamma Scales broadcastable to \a src, usually of the last axis size.
+ *      Not applied if empty.
+ * \param beta Shifts broadcastable to \a src, not applied if empty.
+ * \param eps Added to the variance.
+ *
+ * \return Contiguous tensor of the same shape and data type as \a src.
+ *
+ * \throw TypesMismatchError if data types are different or not floating
+ *      point.
+ * \throw std::length_error if \a src is 0-dimensional or \a gamma or \a beta
+ *      is not broadcastable to \a src.
+ */
+Tensor layerNorm(const Tensor& src,
+                 const std::optional<Tensor>& gamma,
+                 const std::optional<Tensor>& beta,
+                 double eps = 1e-5);
+
+/**
+ * \brief Writes layer normalization of \a src over the last axis into \a out
+ * of the same shape, \a out might be \a src for in-place evaluation.
+ *
+ * \overload \a layerNorm
+ */
+void layerNorm(const Tensor& src,
+               const std::optional<Tensor>& gamma,
+               const std::optional<Tensor>& beta,
+               double eps,
+               Tensor& out);
+} // namespace nope
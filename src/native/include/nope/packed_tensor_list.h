@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief List of tensors of the same data type and rank, e.g. variable length
+ * sequences, packed one after another into a single contiguous storage.
+ *
+ * Items are described by a flat table of shapes and element offsets, so the
+ * whole list costs one storage allocation regardless of the number of items.
+ * Tensors returned by item() are views sharing the list storage. Lists
+ * produced by operations on the list share its layout table.
+ */
+class PackedTensorList {
+public:
+    /**
+     * \brief Allocates uninitialized list of items with the given \a shapes.
+     *
+     * \throw std::length_error if shapes have different lengths.
+     */
+    PackedTensorList(const std::vector<std::vector<int64_t>>& shapes,
+                     TensorDataType dtype = TensorDataType::Float32);
+
+    /**
+     * \brief Packs copies of \a tensors. Tensors with arbitrary strides are
+     * copied in parallel.
+     *
+     * \throw std::length_error if \a tensors is empty or tensors have
+     *      different ranks.
+     * \throw TypesMismatchError if tensors have different data types.
+     */
+    explicit PackedTensorList(const std::vector<Tensor>& tensors);
+
+    size_t size() const noexcept {
+        return static_cast<size_t>(layout_->offsets.size() - 1);
+    }
+
+    TensorDataType dtype() const noexcept {
+        return data_.dtype();
+    }
+
+    /**
+     * \brief Rank shared by all items.
+     */
+    size_t itemDims() const noexcept {
+        return static_cast<size_t>(layout_->item_dims);
+    }
+
+    /**
+     * \brief Total number of elements of all items.
+     */
+    int64_t numel() const noexcept {
+        return layout_->offsets.back();
+    }
+
+    /**
+     * \brief Element offsets of the items in the packed data followed by the
+     * total number of elements, \a size() + 1 values.
+     */
+    const std::vector<int64_t>& offsets() const noexcept {
+        return layout_->offsets;
+    }
+
+    /**
+     * \brief Pointer to \a itemDims() extents of the item \a i.
+     */
+    const int64_t* itemShapeData(size_t i) const noexcept {
+        return layout_->shapes.data() + i * itemDims();
+    }
+
+    std::vector<int64_t> itemShape(size_t i) const;
+
+    /**
+     * \brief 1-D contiguous tensor of all packed elements.
+     */
+    const Tensor& data() const noexcept {
+        return data_;
+    }
+
+    Tensor& data() noexcept {
+        return data_;
+    }
+
+    /**
+     * \brief Contiguous view of the item \a i sharing storage with the list.
+     *
+     * \throw std::out_of_range if \a i is out of bounds.
+     */
+    Tensor item(size_t i) const;
+
+    /**
+     * \brief Views of all items.
+     */
+    std::vector<Tensor> unpack() const;
+
+    /**
+     * \brief Copies items into a dense tensor of shape
+     * [size(), max extent of dimension 0, ..., max extent of the last
+     * dimension]. Each item is placed at the beginning of its slice, the rest
+     * of the slice is filled with \a padding_value. Items are copied in
+     * parallel.
+     */
+    Tensor toPadded(double padding_value = 0.0) const;
+
+    /**
+     * \brief True if both lists have the same number of items with the same
+     * shapes.
+     */
+    bool hasSameLayout(const PackedTensorList& that) const noexcept;
+
+private:
+    struct Layout {
+        int64_t item_dims{0};
+        /// Extents of all items, item_dims values per item
+        std::vector<int64_t> shapes;
+        /// Element offsets of the items followed by the total number of elements
+        std::vector<int64_t> offsets;
+    };
+
+    PackedTensorList(std::shared_ptr<const Layout> layout, Tensor data);
+
+    static std::shared_ptr<const Layout>
+    makeLayout(const std::vector<std::vector<int64_t>>& shapes);
+
+    friend PackedTensorList emptyLike(const PackedTensorList& list, TensorDataType dtype);
+
+    std::shared_ptr<const Layout> layout_;
+    Tensor data_;
+};
+
+/**
+ * \brief Allocates uninitialized list sharing layout with \a list.
+ */
+PackedTensorList emptyLike(const PackedTensorList& list, TensorDataType dtype);
+
+enum class PackedBinaryOp { Add, Subtract, Multiply, Maximum, Minimum };
+
+enum class PackedReduction { Sum, Mean, Max, Min };
+
+/**
+ * \brief Applies \a op to the corresponding elements of the lists with the
+ * same layout in a single parallel pass over the packed data. Integer
+ * arithmetic wraps around on overflow.
+ *
+ * \return List sharing layout with the operands.
+ *
+ * \throw std::length_error if layouts of the lists are different.
+ * \throw TypesMismatchError if data types are different or not arithmetic.
+ */
+PackedTensorList
+apply(PackedBinaryOp op, const PackedTensorList& lhs, const PackedTensorList& rhs);
+
+/**
+ * \brief Applies \a op to every element of \a lhs and \a rhs scalar.
+ *
+ * \throw std::out_of_range if \a rhs is not representable by \a lhs data type.
+ * \throw TypesMismatchError if \a lhs data type is not arithmetic.
+ */
+PackedTensorList apply(PackedBinaryOp op, const PackedTensorList& lhs, double rhs);
+
+/**
+ * \brief Reduces every item of \a list to a single value.
+ *
+ * Packed data is split into blocks of the fixed size independent of the
+ * number of threads, blocks are reduced in parallel and partial results of
+ * items crossing block boundaries are merged in the block order. So long and
+ * short items are balanced equally well and results are reproducible.
+ *
+ * Sum of integers is computed in Int64 (UInt64 for unsigned types), mean of
+ * integers is Float64. Floating point values are accumulated in double. Max
+ * and min propagate NaNs, mean of an empty item is NaN.
+ *
+ * \return 1-D tensor with \a list.size() elements.
+ *
+ * \throw TypesMismatchError if data type is not arithmetic.
+ * \throw std::invalid_argument if max or min of an empty item is requested.
+ */
+Tensor reduce(PackedReduction reduction, const PackedTensorList& list);
+} // namespace nope
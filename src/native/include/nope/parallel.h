@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace nope {
+/**
+ * \brief Number of threads used by parallel kernels including the calling one.
+ *
+ * Defaults to the hardware concurrency.
+ */
+size_t getNumThreads() noexcept;
+
+/**
+ * \brief Changes number of threads used by parallel kernels.
+ *
+ * \param num_threads Total number of threads including the calling one.
+ *      0 resets it to the hardware concurrency.
+ */
+void setNumThreads(size_t num_threads);
+
+/**
+ * \brief Splits range [\a begin, \a end) into at most \a getNumThreads()
+ * contiguous chunks of the same size and executes \a fn for each of them.
+ *
+ * Partitioning is static: chunk with index \a i is always executed by the
+ * thread with index \a i (0 is the calling thread), so repeated calls with the
+ * same range and grain size touch the same memory from the same threads.
+ * Nested calls are executed sequentially by the calling thread.
+ *
+ * \param begin First index of the range.
+ * \param end Past the last index of the range.
+ * \param grain_size Minimal number of indices processed by a single chunk.
+ * \param fn Function invoked as \a fn(chunk_begin, chunk_end).
+ *
+ * \throw Rethrows the first exception thrown by \a fn.
+ */
+void parallelFor(int64_t begin,
+                 int64_t end,
+                 int64_t grain_size,
+                 const std::function<void(int64_t, int64_t)>& fn);
+
+/**
+ * \brief Number of chunks \a parallelFor splits the range of \a range_size
+ * indices into for the given \a grain_size.
+ */
+int64_t parallelChunksCount(int64_t range_size, int64_t grain_size) noexcept;
+} // namespace nope
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Affine mapping of Int8/UInt8 tensor values to real numbers:
+ * \code real = scale * (quantized - zero_point) \endcode
+ *
+ * Per tensor quantization has a single scale and zero point. Per axis
+ * quantization has a scale and zero point for each index along \a axis.
+ */
+struct QuantizationParams {
+    std::vector<float> scales;
+    std::vector<int32_t> zero_points;
+    /// Quantized axis, -1 for per tensor quantization
+    int64_t axis{-1};
+
+    static QuantizationParams perTensor(float scale, int32_t zero_point);
+
+    static QuantizationParams
+    perAxis(std::vector<float> scales, std::vector<int32_t> zero_points, int64_t axis);
+
+    bool isPerAxis() const noexcept {
+        return axis >= 0;
+    }
+
+    float scale(int64_t i) const noexcept {
+        return scales[isPerAxis() ? static_cast<size_t>(i) : 0];
+    }
+
+    int32_t zeroPoint(int64_t i) const noexcept {
+        return zero_points[isPerAxis() ? static_cast<size_t>(i) : 0];
+    }
+};
+
+bool operator==(const QuantizationParams& lhs, const QuantizationParams& rhs) noexcept;
+
+/**
+ * \brief Quantizes floating point \a src with rounding to the nearest (ties to
+ * even) and saturation to the range of \a dtype. NaNs are mapped to the
+ * lowest value.
+ *
+ * \param src Float32 or Float64 tensor.
+ * \param params Quantization parameters attached to the result.
+ * \param dtype Int8 or UInt8.
+ *
+ * \return Contiguous quantized tensor of the same shape as \a src.
+ *
+ * \throw TypesMismatchError if data types are not supported.
+ * \throw std::out_of_range, std::length_error, std::invalid_argument if
+ *      \a params are not valid for the result (see Tensor::setQuantization).
+ */
+Tensor
+quantize(const Tensor& src, const QuantizationParams& params, TensorDataType dtype);
+
+/**
+ * \brief Converts quantized tensor into Float32 one.
+ *
+ * \throw std::invalid_argument if \a src is not quantized.
+ */
+Tensor dequantize(const Tensor& src);
+
+/**
+ * \brief Adds real values of quantized tensors of the same shape and data
+ * type and requantizes the sum with \a out_params without intermediate
+ * floating point tensors.
+ *
+ * Scale ratios are converted into 16-bit fixed point multipliers, so the
+ * result differs from the exact one by at most 1. Per axis parameters of
+ * operands and the result should share the same axis.
+ *
+ * \return Tensor of the operands data type quantized with \a out_params.
+ *
+ * \throw std::invalid_argument if operands are not quantized, per axis
+ *      parameters have different axes or ratio of the operand and result
+ *      scales is not below 32768.
+ * \throw std::length_error if shapes are different.
+ * \throw TypesMismatchError if data types are different.
+ */
+Tensor quantizedAdd(const Tensor& lhs,
+                    const Tensor& rhs,
+                    const QuantizationParams& out_params);
+
+/**
+ * \brief Multiplies real values of quantized tensors and requantizes the
+ * product with \a out_params. Product of zero point adjusted values is exact,
+ * it is scaled in single precision and rounded to the nearest.
+ *
+ * \see quantizedAdd
+ */
+Tensor quantizedMul(const Tensor& lhs,
+                    const Tensor& rhs,
+                    const QuantizationParams& out_params);
+} // namespace nope
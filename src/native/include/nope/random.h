@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Fills \a out with values uniformly distributed in [low, high).
+ *
+ * Random bits come from the counter-based Philox4x32-10 generator keyed by
+ * \a seed: element with row-major index \a i is derived only from the
+ * generator block \a i / elements_per_block. Chunks of the tensor are
+ * generated independently in parallel and the result is bit-identical
+ * regardless of the number of threads.
+ *
+ * \param out Float32 or Float64 tensor, filled in place.
+ * \param low Lower bound of the values, inclusive.
+ * \param high Upper bound of the values, exclusive.
+ * \param seed Generator key.
+ *
+ * \throw TypesMismatchError if \a out data type is not floating point one.
+ */
+void fillUniform(Tensor& out, double low, double high, uint64_t seed);
+
+/**
+ * \brief Fills \a out with normally distributed values using Box-Muller
+ * transform of Philox4x32-10 output.
+ *
+ * \see fillUniform
+ *
+ * \param out Float32 or Float64 tensor, filled in place.
+ * \param mean Mean of the distribution.
+ * \param stddev Standard deviation of the distribution.
+ * \param seed Generator key.
+ *
+ * \throw TypesMismatchError if \a out data type is not floating point one.
+ */
+void fillNormal(Tensor& out, double mean, double stddev, uint64_t seed);
+
+/**
+ * \brief Fills \a out with integers uniformly distributed in [low, high).
+ *
+ * Rare words which would bias the mapping into the range are rejected and
+ * redrawn from a stream keyed by the element index, so the result still does
+ * not depend on the number of threads.
+ *
+ * \see fillUniform
+ *
+ * \param out Tensor of any integer data type, filled in place.
+ * \param low Lower bound of the values, inclusive.
+ * \param high Upper bound of the values, exclusive.
+ * \param seed Generator key.
+ *
+ * \throw TypesMismatchError if \a out data type is not integer one.
+ * \throw std::out_of_range if range is empty or not representable by \a out
+ *      data type.
+ */
+void fillRandInt(Tensor& out, int64_t low, int64_t high, uint64_t seed);
+} // namespace nope
@@ -1,9 +1,39 @@
 #pragma once
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace nope {
+namespace detail {
+/**
+ * \brief Coalesces adjacent dimensions of \a n_operands operands sharing the
+ * same \a shape, but having own strides. Dimensions are coalesced only if they
+ * refer to the contiguous block of memory for all operands at once. Dimensions
+ * equal to 1 are dropped.
+ *
+ * \param shape Common shape, updated in place.
+ * \param strides Array of \a n_operands pointers to the operands strides,
+ *      updated in place.
+ * \param n_operands Number of operands.
+ * \param dims Number of dimensions in \a shape and each of \a strides.
+ *
+ * \return Number of dimensions after coalescing. 0 only if \a dims is 0.
+ */
+int64_t coalesceDimensions(int64_t* shape,
+                           int64_t* const* strides,
+                           int64_t n_operands,
+                           int64_t dims) noexcept;
+
+/**
+ * \brief Byte range [lowest, highest) referred by the strided layout relative
+ * to its first element. Layouts without elements refer to the empty [0, 0).
+ */
+std::pair<int64_t, int64_t> stridedExtent(const std::vector<int64_t>& shape,
+                                          const std::vector<int64_t>& strides,
+                                          int64_t element_size) noexcept;
+} // namespace detail
+
 /**
  * \brief Calculates effective \a shape and \a strides trying to reduce number
  * of dimensions and increase continuous memory blocks.
@@ -26,4 +56,14 @@ void fillContiguousStrides(const int64_t* shape,
                            int64_t* strides,
                            int64_t dims,
                            int64_t element_size);
+
+/**
+ * \brief Converts possibly negative \a axis into the index of dimension.
+ *
+ * \param axis Axis index, negative values are counted from the last dimension.
+ * \param dims Number of dimensions.
+ *
+ * \throw std::out_of_range if \a axis is out of [-dims, dims) range.
+ */
+int64_t normalizeAxis(int64_t axis, int64_t dims);
 } // namespace nope
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Allocates contiguous tensor in a shared memory segment.
+ *
+ * Segment is an anonymous file (memfd_create on Linux, unlinked POSIX shared
+ * memory object on other platforms) mapped into the process. Other processes
+ * receiving the segment file descriptor map the same pages, so passing the
+ * tensor between processes doesn't copy its data.
+ *
+ * \throw std::system_error if segment can't be created or mapped.
+ */
+Tensor emptyShared(std::vector<int64_t> shape,
+                   TensorDataType dtype = TensorDataType::Float32);
+
+/**
+ * \brief Returns \a tensor if its storage is already a shared memory segment,
+ * otherwise its contiguous copy allocated with emptyShared. Quantization
+ * parameters are kept.
+ */
+Tensor toSharedMemory(const Tensor& tensor);
+
+bool isSharedMemory(const Tensor& tensor) noexcept;
+
+/**
+ * \brief File descriptor of the shared memory segment backing \a tensor
+ * storage. Descriptor is owned by the storage and closed with it.
+ *
+ * \throw std::invalid_argument if tensor storage is not a shared segment.
+ */
+int sharedMemoryFd(const Tensor& tensor);
+
+/**
+ * \brief Maps the shared memory segment referred by \a fd and creates a view
+ * of it.
+ *
+ * \param fd Segment file descriptor, ownership is transferred to the tensor
+ *      storage even if the function throws.
+ * \param storage_size Size of the segment in bytes.
+ * \param shape Shape of the view.
+ * \param strides Byte strides of the view.
+ * \param storage_offset Offset of the first view element in bytes.
+ * \param dtype Data type of the elements.
+ *
+ * \throw std::system_error if segment can't be mapped.
+ * \throw std::out_of_range if the view exceeds the segment.
+ */
+Tensor fromSharedMemory(int fd,
+                        size_t storage_size,
+                        std::vector<int64_t> shape,
+                        std::vector<int64_t> strides,
+                        int64_t storage_offset,
+                        TensorDataType dtype);
+} // namespace nope
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Sorts elements of \a src along \a axis.
+ *
+ * Each row along \a axis is gathered into a thread-local buffer, so axes with
+ * arbitrary strides are sorted without transposing the whole tensor. Rows are
+ * processed in parallel. Integer and floating point keys are sorted with LSD
+ * radix sort, floating point values are bit-flipped into unsigned keys
+ * preserving their order. NaNs are treated as the largest values. Sorted
+ * values are a permutation of the source ones, so signs of zeros and NaN
+ * payloads are kept.
+ *
+ * \param src Tensor of any arithmetic data type.
+ * \param axis Axis to sort along, might be negative.
+ * \param descending Sort in descending order if true.
+ *
+ * \return Contiguous tensor of the same shape and data type as \a src.
+ *
+ * \throw TypesMismatchError if \a src data type is not arithmetic.
+ * \throw std::out_of_range if \a axis is out of bounds.
+ */
+Tensor sort(const Tensor& src, int64_t axis = -1, bool descending = false);
+
+/**
+ * \brief Returns Int64 indices that sort \a src along \a axis. Sorting is
+ * stable: equal elements keep their relative order.
+ *
+ * \see sort
+ */
+Tensor argsort(const Tensor& src, int64_t axis = -1, bool descending = false);
+
+/**
+ * \brief Selects \a k largest (or smallest) elements of \a src along \a axis.
+ *
+ * Small \a k relative to the axis extent is served by a bounded heap in a
+ * single pass over each row, otherwise the row is radix sorted. Selected
+ * elements are ordered from the best to the worst, ties are resolved in favor
+ * of the smaller index.
+ *
+ * \param src Tensor of any arithmetic data type.
+ * \param k Number of elements to select, can't exceed extent of \a axis.
+ * \param axis Axis to select along, might be negative.
+ * \param largest Select the largest elements if true, the smallest otherwise.
+ *
+ * \return Pair of values (\a src data type) and Int64 indices tensors with
+ *      \a k elements along \a axis.
+ *
+ * \throw std::out_of_range if \a k or \a axis is out of bounds.
+ */
+std::pair<Tensor, Tensor>
+topk(const Tensor& src, int64_t k, int64_t axis = -1, bool largest = true);
+} // namespace nope
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nope/tensor.h"
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Copies elements of the N-dimensional strided region into another one
+ * of the same shape. Dimensions are coalesced before copying, so rows of
+ * contiguous memory are copied as a whole.
+ *
+ * \param shape Shape of the copied region.
+ * \param dims Number of dimensions in \a shape.
+ * \param src Pointer to the first source element.
+ * \param src_strides Source byte strides.
+ * \param dst Pointer to the first destination element.
+ * \param dst_strides Destination byte strides.
+ * \param element_size Size of the element in bytes.
+ */
+void copyStrided(const int64_t* shape,
+                 int64_t dims,
+                 const std::byte* src,
+                 const int64_t* src_strides,
+                 std::byte* dst,
+                 const int64_t* dst_strides,
+                 int64_t element_size);
+} // namespace detail
+
+/**
+ * \brief Copies elements of \a src into \a dst.
+ *
+ * \param src Source tensor.
+ * \param dst Destination tensor with the same shape and data type as \a src,
+ *      strides might be arbitrary.
+ *
+ * \throw TypesMismatchError if data types are different.
+ * \throw std::length_error if shapes are different.
+ */
+void copyStrided(const Tensor& src, Tensor& dst);
+} // namespace nope
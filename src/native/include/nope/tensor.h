@@ -1,16 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <iosfwd>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 #include <vector>
-#include <iosfwd>
 
 #include "nope/tensor_data_type.h"
 
 namespace nope {
 namespace detail {
 void freeNothing(std::byte* bytes);
-}
+
+struct MemoryCounters;
+} // namespace detail
+
+struct QuantizationParams;
 
 class TypesMismatchError final : public std::runtime_error {
 public:
@@ -21,14 +29,38 @@ class Tensor {
 public:
     using BytesFree = void (*)(std::byte*);
 
+    /**
+     * \brief Base of objects kept alive by the storage of external data until
+     * the data is released, e.g. the Python object exporting the data.
+     */
+    class DataOwner {
+    public:
+        virtual ~DataOwner() = default;
+    };
+
     explicit Tensor(std::vector<int64_t> shape,
                     TensorDataType dtype = TensorDataType::Float32);
 
+    /**
+     * \brief Creates tensor referring external data without copying it.
+     *
+     * Storage starts at the lowest address reached by the layout, so data of
+     * tensors with negative strides precedes \a bytes and the storage offset
+     * is not zero.
+     *
+     * \param bytes Address of the first element.
+     * \param bytes_free Releases the data, receives the storage beginning.
+     * \param owner Object destroyed together with the storage after
+     *      \a bytes_free is called.
+     *
+     * \throw std::length_error if \a shape and \a strides have different lengths.
+     */
     Tensor(std::byte* bytes,
            std::vector<int64_t> shape,
            std::vector<int64_t> strides,
            TensorDataType dtype,
-           BytesFree bytes_free = &detail::freeNothing);
+           BytesFree bytes_free = &detail::freeNothing,
+           std::unique_ptr<DataOwner> owner = nullptr);
 
     Tensor(const Tensor& /* that */) = default;
 
@@ -64,28 +96,120 @@ public:
         return shape_[i];
     }
 
+    /**
+     * \brief Total number of elements referred by the tensor.
+     */
+    int64_t numel() const noexcept;
+
+    bool isContiguous() const noexcept;
+
+    /**
+     * \brief Returns the tensor itself if it is contiguous, otherwise its
+     * contiguous copy.
+     */
+    Tensor contiguous() const;
+
+    /**
+     * \brief Creates a view sharing storage with this tensor. Per tensor
+     * quantization parameters are kept, per axis ones are dropped.
+     *
+     * \param shape Shape of the view.
+     * \param strides Byte strides of the view.
+     * \param storage_offset Offset of the first view element from the storage
+     *      beginning in bytes.
+     *
+     * \throw std::length_error if \a shape and \a strides have different lengths.
+     * \throw std::out_of_range if the view refers to bytes outside of the storage.
+     */
+    Tensor asStrided(std::vector<int64_t> shape,
+                     std::vector<int64_t> strides,
+                     int64_t storage_offset) const;
+
+    // SECTION: Quantization
+    /**
+     * \brief Quantization parameters of Int8/UInt8 tensor, nullptr if the tensor
+     * is not quantized.
+     */
+    const QuantizationParams* quantization() const noexcept {
+        return quantization_.get();
+    }
+
+    bool isQuantized() const noexcept {
+        return quantization_ != nullptr;
+    }
+
+    /**
+     * \brief Attaches quantization parameters to the tensor. Parameters are
+     * shared by copies of the tensor.
+     *
+     * \throw TypesMismatchError if data type is not Int8 or UInt8.
+     * \throw std::out_of_range if axis or zero points are out of range.
+     * \throw std::length_error if number of scales and zero points is not 1
+     *      for per tensor parameters or not equal to the axis extent.
+     * \throw std::invalid_argument if some scale is not positive finite number.
+     */
+    void setQuantization(const QuantizationParams& params);
+
+    void clearQuantization() noexcept {
+        quantization_.reset();
+    }
+
+    // SECTION: Storage access
+    /**
+     * \brief Offset of the first element from the storage beginning in bytes.
+     */
+    int64_t storageOffset() const noexcept {
+        return storage_offset_;
+    }
+
+    std::byte* storageData() noexcept {
+        return storage_->data;
+    }
+
+    const std::byte* storageData() const noexcept {
+        return storage_->data;
+    }
+
+    size_t storageSize() const noexcept {
+        return storage_->size;
+    }
+
+    /**
+     * \brief Function releasing external storage data, nullptr if storage
+     * owns its data.
+     */
+    BytesFree storageBytesFree() const noexcept {
+        return storage_->bytes_free;
+    }
+
     // SECTION: Data pointer access
+    /**
+     * \brief Pointer to the first element of the tensor.
+     *
+     * Storage offset (in bytes) is already applied, so views sharing the same
+     * storage refer to their own first element.
+     */
     std::byte* data() noexcept {
-        return storage_->data.get();
+        return storage_->data + storage_offset_;
     }
 
     const std::byte* data() const noexcept {
-        return storage_->data.get();
+        return storage_->data + storage_offset_;
     }
 
     template <class T>
     T* unsafeData() noexcept {
-        return static_cast<T*>(data()) + storage_offset_;
+        return reinterpret_cast<T*>(data());
     }
 
     template <class T>
     const T* unsafeData() const noexcept {
-        return static_cast<const T*>(data()) + storage_offset_;
+        return reinterpret_cast<const T*>(data());
     }
 
     template <class T>
     T* safeData() {
-        if (dtype_ != TensorDataType::of<T>) {
+        if (dtype_ != TensorDataType::of<T>()) {
             throw TypesMismatchError("Trying to reinterpret tensor data as wrong type");
         }
         return unsafeData<T>();
@@ -94,35 +218,119 @@ public:
 
     template <class T>
     const T* safeData() const {
-        if (dtype_ != TensorDataType::of<T>) {
+        if (dtype_ != TensorDataType::of<T>()) {
             throw TypesMismatchError("Trying to reinterpret tensor data as wrong type");
         }
         return unsafeData<T>();
     }
 
 private:
+    class StoragePtr;
+
+    /**
+     * \brief Intrusively reference counted memory block shared by tensors.
+     *
+     * Owned data is placed right after the header in the same allocation, so
+     * creating a tensor costs a single allocator call. Large blocks are mapped
+     * from the OS according to the AllocationPolicy. External data is referred
+     * by pointer and released with \a bytes_free.
+     */
     struct Storage {
-        using DataPtr = std::unique_ptr<std::byte, BytesFree>;
-        DataPtr data;
-        size_t size;
+        /// Alignment of the header and co-located data
+        static constexpr size_t kAlignment = 64;
+
+        std::atomic<int64_t> ref_count{1};
+        std::byte* data{nullptr};
+        size_t size{0};
+        /// nullptr if data is co-located with the header
+        BytesFree bytes_free{nullptr};
+        /// Size of the memory mapping holding the header and data, 0 if the
+        /// block is allocated from the heap
+        size_t mapped_size{0};
+        /// Memory accounting of the tag active at allocation, nullptr if untagged
+        detail::MemoryCounters* tag_counters{nullptr};
+        /// Memory debug mode record, 0 if not recorded
+        uint64_t debug_id{0};
+        /// Keeps external data alive, nullptr if data is owned or has no owner
+        std::unique_ptr<DataOwner> owner;
+
+        static StoragePtr allocateContiguous(const std::vector<int64_t>& shape,
+                                             int64_t element_size);
+
+        static StoragePtr fromBytes(std::byte* bytes,
+                                    size_t bytes_size,
+                                    BytesFree bytes_free,
+                                    std::unique_ptr<DataOwner> owner);
+
+        static void destroy(Storage* storage) noexcept;
+
+        /// Registers storage in memory accounting, destroy() unregisters it
+        void account() noexcept;
 
-        Storage(DataPtr bytes, size_t data_size)
-            : data{std::move(bytes)}, size{data_size} {
+        /// Size of the header rounded up to keep co-located data aligned
+        static constexpr size_t headerSize() noexcept;
+    };
+
+    /**
+     * \brief Owning handle to the \a Storage. Adopts reference passed to the
+     * constructor.
+     */
+    class StoragePtr {
+    public:
+        StoragePtr() = default;
+
+        explicit StoragePtr(Storage* storage) noexcept : storage_{storage} {
         }
 
-        static std::shared_ptr<Storage>
-        allocateContiguous(const std::vector<int64_t>& shape, int64_t element_size);
+        StoragePtr(const StoragePtr& that) noexcept : storage_{that.storage_} {
+            if (storage_ != nullptr) {
+                storage_->ref_count.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        StoragePtr& operator=(const StoragePtr& that) noexcept {
+            StoragePtr(that).swap(*this);
+            return *this;
+        }
+
+        StoragePtr(StoragePtr&& that) noexcept
+            : storage_{std::exchange(that.storage_, nullptr)} {
+        }
+
+        StoragePtr& operator=(StoragePtr&& that) noexcept {
+            StoragePtr(std::move(that)).swap(*this);
+            return *this;
+        }
+
+        ~StoragePtr() {
+            if (storage_ != nullptr
+                && storage_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Storage::destroy(storage_);
+            }
+        }
+
+        void swap(StoragePtr& that) noexcept {
+            std::swap(storage_, that.storage_);
+        }
+
+        Storage* operator->() const noexcept {
+            return storage_;
+        }
+
+        Storage* get() const noexcept {
+            return storage_;
+        }
 
-        static std::shared_ptr<Storage> fromBytes(std::byte* bytes,
-                                                  size_t bytes_size,
-                                                  BytesFree bytes_free);
+    private:
+        Storage* storage_{nullptr};
     };
 
-    std::shared_ptr<Storage> storage_;
+    StoragePtr storage_;
     std::vector<int64_t> shape_;
     std::vector<int64_t> strides_;
     int64_t storage_offset_{0};
     TensorDataType dtype_;
+    std::shared_ptr<const QuantizationParams> quantization_;
 };
 
 std::ostream& operator<<(std::ostream& stream, const Tensor& tensor);
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
 #include <string>
 
 namespace nope {
@@ -17,13 +21,16 @@ public:
         Int64 = 6,
         UInt64 = 7,
         Float32 = 8,
-        Float64 = 9
+        Float64 = 9,
+        Bool = 10
     };
 
-    TensorDataType() = default;
+    static constexpr size_t kTypesCount = 11;
+
+    constexpr TensorDataType() = default;
 
     // NOLINTNEXTLINE(google-explicit-constructor)
-    TensorDataType(TypeId type_id) : type_id_{type_id} {
+    constexpr TensorDataType(TypeId type_id) : type_id_{type_id} {
     }
 
     template <class T>
@@ -37,16 +44,41 @@ public:
         return typeIdOf<T>();
     }
 
-    [[nodiscard]] uint8_t typeId() const noexcept {
+    [[nodiscard]] constexpr uint8_t typeId() const noexcept {
         return type_id_;
     }
 
-    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] constexpr size_t size() const noexcept;
 
     [[nodiscard]] int64_t ssize() const noexcept {
         return static_cast<int64_t>(size());
     }
 
+    /**
+     * \brief Checks whenever data type refers to signed or unsigned integer.
+     * Bool is not treated as integer type.
+     */
+    [[nodiscard]] bool isInteger() const noexcept {
+        return type_id_ <= TypeId::UInt64;
+    }
+
+    [[nodiscard]] bool isFloatingPoint() const noexcept {
+        return type_id_ == TypeId::Float32 || type_id_ == TypeId::Float64;
+    }
+
+    /**
+     * \brief Buffer protocol (Python struct module) format code of the type.
+     */
+    [[nodiscard]] constexpr char formatCode() const noexcept;
+
+    /**
+     * \brief Looks up data type by buffer protocol format code. Native 'l'/'L'
+     * codes are resolved according to the platform size of long.
+     *
+     * \return Data type or std::nullopt if format code is unknown.
+     */
+    [[nodiscard]] static std::optional<TensorDataType> fromFormatCode(char code) noexcept;
+
 private:
     TypeId type_id_{TypeId::Float32};
 };
@@ -59,6 +91,144 @@ inline bool operator!=(const TensorDataType& lhs, const TensorDataType& rhs) noe
     return !(lhs == rhs);
 }
 
+namespace detail {
+enum class TypeKind : uint8_t { Bool, Signed, Unsigned, Float };
+
+/**
+ * \brief Static properties of a data type. \a promotion row holds the result
+ * of promoting this type with every other type.
+ */
+struct TypeInfo {
+    size_t size;
+    char format;
+    const char* name;
+    TypeKind kind;
+    std::array<TensorDataType::TypeId, TensorDataType::kTypesCount> promotion;
+};
+
+using TypeInfoTable = std::array<TypeInfo, TensorDataType::kTypesCount>;
+
+constexpr TensorDataType::TypeId findTypeId(const TypeInfoTable& infos,
+                                            TypeKind kind,
+                                            size_t size) noexcept {
+    for (size_t i = 0; i < infos.size(); ++i) {
+        if (infos[i].kind == kind && infos[i].size == size) {
+            return static_cast<TensorDataType::TypeId>(i);
+        }
+    }
+    return TensorDataType::Float64;
+}
+
+/**
+ * \brief NumPy type promotion rules: the smallest type able to represent all
+ * values of both types, mixing 64-bit signed and unsigned integers gives
+ * Float64.
+ */
+constexpr TensorDataType::TypeId promoteTypeIds(const TypeInfoTable& infos,
+                                                TensorDataType::TypeId lhs,
+                                                TensorDataType::TypeId rhs) noexcept {
+    const TypeInfo& l = infos[lhs];
+    const TypeInfo& r = infos[rhs];
+    if (lhs == rhs || r.kind == TypeKind::Bool) {
+        return lhs;
+    }
+    if (l.kind == TypeKind::Bool) {
+        return rhs;
+    }
+    if (l.kind == TypeKind::Float || r.kind == TypeKind::Float) {
+        // Integers up to 16 bits are exactly representable by Float32
+        const size_t float_size = std::max(l.kind == TypeKind::Float ? l.size
+                                           : l.size <= 2             ? 4
+                                                                     : 8,
+                                           r.kind == TypeKind::Float ? r.size
+                                           : r.size <= 2             ? 4
+                                                                     : 8);
+        return findTypeId(infos, TypeKind::Float, float_size);
+    }
+    if (l.kind == r.kind) {
+        return l.size >= r.size ? lhs : rhs;
+    }
+    const TypeInfo& signed_info = l.kind == TypeKind::Signed ? l : r;
+    const TypeInfo& unsigned_info = l.kind == TypeKind::Signed ? r : l;
+    if (signed_info.size > unsigned_info.size) {
+        return findTypeId(infos, TypeKind::Signed, signed_info.size);
+    }
+    if (unsigned_info.size < 8) {
+        return findTypeId(infos, TypeKind::Signed, 2 * unsigned_info.size);
+    }
+    return TensorDataType::Float64;
+}
+
+/**
+ * \brief Registry of data type properties indexed by TypeId.
+ */
+constexpr TypeInfoTable kTypeInfos = [] {
+    TypeInfoTable infos{{
+        {1, 'b', "Int8", TypeKind::Signed, {}},
+        {1, 'B', "UInt8", TypeKind::Unsigned, {}},
+        {2, 'h', "Int16", TypeKind::Signed, {}},
+        {2, 'H', "UInt16", TypeKind::Unsigned, {}},
+        {4, 'i', "Int32", TypeKind::Signed, {}},
+        {4, 'I', "UInt32", TypeKind::Unsigned, {}},
+        {8, 'q', "Int64", TypeKind::Signed, {}},
+        {8, 'Q', "UInt64", TypeKind::Unsigned, {}},
+        {4, 'f', "Float32", TypeKind::Float, {}},
+        {8, 'd', "Float64", TypeKind::Float, {}},
+        {1, '?', "Bool", TypeKind::Bool, {}},
+    }};
+    for (size_t lhs = 0; lhs < infos.size(); ++lhs) {
+        for (size_t rhs = 0; rhs < infos.size(); ++rhs) {
+            infos[lhs].promotion[rhs] = promoteTypeIds(
+                infos,
+                static_cast<TensorDataType::TypeId>(lhs),
+                static_cast<TensorDataType::TypeId>(rhs));
+        }
+    }
+    return infos;
+}();
+
+/**
+ * \brief Maps ASCII buffer format codes to TypeId, kTypesCount marks unknown codes.
+ */
+constexpr std::array<uint8_t, 128> kFormatCodeToTypeId = [] {
+    std::array<uint8_t, 128> type_ids{};
+    for (auto& type_id : type_ids) {
+        type_id = TensorDataType::kTypesCount;
+    }
+    for (size_t i = 0; i < kTypeInfos.size(); ++i) {
+        type_ids[static_cast<size_t>(kTypeInfos[i].format)] = static_cast<uint8_t>(i);
+    }
+    type_ids['l'] = sizeof(long) == 8 ? TensorDataType::Int64 : TensorDataType::Int32;
+    type_ids['L'] = sizeof(long) == 8 ? TensorDataType::UInt64 : TensorDataType::UInt32;
+    return type_ids;
+}();
+} // namespace detail
+
+constexpr size_t TensorDataType::size() const noexcept {
+    return type_id_ < kTypesCount ? detail::kTypeInfos[type_id_].size : 0;
+}
+
+constexpr char TensorDataType::formatCode() const noexcept {
+    return type_id_ < kTypesCount ? detail::kTypeInfos[type_id_].format : '\0';
+}
+
+inline std::optional<TensorDataType> TensorDataType::fromFormatCode(char code) noexcept {
+    const auto index = static_cast<unsigned char>(code);
+    if (index >= detail::kFormatCodeToTypeId.size()
+        || detail::kFormatCodeToTypeId[index] == kTypesCount) {
+        return std::nullopt;
+    }
+    return TensorDataType(static_cast<TypeId>(detail::kFormatCodeToTypeId[index]));
+}
+
+/**
+ * \brief Returns the data type both \a lhs and \a rhs are promoted to in
+ * binary operations.
+ */
+inline TensorDataType promoteTypes(TensorDataType lhs, TensorDataType rhs) noexcept {
+    return detail::kTypeInfos[lhs.typeId()].promotion[rhs.typeId()];
+}
+
 std::ostream& operator<<(std::ostream& stream, const TensorDataType& dtype);
 
 std::string to_string(const TensorDataType& dtype);
@@ -85,6 +255,7 @@ REGISTER_TENSOR_DATA_TYPE(int64_t, Int64)
 REGISTER_TENSOR_DATA_TYPE(uint64_t, UInt64)
 REGISTER_TENSOR_DATA_TYPE(float, Float32)
 REGISTER_TENSOR_DATA_TYPE(double, Float64)
+REGISTER_TENSOR_DATA_TYPE(bool, Bool)
 
 #undef REGISTER_TENSOR_DATA_TYPE
 } // namespace nope
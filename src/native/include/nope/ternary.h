@@ -0,0 +1,72 @@
+#pragma once
+
+#include <optional>
+
+#include "nope/tensor.h"
+
+namespace nope {
+/**
+ * \brief Selects elements of \a a where \a mask is non-zero and elements of
+ * \a b otherwise, operands are broadcasted to a common shape.
+ *
+ * Elements are selected as raw bits with SIMD blends, so any data type is
+ * supported. Runs with a single value of \a a or \a b (scalar or column
+ * operands) keep the value in a register.
+ *
+ * \param mask Bool or UInt8 tensor.
+ * \param a Values selected by non-zero \a mask.
+ * \param b Values selected by zero \a mask, the same data type as \a a.
+ *
+ * \return Contiguous tensor of the broadcasted shape and \a a data type.
+ *
+ * \throw TypesMismatchError if \a mask is not Bool or UInt8 or data types of
+ *      \a a and \a b are different.
+ * \throw std::length_error if shapes are not broadcastable.
+ */
+Tensor where(const Tensor& mask, const Tensor& a, const Tensor& b);
+
+/**
+ * \brief Writes elements selected from \a a and \a b by \a mask broadcasted
+ * to the shape of \a out into \a out.
+ *
+ * \a out might be one of the operands for in-place evaluation, other kinds of
+ * memory overlap produce unspecified results.
+ *
+ * \throw TypesMismatchError if \a mask is not Bool or UInt8 or data types of
+ *      \a a, \a b and \a out are different.
+ * \throw std::length_error if operands are not broadcastable to \a out shape.
+ */
+void where(const Tensor& mask, const Tensor& a, const Tensor& b, Tensor& out);
+
+/**
+ * \brief Limits elements of \a x to [\a lo, \a hi], operands are broadcasted to
+ * a common shape. Equivalent of \code min(max(x, lo), hi) \endcode, so \a hi
+ * wins when \a lo > \a hi. NaNs of \a x and of the bounds are propagated, the
+ * same as by np.clip.
+ *
+ * \param x Tensor of any arithmetic data type.
+ * \param lo Lower bounds, not applied if empty.
+ * \param hi Upper bounds, not applied if empty.
+ *
+ * \return Contiguous tensor of the broadcasted shape and \a x data type.
+ *
+ * \throw std::invalid_argument if both bounds are empty.
+ * \throw TypesMismatchError if data types are different or not arithmetic.
+ * \throw std::length_error if shapes are not broadcastable.
+ */
+Tensor
+clip(const Tensor& x, const std::optional<Tensor>& lo, const std::optional<Tensor>& hi);
+
+/**
+ * \brief Writes elements of \a x limited to [\a lo, \a hi] broadcasted to the
+ * shape of \a out into \a out, \a out might be \a x for in-place evaluation.
+ *
+ * \throw std::invalid_argument if both bounds are empty.
+ * \throw TypesMismatchError if data types are different or not arithmetic.
+ * \throw std::length_error if operands are not broadcastable to \a out shape.
+ */
+void clip(const Tensor& x,
+          const std::optional<Tensor>& lo,
+          const std::optional<Tensor>& hi,
+          Tensor& out);
+} // namespace nope
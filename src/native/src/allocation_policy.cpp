@@ -0,0 +1,161 @@
+#include "nope/allocation_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "mapped_memory.h"
+#include "nope/parallel.h"
+
+#if defined(__linux__)
+    #define NOPE_HAS_MMAP 1
+    #include <sys/mman.h>
+#else
+    #define NOPE_HAS_MMAP 0
+#endif
+
+// Defined by the build system if libnuma is found
+#ifndef NOPE_WITH_NUMA
+    #define NOPE_WITH_NUMA 0
+#endif
+
+#if NOPE_WITH_NUMA
+    #include <numa.h>
+#endif
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr size_t kPageSize = 4096;
+constexpr size_t kHugePageSize = size_t{2} << 20;
+constexpr int64_t kFirstTouchGrainPages = 256;
+
+std::mutex policy_mutex;
+AllocationPolicy policy;
+std::atomic<size_t> huge_pages_threshold{AllocationPolicy{}.huge_pages_threshold};
+
+size_t roundUp(size_t value, size_t alignment) noexcept {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#if NOPE_WITH_NUMA
+bool numaAvailable() noexcept {
+    static const bool available = numa_available() >= 0
+                                  && numa_num_configured_nodes() > 1;
+    return available;
+}
+#endif
+
+void applyNumaPlacement(void* ptr, size_t size, const AllocationPolicy& current) {
+#if NOPE_WITH_NUMA
+    if (!numaAvailable()) {
+        return;
+    }
+    switch (current.numa_placement) {
+        case NumaPlacement::Interleave:
+            numa_interleave_memory(ptr, size, numa_all_nodes_ptr);
+            break;
+        case NumaPlacement::Bind:
+            numa_tonode_memory(ptr, size, current.numa_node);
+            break;
+        case NumaPlacement::FirstTouch:
+            break;
+    }
+#else
+    static_cast<void>(ptr);
+    static_cast<void>(size);
+    static_cast<void>(current);
+#endif
+}
+
+/**
+ * \brief Writes a byte to each page, so the page is faulted in by the thread
+ * executing the same chunk of the range in parallel kernels.
+ */
+void touchPages(std::byte* ptr, size_t size) {
+    const auto n_pages = static_cast<int64_t>(roundUp(size, kPageSize) / kPageSize);
+    parallelFor(0, n_pages, kFirstTouchGrainPages, [ptr](int64_t begin, int64_t end) {
+        for (int64_t page = begin; page < end; ++page) {
+            ptr[static_cast<size_t>(page) * kPageSize] = std::byte{0};
+        }
+    });
+}
+} // namespace
+
+size_t hugePagesThreshold() noexcept {
+    return huge_pages_threshold.load(std::memory_order_relaxed);
+}
+
+MappedBlock mapLargeBlock(size_t size) {
+#if NOPE_HAS_MMAP
+    const AllocationPolicy current = getAllocationPolicy();
+    const size_t mapped_size = roundUp(size, kPageSize);
+    // Over-allocate to align the block to the huge page boundary, then give
+    // the unaligned head and the tail back
+    const size_t reserved_size = mapped_size + kHugePageSize;
+    void* reserved = mmap(nullptr,
+                          reserved_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1,
+                          0);
+    if (reserved == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    const auto reserved_addr = reinterpret_cast<uintptr_t>(reserved);
+    const uintptr_t addr = roundUp(reserved_addr, kHugePageSize);
+    const size_t head = addr - reserved_addr;
+    const size_t tail = reserved_size - head - mapped_size;
+    if (head != 0) {
+        munmap(reserved, head);
+    }
+    if (tail != 0) {
+        munmap(reinterpret_cast<void*>(addr + mapped_size), tail);
+    }
+    auto* ptr = reinterpret_cast<std::byte*>(addr);
+    #ifdef MADV_HUGEPAGE
+    // Advice is a hint, the block is still usable if it is rejected
+    static_cast<void>(madvise(ptr, mapped_size, MADV_HUGEPAGE));
+    #endif
+    applyNumaPlacement(ptr, mapped_size, current);
+    if (current.parallel_first_touch) {
+        touchPages(ptr, mapped_size);
+    }
+    return {ptr, mapped_size};
+#else
+    static_cast<void>(size);
+    return {};
+#endif
+}
+
+void unmapBlock(const MappedBlock& block) noexcept {
+#if NOPE_HAS_MMAP
+    munmap(block.ptr, block.size);
+#else
+    static_cast<void>(block);
+#endif
+}
+} // namespace detail
+
+AllocationPolicy getAllocationPolicy() {
+    std::lock_guard<std::mutex> lock(detail::policy_mutex);
+    return detail::policy;
+}
+
+void setAllocationPolicy(const AllocationPolicy& policy) {
+    std::lock_guard<std::mutex> lock(detail::policy_mutex);
+    detail::policy = policy;
+    detail::huge_pages_threshold.store(policy.huge_pages_threshold,
+                                       std::memory_order_relaxed);
+}
+
+bool isNumaAvailable() noexcept {
+#if NOPE_WITH_NUMA
+    return detail::numaAvailable();
+#else
+    return false;
+#endif
+}
+} // namespace nope
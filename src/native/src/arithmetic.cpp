@@ -0,0 +1,392 @@
+#include "nope/arithmetic.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu_features.h"
+#include "elementwise_loop.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "type_dispatch.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kBinaryGrainElements = 32 * 1024;
+/// Bytes of the row operand reused across rows, the block stays in L2 while
+/// the other operand and the output are streamed through
+constexpr int64_t kRowBlockBytes = 64 * 1024;
+
+std::atomic<bool> pattern_kernels_enabled{true};
+
+/**
+ * \brief Types used for the computation. Integers are computed in unsigned
+ * types of at least int width, so overflow wraps around instead of being
+ * undefined. \a Lane is the element type of vector registers.
+ */
+template <class T, bool = std::is_integral_v<T>>
+struct ArithmeticTraits {
+    using Lane = T;
+    using Wide = T;
+};
+
+template <class T>
+struct ArithmeticTraits<T, true> {
+    using Lane = std::make_unsigned_t<T>;
+    using Wide = std::common_type_t<Lane, unsigned>;
+};
+
+template <BinaryOp Op, class T>
+T applyScalar(T lhs, T rhs) noexcept {
+    using Wide = typename ArithmeticTraits<T>::Wide;
+    const auto a = static_cast<Wide>(lhs);
+    const auto b = static_cast<Wide>(rhs);
+    if constexpr (Op == BinaryOp::Add) {
+        return static_cast<T>(a + b);
+    } else if constexpr (Op == BinaryOp::Sub) {
+        return static_cast<T>(a - b);
+    } else if constexpr (Op == BinaryOp::Mul) {
+        return static_cast<T>(a * b);
+    } else {
+        static_assert(Op == BinaryOp::Div);
+        return static_cast<T>(a / b);
+    }
+}
+
+/**
+ * \brief Contiguous run kernel. Splatted operand points to a single value
+ * loaded once for the whole run.
+ */
+template <class T>
+using BinaryRunKernel = void (*)(const T* lhs, const T* rhs, T* out, int64_t n);
+
+template <class T, BinaryOp Op, bool kLhsSplat, bool kRhsSplat>
+void binaryRunScalar(const T* lhs, const T* rhs, T* out, int64_t n) noexcept {
+    if constexpr (kLhsSplat) {
+        const T a = *lhs;
+        for (int64_t i = 0; i < n; ++i) {
+            out[i] = applyScalar<Op>(a, rhs[i]);
+        }
+    } else if constexpr (kRhsSplat) {
+        const T b = *rhs;
+        for (int64_t i = 0; i < n; ++i) {
+            out[i] = applyScalar<Op>(lhs[i], b);
+        }
+    } else {
+        for (int64_t i = 0; i < n; ++i) {
+            out[i] = applyScalar<Op>(lhs[i], rhs[i]);
+        }
+    }
+}
+
+template <class T, BinaryOp Op>
+void binaryRunStrided(const std::array<std::byte*, 3>& data,
+                      const std::array<int64_t, 3>& strides,
+                      int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        const T a = *reinterpret_cast<const T*>(data[0] + i * strides[0]);
+        const T b = *reinterpret_cast<const T*>(data[1] + i * strides[1]);
+        *reinterpret_cast<T*>(data[2] + i * strides[2]) = applyScalar<Op>(a, b);
+    }
+}
+
+#if NOPE_X86_DISPATCH
+template <class T, BinaryOp Op, bool kLhsSplat, bool kRhsSplat>
+NOPE_TARGET_AVX2 void binaryRunAvx2(const T* lhs, const T* rhs, T* out, int64_t n) {
+    using Lane = typename ArithmeticTraits<T>::Lane;
+    using Vec = typename Avx2Vector<Lane>::type;
+    constexpr auto kLanes = static_cast<int64_t>(sizeof(Vec) / sizeof(T));
+    Vec a{};
+    Vec b{};
+    if constexpr (kLhsSplat) {
+        a += static_cast<Lane>(*lhs);
+    }
+    if constexpr (kRhsSplat) {
+        b += static_cast<Lane>(*rhs);
+    }
+    const int64_t vector_end = n - n % kLanes;
+    int64_t i = 0;
+    for (; i < vector_end; i += kLanes) {
+        if constexpr (!kLhsSplat) {
+            std::memcpy(&a, lhs + i, sizeof(Vec));
+        }
+        if constexpr (!kRhsSplat) {
+            std::memcpy(&b, rhs + i, sizeof(Vec));
+        }
+        Vec result;
+        if constexpr (Op == BinaryOp::Add) {
+            result = a + b;
+        } else if constexpr (Op == BinaryOp::Sub) {
+            result = a - b;
+        } else if constexpr (Op == BinaryOp::Mul) {
+            result = a * b;
+        } else {
+            static_assert(Op == BinaryOp::Div);
+            result = a / b;
+        }
+        std::memcpy(out + i, &result, sizeof(Vec));
+    }
+    binaryRunScalar<T, Op, kLhsSplat, kRhsSplat>(
+        kLhsSplat ? lhs : lhs + i, kRhsSplat ? rhs : rhs + i, out + i, n - i);
+}
+#endif
+
+template <class T>
+struct BinaryKernels {
+    BinaryRunKernel<T> contiguous;
+    BinaryRunKernel<T> lhs_splat;
+    BinaryRunKernel<T> rhs_splat;
+    void (*strided)(const std::array<std::byte*, 3>&,
+                    const std::array<int64_t, 3>&,
+                    int64_t) noexcept;
+};
+
+template <class T, BinaryOp Op>
+BinaryKernels<T> selectBinaryKernels() noexcept {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return {&binaryRunAvx2<T, Op, false, false>,
+                &binaryRunAvx2<T, Op, true, false>,
+                &binaryRunAvx2<T, Op, false, true>,
+                &binaryRunStrided<T, Op>};
+    }
+#endif
+    return {&binaryRunScalar<T, Op, false, false>,
+            &binaryRunScalar<T, Op, true, false>,
+            &binaryRunScalar<T, Op, false, true>,
+            &binaryRunStrided<T, Op>};
+}
+
+template <class T>
+BinaryKernels<T> selectBinaryKernels(BinaryOp op) {
+    switch (op) {
+        case BinaryOp::Add:
+            return selectBinaryKernels<T, BinaryOp::Add>();
+        case BinaryOp::Sub:
+            return selectBinaryKernels<T, BinaryOp::Sub>();
+        case BinaryOp::Mul:
+            return selectBinaryKernels<T, BinaryOp::Mul>();
+        case BinaryOp::Div:
+            if constexpr (std::is_floating_point_v<T>) {
+                return selectBinaryKernels<T, BinaryOp::Div>();
+            }
+            break;
+    }
+    throw std::invalid_argument("Unknown binary operation");
+}
+
+/**
+ * \brief Coalesced shape and strides of the operands (lhs, rhs, out) and the
+ * broadcast pattern they form.
+ */
+struct BinaryPlan {
+    BroadcastPattern pattern{BroadcastPattern::Generic};
+    std::vector<int64_t> shape;
+    std::array<std::vector<int64_t>, 3> strides;
+};
+
+BinaryPlan makeBinaryPlan(const Tensor& lhs, const Tensor& rhs, const Tensor& out) {
+    BinaryPlan plan;
+    plan.shape = out.shape();
+    plan.strides = {broadcastStrides(lhs, out.shape()),
+                    broadcastStrides(rhs, out.shape()),
+                    out.strides()};
+    if (!pattern_kernels_enabled.load(std::memory_order_relaxed) || plan.shape.empty()
+        || out.numel() == 0) {
+        return plan;
+    }
+    std::array<int64_t*, 3> strides_ptr{
+        plan.strides[0].data(), plan.strides[1].data(), plan.strides[2].data()};
+    const int64_t dims = coalesceDimensions(plan.shape.data(),
+                                            strides_ptr.data(),
+                                            3,
+                                            static_cast<int64_t>(plan.shape.size()));
+    plan.shape.resize(static_cast<size_t>(dims));
+    for (auto& strides : plan.strides) {
+        strides.resize(static_cast<size_t>(dims));
+    }
+
+    const auto item_size = static_cast<int64_t>(out.itemSize());
+    const auto inner = static_cast<size_t>(dims - 1);
+    const auto is_contiguous = [&](size_t k) {
+        return plan.strides[k][inner] == item_size;
+    };
+    if (!is_contiguous(2)) {
+        return plan;
+    }
+    for (size_t side = 0; side < 2; ++side) {
+        const bool is_lhs = side == 0;
+        if (!is_contiguous(1 - side)) {
+            continue;
+        }
+        if (plan.strides[side][inner] == 0) {
+            if (dims == 1) {
+                plan.pattern = is_lhs ? BroadcastPattern::ScalarLhs
+                                      : BroadcastPattern::ScalarRhs;
+            } else {
+                plan.pattern = is_lhs ? BroadcastPattern::ColumnLhs
+                                      : BroadcastPattern::ColumnRhs;
+            }
+            return plan;
+        }
+        if (dims == 2 && is_contiguous(side) && plan.strides[side][0] == 0) {
+            plan.pattern = is_lhs ? BroadcastPattern::RowLhs : BroadcastPattern::RowRhs;
+            return plan;
+        }
+    }
+    return plan;
+}
+
+/**
+ * \brief Rows of the 2-dimensional plan where one operand is the same row for
+ * all of them. Rows are processed in column blocks, so each thread reuses the
+ * block of the row operand from cache for consecutive rows.
+ */
+template <class T>
+void runRows(BinaryRunKernel<T> kernel,
+             const BinaryPlan& plan,
+             const std::array<std::byte*, 3>& data,
+             bool row_is_lhs) {
+    const int64_t rows = plan.shape[0];
+    const int64_t cols = plan.shape[1];
+    const size_t row_side = row_is_lhs ? 0 : 1;
+    const size_t other = 1 - row_side;
+    const int64_t other_stride = plan.strides[other][0];
+    const int64_t out_stride = plan.strides[2][0];
+    const int64_t block =
+        std::min(cols, kRowBlockBytes / static_cast<int64_t>(sizeof(T)));
+    const int64_t n_blocks = (cols + block - 1) / block;
+    const int64_t grain_size = std::max(int64_t{1}, kBinaryGrainElements / block);
+    // Index space is (column block, row) pairs, consecutive indices share the block
+    parallelFor(0, n_blocks * rows, grain_size, [&](int64_t begin, int64_t end) {
+        int64_t col = begin / rows * block;
+        int64_t row = begin % rows;
+        for (int64_t i = begin; i < end; ++i) {
+            const int64_t width = std::min(block, cols - col);
+            const auto* row_values = reinterpret_cast<const T*>(data[row_side]) + col;
+            const auto* other_values =
+                reinterpret_cast<const T*>(data[other] + row * other_stride) + col;
+            auto* out_values = reinterpret_cast<T*>(data[2] + row * out_stride) + col;
+            if (row_is_lhs) {
+                kernel(row_values, other_values, out_values, width);
+            } else {
+                kernel(other_values, row_values, out_values, width);
+            }
+            if (++row == rows) {
+                row = 0;
+                col += block;
+            }
+        }
+    });
+}
+
+template <class T>
+void runBinaryPlan(const BinaryKernels<T>& kernels,
+                   const BinaryPlan& plan,
+                   const Tensor& lhs,
+                   const Tensor& rhs,
+                   Tensor& out) {
+    constexpr auto kItemSize = static_cast<int64_t>(sizeof(T));
+    // Operands are only read, pointers of all operands share the same type
+    const std::array<std::byte*, 3> data{const_cast<std::byte*>(lhs.data()),
+                                         const_cast<std::byte*>(rhs.data()),
+                                         out.data()};
+    switch (plan.pattern) {
+        case BroadcastPattern::RowLhs:
+        case BroadcastPattern::RowRhs:
+            runRows<T>(kernels.contiguous,
+                       plan,
+                       data,
+                       plan.pattern == BroadcastPattern::RowLhs);
+            return;
+        case BroadcastPattern::ScalarLhs:
+        case BroadcastPattern::ColumnLhs:
+        case BroadcastPattern::ScalarRhs:
+        case BroadcastPattern::ColumnRhs: {
+            const bool splat_lhs = plan.pattern == BroadcastPattern::ScalarLhs
+                                   || plan.pattern == BroadcastPattern::ColumnLhs;
+            const BinaryRunKernel<T> kernel =
+                splat_lhs ? kernels.lhs_splat : kernels.rhs_splat;
+            forEachElementRun<3>(plan.shape,
+                                 plan.strides,
+                                 data,
+                                 kBinaryGrainElements,
+                                 [kernel](const std::array<std::byte*, 3>& run_data,
+                                          const std::array<int64_t, 3>& /*strides*/,
+                                          int64_t count) {
+                                     kernel(reinterpret_cast<const T*>(run_data[0]),
+                                            reinterpret_cast<const T*>(run_data[1]),
+                                            reinterpret_cast<T*>(run_data[2]),
+                                            count);
+                                 });
+            return;
+        }
+        case BroadcastPattern::Generic:
+            break;
+    }
+    forEachElementRun<3>(plan.shape,
+                         plan.strides,
+                         data,
+                         kBinaryGrainElements,
+                         [&kernels](const std::array<std::byte*, 3>& run_data,
+                                    const std::array<int64_t, 3>& strides,
+                                    int64_t count) {
+                             if (strides[0] == kItemSize && strides[1] == kItemSize
+                                 && strides[2] == kItemSize) {
+                                 kernels.contiguous(
+                                     reinterpret_cast<const T*>(run_data[0]),
+                                     reinterpret_cast<const T*>(run_data[1]),
+                                     reinterpret_cast<T*>(run_data[2]),
+                                     count);
+                                 return;
+                             }
+                             kernels.strided(run_data, strides, count);
+                         });
+}
+} // namespace
+} // namespace detail
+
+Tensor applyBinary(BinaryOp op, const Tensor& lhs, const Tensor& rhs) {
+    Tensor out(detail::broadcastTensorShapes({lhs, rhs}), lhs.dtype());
+    applyBinary(op, lhs, rhs, out);
+    return out;
+}
+
+void applyBinary(BinaryOp op, const Tensor& lhs, const Tensor& rhs, Tensor& out) {
+    if (lhs.dtype() != rhs.dtype() || lhs.dtype() != out.dtype()) {
+        throw TypesMismatchError("Operands and output data types are different");
+    }
+    const detail::BinaryPlan plan = detail::makeBinaryPlan(lhs, rhs, out);
+    const auto run = [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        detail::runBinaryPlan<T>(detail::selectBinaryKernels<T>(op), plan, lhs, rhs, out);
+    };
+    if (op == BinaryOp::Div) {
+        detail::dispatchDataType(
+            detail::FloatingPointTypes{}, out.dtype(), "floating point", run);
+    } else {
+        detail::dispatchArithmeticDataType(out.dtype(), run);
+    }
+}
+
+BroadcastPattern
+selectBroadcastPattern(const Tensor& lhs, const Tensor& rhs, const Tensor& out) {
+    return detail::makeBinaryPlan(lhs, rhs, out).pattern;
+}
+
+void setBroadcastPatternKernelsEnabled(bool enabled) noexcept {
+    detail::pattern_kernels_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool broadcastPatternKernelsEnabled() noexcept {
+    return detail::pattern_kernels_enabled.load(std::memory_order_relaxed);
+}
+} // namespace nope
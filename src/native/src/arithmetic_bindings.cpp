@@ -0,0 +1,63 @@
+#include "arithmetic_bindings.h"
+
+#include <utility>
+
+#include "nope/arithmetic.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+namespace {
+void defBinaryFunction(py::module_& module, const char* name, BinaryOp op) {
+    module.def(
+        name,
+        [op](const Tensor& lhs, const Tensor& rhs, const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return applyBinary(op, lhs, rhs);
+                }();
+                return py::cast(std::move(result));
+            }
+            // Tensor converted from an out array doesn't own it, so out is returned
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                applyBinary(op, lhs, rhs, dst);
+            }
+            return out;
+        },
+        py::arg("lhs"),
+        py::arg("rhs"),
+        py::arg("out") = py::none());
+}
+} // namespace
+
+void registerArithmeticBindings(py::module_& module) {
+    defBinaryFunction(module, "add", BinaryOp::Add);
+    defBinaryFunction(module, "subtract", BinaryOp::Sub);
+    defBinaryFunction(module, "multiply", BinaryOp::Mul);
+    defBinaryFunction(module, "divide", BinaryOp::Div);
+
+    py::enum_<BroadcastPattern>(module, "BroadcastPattern")
+        .value("GENERIC", BroadcastPattern::Generic)
+        .value("SCALAR_LHS", BroadcastPattern::ScalarLhs)
+        .value("SCALAR_RHS", BroadcastPattern::ScalarRhs)
+        .value("ROW_LHS", BroadcastPattern::RowLhs)
+        .value("ROW_RHS", BroadcastPattern::RowRhs)
+        .value("COLUMN_LHS", BroadcastPattern::ColumnLhs)
+        .value("COLUMN_RHS", BroadcastPattern::ColumnRhs);
+    module.def("select_broadcast_pattern",
+               &selectBroadcastPattern,
+               py::arg("lhs"),
+               py::arg("rhs"),
+               py::arg("out"));
+    module.def("set_broadcast_pattern_kernels_enabled",
+               &setBroadcastPatternKernelsEnabled,
+               py::arg("enabled"));
+    module.def("are_broadcast_pattern_kernels_enabled", &broadcastPatternKernelsEnabled);
+}
+} // namespace nope
@@ -0,0 +1,240 @@
+#include "nope/concatenation.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "nope/strided_copy.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kConcatGrainBytes = 64 * 1024;
+
+/**
+ * \brief Contiguous input of concatenate. It consists of one block per
+ * position of the output dimensions preceding the axis, each block is copied
+ * to the same offset of the corresponding output row.
+ */
+struct ConcatBlocks {
+    const std::byte* data{nullptr};
+    int64_t block_bytes{0};
+    int64_t out_offset{0};
+};
+
+/**
+ * \brief Copies all bytes of \a sources to \a out with rows of \a row_bytes.
+ * Concatenated bytes of sources are split into equal ranges, so a range might
+ * cover several sources or a part of a single block.
+ */
+void copyBlocks(const std::vector<ConcatBlocks>& sources,
+                const std::vector<int64_t>& sizes,
+                std::byte* out,
+                int64_t row_bytes) {
+    // Bytes of sources preceding each of them, sizes are positive
+    std::vector<int64_t> source_begin(sources.size() + 1, 0);
+    for (size_t k = 0; k < sources.size(); ++k) {
+        source_begin[k + 1] = source_begin[k] + sizes[k];
+    }
+    const int64_t total_bytes = source_begin.back();
+    parallelFor(0, total_bytes, kConcatGrainBytes, [&](int64_t begin, int64_t end) {
+        auto k = static_cast<size_t>(
+            std::upper_bound(source_begin.begin(), source_begin.end(), begin)
+            - source_begin.begin() - 1);
+        for (; begin < end; ++k) {
+            const ConcatBlocks& source = sources[k];
+            int64_t position = begin - source_begin[k];
+            const int64_t position_end = std::min(end, source_begin[k + 1])
+                                         - source_begin[k];
+            while (position < position_end) {
+                const int64_t row = position / source.block_bytes;
+                const int64_t column = position % source.block_bytes;
+                const int64_t size = std::min(source.block_bytes - column,
+                                              position_end - position);
+                std::memcpy(out + row * row_bytes + source.out_offset + column,
+                            source.data + position,
+                            static_cast<size_t>(size));
+                position += size;
+            }
+            begin = source_begin[k] + position_end;
+        }
+    });
+}
+
+/**
+ * \brief View of \a size positions of \a src along \a axis starting from
+ * \a start.
+ */
+Tensor sliceAxis(const Tensor& src, size_t axis, int64_t start, int64_t size) {
+    std::vector<int64_t> shape = src.shape();
+    shape[axis] = size;
+    return src.asStrided(std::move(shape),
+                         src.strides(),
+                         src.storageOffset() + start * src.strides()[axis]);
+}
+} // namespace
+} // namespace detail
+
+Tensor concatenate(const std::vector<Tensor>& tensors, int64_t axis) {
+    if (tensors.empty()) {
+        throw std::invalid_argument("At least one tensor is required to concatenate");
+    }
+    const Tensor& first = tensors.front();
+    if (first.dims() == 0) {
+        throw std::length_error("Zero-dimensional tensors can't be concatenated");
+    }
+    axis = normalizeAxis(axis, static_cast<int64_t>(first.dims()));
+    const auto axis_idx = static_cast<size_t>(axis);
+
+    std::vector<int64_t> out_shape = first.shape();
+    out_shape[axis_idx] = 0;
+    for (const auto& tensor : tensors) {
+        if (tensor.dtype() != first.dtype()) {
+            throw TypesMismatchError("Concatenated tensors have different data types: "
+                                     + to_string(first.dtype()) + " and "
+                                     + to_string(tensor.dtype()));
+        }
+        bool is_compatible = tensor.dims() == first.dims();
+        for (size_t dim = 0; is_compatible && dim < first.dims(); ++dim) {
+            is_compatible = dim == axis_idx || tensor.dim(dim) == first.dim(dim);
+        }
+        if (!is_compatible) {
+            throw std::length_error(
+                "Concatenated tensors shapes should be equal except axis "
+                + std::to_string(axis));
+        }
+        out_shape[axis_idx] += tensor.dim(axis_idx);
+    }
+    Tensor out(std::move(out_shape), first.dtype());
+    if (out.numel() == 0) {
+        return out;
+    }
+
+    const int64_t axis_stride = out.strides()[axis_idx];
+    const int64_t row_bytes = out.dim(axis_idx) * axis_stride;
+    std::vector<detail::ConcatBlocks> blocks;
+    std::vector<int64_t> blocks_sizes;
+    int64_t out_offset = 0;
+    for (const auto& tensor : tensors) {
+        const int64_t offset = out_offset;
+        out_offset += tensor.dim(axis_idx) * axis_stride;
+        if (tensor.numel() == 0) {
+            continue;
+        }
+        if (tensor.isContiguous()) {
+            blocks.push_back({tensor.data(), tensor.dim(axis_idx) * axis_stride, offset});
+            blocks_sizes.push_back(tensor.numel() * tensor.dtype().ssize());
+        } else {
+            detail::copyStrided(tensor.shape().data(),
+                                static_cast<int64_t>(tensor.dims()),
+                                tensor.data(),
+                                tensor.strides().data(),
+                                out.data() + offset,
+                                out.strides().data(),
+                                tensor.dtype().ssize());
+        }
+    }
+    detail::copyBlocks(blocks, blocks_sizes, out.data(), row_bytes);
+    return out;
+}
+
+Tensor stack(const std::vector<Tensor>& tensors, int64_t axis) {
+    if (tensors.empty()) {
+        throw std::invalid_argument("At least one tensor is required to stack");
+    }
+    const Tensor& first = tensors.front();
+    axis = normalizeAxis(axis, static_cast<int64_t>(first.dims()) + 1);
+    const auto axis_idx = static_cast<size_t>(axis);
+
+    std::vector<Tensor> views;
+    views.reserve(tensors.size());
+    for (const auto& tensor : tensors) {
+        if (tensor.shape() != first.shape()) {
+            throw std::length_error("Stacked tensors should have the same shape");
+        }
+        // Stride of the new axis keeps contiguous tensors contiguous
+        std::vector<int64_t> shape = tensor.shape();
+        std::vector<int64_t> strides = tensor.strides();
+        const int64_t stride = axis_idx == tensor.dims()
+                                   ? tensor.dtype().ssize()
+                                   : shape[axis_idx] * strides[axis_idx];
+        shape.insert(shape.begin() + axis, 1);
+        strides.insert(strides.begin() + axis, stride);
+        views.push_back(tensor.asStrided(
+            std::move(shape), std::move(strides), tensor.storageOffset()));
+    }
+    return concatenate(views, axis);
+}
+
+std::vector<Tensor> split(const Tensor& src, int64_t split_size, int64_t axis) {
+    if (split_size < 1) {
+        throw std::invalid_argument("Split size should be positive, got "
+                                    + std::to_string(split_size));
+    }
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    const int64_t extent = src.dim(static_cast<size_t>(axis));
+    const int64_t n_views = std::max(int64_t{1}, (extent + split_size - 1) / split_size);
+    std::vector<int64_t> sizes(static_cast<size_t>(n_views), split_size);
+    sizes.back() = extent - (n_views - 1) * split_size;
+    return splitWithSizes(src, sizes, axis);
+}
+
+std::vector<Tensor>
+splitWithSizes(const Tensor& src, const std::vector<int64_t>& sizes, int64_t axis) {
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    const auto axis_idx = static_cast<size_t>(axis);
+    int64_t total = 0;
+    for (const int64_t size : sizes) {
+        if (size < 0) {
+            throw std::invalid_argument("Split sizes should be non-negative, got "
+                                        + std::to_string(size));
+        }
+        total += size;
+    }
+    if (total != src.dim(axis_idx)) {
+        throw std::invalid_argument("Split sizes sum " + std::to_string(total)
+                                    + " is not equal to the axis extent "
+                                    + std::to_string(src.dim(axis_idx)));
+    }
+
+    std::vector<Tensor> views;
+    views.reserve(sizes.size());
+    int64_t start = 0;
+    for (const int64_t size : sizes) {
+        views.push_back(detail::sliceAxis(src, axis_idx, start, size));
+        start += size;
+    }
+    return views;
+}
+
+std::vector<Tensor> chunk(const Tensor& src, int64_t chunks, int64_t axis) {
+    if (chunks < 1) {
+        throw std::invalid_argument("Number of chunks should be positive, got "
+                                    + std::to_string(chunks));
+    }
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    const int64_t extent = src.dim(static_cast<size_t>(axis));
+    return split(src, std::max(int64_t{1}, (extent + chunks - 1) / chunks), axis);
+}
+
+std::vector<Tensor> unbind(const Tensor& src, int64_t axis) {
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    const auto axis_idx = static_cast<size_t>(axis);
+    std::vector<int64_t> shape = src.shape();
+    std::vector<int64_t> strides = src.strides();
+    shape.erase(shape.begin() + axis);
+    strides.erase(strides.begin() + axis);
+
+    std::vector<Tensor> views;
+    views.reserve(static_cast<size_t>(src.dim(axis_idx)));
+    for (int64_t i = 0; i < src.dim(axis_idx); ++i) {
+        views.push_back(src.asStrided(
+            shape, strides, src.storageOffset() + i * src.strides()[axis_idx]));
+    }
+    return views;
+}
+} // namespace nope
@@ -0,0 +1,46 @@
+#include "concatenation_bindings.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "nope/concatenation.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+void registerConcatenationBindings(py::module_& module) {
+    module.def(
+        "concatenate",
+        [](const std::vector<Tensor>& tensors, int64_t axis) {
+            py::gil_scoped_release release;
+            return concatenate(tensors, axis);
+        },
+        py::arg("tensors"),
+        py::arg("axis") = 0);
+    module.def(
+        "stack",
+        [](const std::vector<Tensor>& tensors, int64_t axis) {
+            py::gil_scoped_release release;
+            return stack(tensors, axis);
+        },
+        py::arg("tensors"),
+        py::arg("axis") = 0);
+    // Views are created without copying, so GIL is kept
+    module.def("split",
+               py::overload_cast<const Tensor&, int64_t, int64_t>(&split),
+               py::arg("tensor"),
+               py::arg("split_size_or_sections"),
+               py::arg("axis") = 0);
+    module.def("split",
+               &splitWithSizes,
+               py::arg("tensor"),
+               py::arg("split_size_or_sections"),
+               py::arg("axis") = 0);
+    module.def(
+        "chunk", &chunk, py::arg("tensor"), py::arg("chunks"), py::arg("axis") = 0);
+    module.def("unbind", &unbind, py::arg("tensor"), py::arg("axis") = 0);
+}
+} // namespace nope
@@ -0,0 +1,26 @@
+#include "cpu_features.h"
+
+namespace nope {
+namespace detail {
+namespace {
+CpuFeatures detectCpuFeatures() noexcept {
+    CpuFeatures features;
+#if NOPE_X86_DISPATCH
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+                    && __builtin_cpu_supports("bmi2");
+    features.avx512 = features.avx2 && __builtin_cpu_supports("avx512f")
+                      && __builtin_cpu_supports("avx512bw")
+                      && __builtin_cpu_supports("avx512vl");
+    features.avx512_vnni = features.avx512 && __builtin_cpu_supports("avx512vnni");
+#endif
+    return features;
+}
+} // namespace
+
+const CpuFeatures& cpuFeatures() noexcept {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+} // namespace detail
+} // namespace nope
@@ -0,0 +1,44 @@
+#pragma once
+
+// Runtime dispatch to instruction set specific kernels relies on GCC/Clang
+// function level target attributes, so kernels are compiled for baseline
+// architecture and selected on the first call.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define NOPE_X86_DISPATCH 1
+    #define NOPE_TARGET_AVX2 __attribute__((target("avx2,fma,bmi2,popcnt")))
+    #define NOPE_TARGET_AVX512 \
+        __attribute__((target("avx512f,avx512bw,avx512vl,avx2,fma,bmi2,popcnt")))
+    #define NOPE_TARGET_AVX512_VNNI                                  \
+        __attribute__((target("avx512f,avx512bw,avx512vl,avx512vnni," \
+                              "avx2,fma,bmi2,popcnt")))
+#else
+    #define NOPE_X86_DISPATCH 0
+#endif
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Instruction set extensions supported by the CPU the library is
+ * running on. Detected once on the first access.
+ */
+struct CpuFeatures {
+    bool avx2{false};
+    bool avx512{false};
+    /// 8 and 16-bit integer dot products accumulated into 32-bit lanes
+    bool avx512_vnni{false};
+};
+
+const CpuFeatures& cpuFeatures() noexcept;
+
+#if NOPE_X86_DISPATCH
+/**
+ * \brief GCC vector extension type of 256-bit register, arithmetic operators
+ * are compiled into AVX2 instructions inside of NOPE_TARGET_AVX2 functions.
+ */
+template <class Lane>
+struct Avx2Vector {
+    typedef Lane type __attribute__((vector_size(32)));
+};
+#endif
+} // namespace detail
+} // namespace nope
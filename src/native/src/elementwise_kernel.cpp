@@ -0,0 +1,132 @@
+#include "nope/elementwise_kernel.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "elementwise_loop.h"
+
+namespace nope {
+namespace detail {
+namespace {
+using RunLoopFunction = void (*)(ElementwiseLoopFunction function,
+                                 void* user_data,
+                                 const std::vector<Tensor>& inputs,
+                                 Tensor& out,
+                                 int64_t grain_size);
+
+template <size_t NOperands>
+void runLoop(ElementwiseLoopFunction function,
+             void* user_data,
+             const std::vector<Tensor>& inputs,
+             Tensor& out,
+             int64_t grain_size) {
+    constexpr size_t kOut = NOperands - 1;
+    std::array<std::vector<int64_t>, NOperands> strides;
+    std::array<std::byte*, NOperands> data{};
+    for (size_t k = 0; k < kOut; ++k) {
+        strides[k] = broadcastStrides(inputs[k], out.shape());
+        // Inputs are only read, pointers of all operands share the same type
+        data[k] = const_cast<std::byte*>(inputs[k].data());
+    }
+    strides[kOut] = out.strides();
+    data[kOut] = out.data();
+    forEachElementRun<NOperands>(
+        out.shape(),
+        std::move(strides),
+        data,
+        grain_size,
+        [function, user_data](const std::array<std::byte*, NOperands>& run_data,
+                              const std::array<int64_t, NOperands>& run_strides,
+                              int64_t count) {
+            function(run_data.data(), run_strides.data(), count, user_data);
+        });
+}
+
+/**
+ * \brief Instantiations of runLoop indexed by number of inputs minus 1.
+ */
+template <size_t... NInputs>
+constexpr std::array<RunLoopFunction, sizeof...(NInputs)>
+makeRunLoopTable(std::index_sequence<NInputs...> /*unused*/) noexcept {
+    return {&runLoop<NInputs + 2>...};
+}
+
+constexpr auto kRunLoopTable = makeRunLoopTable(
+    std::make_index_sequence<static_cast<size_t>(ElementwiseKernel::kMaxInputs)>{});
+} // namespace
+} // namespace detail
+
+ElementwiseKernel::ElementwiseKernel(std::string name,
+                                     int64_t n_inputs,
+                                     int64_t grain_size)
+    : name_{std::move(name)}, n_inputs_{n_inputs}, grain_size_{grain_size} {
+    if (n_inputs < 1 || n_inputs > kMaxInputs) {
+        throw std::invalid_argument("Number of " + name_ + " inputs should be in [1, "
+                                    + std::to_string(kMaxInputs) + "], got "
+                                    + std::to_string(n_inputs));
+    }
+    if (grain_size < 1) {
+        throw std::invalid_argument("Grain size should be positive, got "
+                                    + std::to_string(grain_size));
+    }
+}
+
+void ElementwiseKernel::registerLoop(TensorDataType dtype,
+                                     ElementwiseLoopFunction function,
+                                     std::optional<TensorDataType> out_dtype,
+                                     void* user_data) {
+    if (function == nullptr) {
+        throw std::invalid_argument("Inner loop function of " + name_ + " is null");
+    }
+    loops_[dtype.typeId()] = Loop{function, out_dtype.value_or(dtype), user_data};
+}
+
+bool ElementwiseKernel::hasLoop(TensorDataType dtype) const noexcept {
+    return loops_[dtype.typeId()].has_value();
+}
+
+Tensor ElementwiseKernel::operator()(const std::vector<Tensor>& inputs) const {
+    const Loop& loop = findLoop(inputs);
+    Tensor out(detail::broadcastTensorShapes(inputs), loop.out_dtype);
+    (*this)(inputs, out);
+    return out;
+}
+
+void ElementwiseKernel::operator()(const std::vector<Tensor>& inputs, Tensor& out) const {
+    const Loop& loop = findLoop(inputs);
+    if (out.dtype() != loop.out_dtype) {
+        throw TypesMismatchError(name_ + " output data type should be "
+                                 + to_string(loop.out_dtype) + ", got "
+                                 + to_string(out.dtype()));
+    }
+    detail::kRunLoopTable[inputs.size() - 1](
+        loop.function, loop.user_data, inputs, out, grain_size_);
+}
+
+const ElementwiseKernel::Loop&
+ElementwiseKernel::findLoop(const std::vector<Tensor>& inputs) const {
+    if (static_cast<int64_t>(inputs.size()) != n_inputs_) {
+        throw std::invalid_argument(name_ + " expects " + std::to_string(n_inputs_)
+                                    + " inputs, got " + std::to_string(inputs.size()));
+    }
+    const TensorDataType dtype = inputs.front().dtype();
+    for (const auto& input : inputs) {
+        if (input.dtype() != dtype) {
+            throw TypesMismatchError(name_ + " inputs have different data types: "
+                                     + to_string(dtype) + " and "
+                                     + to_string(input.dtype()));
+        }
+    }
+    const auto& loop = loops_[dtype.typeId()];
+    if (!loop) {
+        throw TypesMismatchError(name_ + " is not supported for data type "
+                                 + to_string(dtype));
+    }
+    return *loop;
+}
+} // namespace nope
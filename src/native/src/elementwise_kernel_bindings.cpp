@@ -0,0 +1,105 @@
+#include "elementwise_kernel_bindings.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nope/elementwise_kernel.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+namespace {
+/**
+ * \brief Converts integer address, Numba cfunc or ctypes function object into
+ * the inner loop function pointer.
+ */
+ElementwiseLoopFunction toLoopFunction(const py::object& function) {
+    uintptr_t address = 0;
+    if (py::isinstance<py::int_>(function)) {
+        address = function.cast<uintptr_t>();
+    } else if (py::hasattr(function, "address")) {
+        address = function.attr("address").cast<uintptr_t>();
+    } else {
+        const py::module_ ctypes = py::module_::import("ctypes");
+        const py::object pointer = ctypes.attr("cast")(function, ctypes.attr("c_void_p"));
+        address = pointer.attr("value").is_none()
+                      ? 0
+                      : pointer.attr("value").cast<uintptr_t>();
+    }
+    return reinterpret_cast<ElementwiseLoopFunction>(address);
+}
+
+std::vector<Tensor> toTensors(const py::args& args) {
+    std::vector<Tensor> tensors;
+    tensors.reserve(args.size());
+    for (const auto& arg : args) {
+        tensors.push_back(arg.cast<Tensor>());
+    }
+    return tensors;
+}
+} // namespace
+
+void registerElementwiseKernelBindings(py::module_& module) {
+    py::class_<ElementwiseKernel>(module, "ElementwiseKernel")
+        .def(py::init<std::string, int64_t, int64_t>(),
+             py::arg("name"),
+             py::arg("n_inputs"),
+             py::arg("grain_size") = ElementwiseKernel::kDefaultGrainSize)
+        .def(
+            "register_loop",
+            [](ElementwiseKernel& kernel,
+               TensorDataType dtype,
+               const py::object& function,
+               std::optional<TensorDataType> out_dtype,
+               uintptr_t user_data) {
+                kernel.registerLoop(dtype,
+                                    toLoopFunction(function),
+                                    out_dtype,
+                                    reinterpret_cast<void*>(user_data));
+            },
+            py::arg("dtype"),
+            py::arg("function"),
+            py::arg("out_dtype") = py::none(),
+            py::arg("user_data") = 0,
+            // Kernel keeps Numba/ctypes function object owning the code alive
+            py::keep_alive<1, 3>())
+        .def("has_loop", &ElementwiseKernel::hasLoop, py::arg("dtype"))
+        .def_property_readonly("name", &ElementwiseKernel::name)
+        .def_property_readonly("n_inputs", &ElementwiseKernel::inputsCount)
+        .def_property_readonly("grain_size", &ElementwiseKernel::grainSize)
+        .def("__call__",
+             [](const ElementwiseKernel& kernel,
+                const py::args& args,
+                const py::object& out) -> py::object {
+                 const std::vector<Tensor> inputs = toTensors(args);
+                 // Loops implemented as Python ctypes callbacks acquire GIL
+                 // from worker threads, so it should be released
+                 if (out.is_none()) {
+                     Tensor result = [&] {
+                         py::gil_scoped_release release;
+                         return kernel(inputs);
+                     }();
+                     return py::cast(std::move(result));
+                 }
+                 Tensor dst = out.cast<Tensor>();
+                 {
+                     py::gil_scoped_release release;
+                     kernel(inputs, dst);
+                 }
+                 return out;
+             },
+             // Arguments following *args are keyword only
+             py::arg("out") = py::none())
+        .def("__repr__", [](const ElementwiseKernel& kernel) {
+            return "ElementwiseKernel(name="
+                   + py::repr(py::str(kernel.name())).cast<std::string>()
+                   + ", n_inputs=" + std::to_string(kernel.inputsCount()) + ")";
+        });
+}
+} // namespace nope
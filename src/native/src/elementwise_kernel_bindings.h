@@ -0,0 +1,7 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace nope {
+void registerElementwiseKernelBindings(pybind11::module_& module);
+} // namespace nope
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nd_offset_iterator.h"
+#include "nope/broadcasting.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "nope/tensor.h"
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Byte strides of \a tensor broadcasted to \a shape: dimensions of
+ * size 1 and missing leading dimensions get stride 0.
+ *
+ * \throw std::length_error if \a tensor shape is not broadcastable to \a shape.
+ */
+inline std::vector<int64_t> broadcastStrides(const Tensor& tensor,
+                                             const std::vector<int64_t>& shape) {
+    const auto& src_shape = tensor.shape();
+    if (src_shape.size() > shape.size()) {
+        throw std::length_error("Tensor of " + std::to_string(src_shape.size())
+                                + " dimensions can't be broadcasted to "
+                                + std::to_string(shape.size()) + " dimensions");
+    }
+    std::vector<int64_t> strides(shape.size(), 0);
+    const size_t skipped = shape.size() - src_shape.size();
+    for (size_t i = 0; i < src_shape.size(); ++i) {
+        if (src_shape[i] == shape[skipped + i]) {
+            strides[skipped + i] = src_shape[i] == 1 ? 0 : tensor.strides()[i];
+        } else if (src_shape[i] != 1) {
+            throw std::length_error("Dimension " + std::to_string(i) + " of size "
+                                    + std::to_string(src_shape[i])
+                                    + " can't be broadcasted to size "
+                                    + std::to_string(shape[skipped + i]));
+        }
+    }
+    return strides;
+}
+
+/**
+ * \brief Common shape of \a inputs broadcasted to each other. 0-dimensional
+ * tensors are broadcastable to any shape.
+ *
+ * \throw std::length_error if shapes are not broadcastable.
+ */
+inline std::vector<int64_t> broadcastTensorShapes(const std::vector<Tensor>& inputs) {
+    std::vector<std::vector<int64_t>> shapes;
+    shapes.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        if (input.dims() > 0) {
+            shapes.push_back(input.shape());
+        }
+    }
+    if (shapes.empty()) {
+        return {};
+    }
+    std::vector<int64_t> shape = nope::broadcastShapes(shapes);
+    if (shape.empty()) {
+        throw std::length_error("Input shapes are not broadcastable");
+    }
+    return shape;
+}
+
+/**
+ * \brief Invokes \a loop for every element of \a NOperands strided operands
+ * sharing the same \a shape, splitting row-major index space between threads.
+ *
+ * Dimensions are coalesced first, so the innermost run is as long as memory
+ * layout of all operands allows. Each thread walks its own range of indices and
+ * calls \code loop(data, strides, count) \endcode for runs of \a count elements
+ * along the innermost dimension, where \a data are pointers to the first
+ * elements of the run and \a strides are the innermost byte strides. Runs are
+ * split at the chunk boundaries, so a single long row is still processed in
+ * parallel.
+ *
+ * \param shape Common shape of the operands.
+ * \param strides Byte strides of each operand, 0 for broadcasted dimensions.
+ * \param data Pointers to the first elements of the operands.
+ * \param grain_size Minimal number of elements processed by a single thread.
+ * \param loop Inner loop function object.
+ */
+template <size_t NOperands, class InnerLoop>
+void forEachElementRun(std::vector<int64_t> shape,
+                       std::array<std::vector<int64_t>, NOperands> strides,
+                       const std::array<std::byte*, NOperands>& data,
+                       int64_t grain_size,
+                       const InnerLoop& loop) {
+    int64_t numel = 1;
+    for (const int64_t dim : shape) {
+        numel *= dim;
+    }
+    if (numel == 0) {
+        return;
+    }
+    std::array<int64_t, NOperands> run_strides{};
+    if (shape.empty()) {
+        loop(data, run_strides, int64_t{1});
+        return;
+    }
+    std::array<int64_t*, NOperands> strides_ptr{};
+    for (size_t k = 0; k < NOperands; ++k) {
+        strides_ptr[k] = strides[k].data();
+    }
+    auto dims = static_cast<int64_t>(shape.size());
+    dims = coalesceDimensions(
+        shape.data(), strides_ptr.data(), static_cast<int64_t>(NOperands), dims);
+
+    const int64_t run_size = shape[static_cast<size_t>(dims - 1)];
+    for (size_t k = 0; k < NOperands; ++k) {
+        run_strides[k] = strides[k][static_cast<size_t>(dims - 1)];
+    }
+    std::array<const int64_t*, NOperands> outer_strides{};
+    for (size_t k = 0; k < NOperands; ++k) {
+        outer_strides[k] = strides[k].data();
+    }
+    parallelFor(0, numel, grain_size, [&](int64_t begin, int64_t end) {
+        NdOffsetIterator<NOperands> it(
+            shape.data(), dims - 1, outer_strides, begin / run_size);
+        int64_t column = begin % run_size;
+        for (int64_t i = begin; i < end; it.next()) {
+            const int64_t count = std::min(run_size - column, end - i);
+            std::array<std::byte*, NOperands> run_data{};
+            for (size_t k = 0; k < NOperands; ++k) {
+                run_data[k] = data[k] + it.offset(k) + column * run_strides[k];
+            }
+            loop(run_data, run_strides, count);
+            i += count;
+            column = 0;
+        }
+    });
+}
+} // namespace detail
+} // namespace nope
@@ -0,0 +1,556 @@
+#include "nope/indexing.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cpu_features.h"
+#include "nd_offset_iterator.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "nope/strided_copy.h"
+#include "type_dispatch.h"
+
+#if NOPE_X86_DISPATCH
+    #include <immintrin.h>
+#endif
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Columns are index positions with all coordinates fixed except the
+ * axis one, offsets of the 3 operands are: src, out, idx (in elements).
+ */
+struct ScatterAddArgs {
+    const int64_t* column_shape{nullptr};
+    int64_t column_dims{0};
+    std::array<const int64_t*, 3> column_strides{};
+    int64_t n_columns{0};
+    int64_t column_size{0};
+    const std::byte* src{nullptr};
+    int64_t src_axis_stride{0};
+    std::byte* out{nullptr};
+    int64_t out_axis_stride{0};
+    int64_t out_axis_size{0};
+    const int64_t* idx{nullptr};
+    int64_t idx_axis_stride{0};
+};
+
+namespace {
+constexpr int64_t kCopyGrainBytes = 64 * 1024;
+constexpr int64_t kScatterGrainElements = 4 * 1024;
+constexpr int64_t kMaskGrainElements = 64 * 1024;
+
+/**
+ * \brief Reads \a indices of any integer type into contiguous vector wrapping
+ * negative values and validating bounds against \a axis_size.
+ */
+std::vector<int64_t> normalizedIndices(const Tensor& indices, int64_t axis_size) {
+    const Tensor contiguous_indices = indices.contiguous();
+    std::vector<int64_t> normalized(static_cast<size_t>(indices.numel()));
+    dispatchIntegerDataType(indices.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        const T* values = contiguous_indices.unsafeData<T>();
+        for (size_t i = 0; i < normalized.size(); ++i) {
+            if constexpr (std::is_same_v<T, uint64_t>) {
+                constexpr auto kMaxIndex = static_cast<uint64_t>(
+                    std::numeric_limits<int64_t>::max());
+                if (values[i] > kMaxIndex) {
+                    throw std::out_of_range("Index " + std::to_string(values[i])
+                                            + " is out of bounds for axis with size "
+                                            + std::to_string(axis_size));
+                }
+            }
+            auto index = static_cast<int64_t>(values[i]);
+            if (index < -axis_size || index >= axis_size) {
+                throw std::out_of_range("Index " + std::to_string(index)
+                                        + " is out of bounds for axis with size "
+                                        + std::to_string(axis_size));
+            }
+            normalized[i] = index < 0 ? index + axis_size : index;
+        }
+    });
+    return normalized;
+}
+
+template <size_t BlockSize>
+void copyBlocks(std::byte* dst, const std::byte* src) noexcept {
+    std::memcpy(dst, src, BlockSize);
+}
+
+using BlockCopy = void (*)(std::byte*, const std::byte*) noexcept;
+
+BlockCopy selectFixedBlockCopy(int64_t block_bytes) noexcept {
+    switch (block_bytes) {
+        case 1:
+            return &copyBlocks<1>;
+        case 2:
+            return &copyBlocks<2>;
+        case 4:
+            return &copyBlocks<4>;
+        case 8:
+            return &copyBlocks<8>;
+        case 16:
+            return &copyBlocks<16>;
+        default:
+            return nullptr;
+    }
+}
+
+int64_t countNonZero(const uint8_t* mask, int64_t count) noexcept {
+    int64_t n = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        n += static_cast<int64_t>(mask[i] != 0);
+    }
+    return n;
+}
+
+/**
+ * \brief Branchless compaction writing \a dst[n] unconditionally. Safe, because
+ * slot \a n belongs to this chunk while n < \a n_selected.
+ */
+template <class T>
+void compressScalar(const T* src,
+                    const uint8_t* mask,
+                    int64_t count,
+                    T* dst,
+                    int64_t n_selected) noexcept {
+    int64_t n = 0;
+    for (int64_t i = 0; i < count && n < n_selected; ++i) {
+        dst[n] = src[i];
+        n += static_cast<int64_t>(mask[i] != 0);
+    }
+}
+
+#if NOPE_X86_DISPATCH
+NOPE_TARGET_AVX512 void compress32Avx512(const uint32_t* src,
+                                         const uint8_t* mask,
+                                         int64_t count,
+                                         uint32_t* dst,
+                                         int64_t n_selected) noexcept {
+    const int64_t vector_end = count - count % 16;
+    int64_t i = 0;
+    int64_t n = 0;
+    for (; i < vector_end; i += 16) {
+        const __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i));
+        const __mmask16 k = _mm_test_epi8_mask(m, m);
+        _mm512_mask_compressstoreu_epi32(dst + n, k, _mm512_loadu_si512(src + i));
+        n += _mm_popcnt_u32(k);
+    }
+    compressScalar(src + i, mask + i, count - i, dst + n, n_selected - n);
+}
+
+NOPE_TARGET_AVX512 void compress64Avx512(const uint64_t* src,
+                                         const uint8_t* mask,
+                                         int64_t count,
+                                         uint64_t* dst,
+                                         int64_t n_selected) noexcept {
+    const int64_t vector_end = count - count % 8;
+    int64_t i = 0;
+    int64_t n = 0;
+    for (; i < vector_end; i += 8) {
+        const __m128i m = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i));
+        const auto k = static_cast<__mmask8>(_mm_test_epi8_mask(m, m));
+        _mm512_mask_compressstoreu_epi64(dst + n, k, _mm512_loadu_si512(src + i));
+        n += _mm_popcnt_u32(k);
+    }
+    compressScalar(src + i, mask + i, count - i, dst + n, n_selected - n);
+}
+
+/**
+ * \brief Permutation table for AVX2 compaction: row \a m moves 32-bit lanes
+ * selected by bits of \a m to the front of the register.
+ */
+struct CompressLut {
+    alignas(32) std::array<std::array<uint32_t, 8>, 256> lanes32{};
+    alignas(32) std::array<std::array<uint32_t, 8>, 16> lanes64{};
+
+    CompressLut() noexcept {
+        for (uint32_t m = 0; m < 256; ++m) {
+            size_t k = 0;
+            for (uint32_t lane = 0; lane < 8; ++lane) {
+                if ((m >> lane) & 1U) {
+                    lanes32[m][k++] = lane;
+                }
+            }
+        }
+        for (uint32_t m = 0; m < 16; ++m) {
+            size_t k = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if ((m >> lane) & 1U) {
+                    lanes64[m][k++] = 2 * lane;
+                    lanes64[m][k++] = 2 * lane + 1;
+                }
+            }
+        }
+    }
+};
+
+const CompressLut& compressLut() noexcept {
+    static const CompressLut lut;
+    return lut;
+}
+
+NOPE_TARGET_AVX2 void compress32Avx2(const uint32_t* src,
+                                     const uint8_t* mask,
+                                     int64_t count,
+                                     uint32_t* dst,
+                                     int64_t n_selected) noexcept {
+    const auto& lut = compressLut().lanes32;
+    const __m128i zero = _mm_setzero_si128();
+    const int64_t vector_end = count - count % 8;
+    int64_t i = 0;
+    int64_t n = 0;
+    // Full register is stored, so stop while it still fits into the chunk
+    for (; i < vector_end && n_selected - n >= 8; i += 8) {
+        const __m128i m = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i));
+        const int zero_lanes = _mm_movemask_epi8(_mm_cmpeq_epi8(m, zero));
+        const auto bits = static_cast<uint32_t>(~zero_lanes) & 0xFFU;
+        const __m256i perm = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(lut[bits].data()));
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + n),
+                            _mm256_permutevar8x32_epi32(v, perm));
+        n += _mm_popcnt_u32(bits);
+    }
+    compressScalar(src + i, mask + i, count - i, dst + n, n_selected - n);
+}
+
+NOPE_TARGET_AVX2 void compress64Avx2(const uint64_t* src,
+                                     const uint8_t* mask,
+                                     int64_t count,
+                                     uint64_t* dst,
+                                     int64_t n_selected) noexcept {
+    const auto& lut = compressLut().lanes64;
+    const __m128i zero = _mm_setzero_si128();
+    const int64_t vector_end = count - count % 4;
+    int64_t i = 0;
+    int64_t n = 0;
+    for (; i < vector_end && n_selected - n >= 4; i += 4) {
+        int32_t mask_bytes = 0;
+        std::memcpy(&mask_bytes, mask + i, sizeof(mask_bytes));
+        const __m128i m = _mm_cvtsi32_si128(mask_bytes);
+        const int zero_lanes = _mm_movemask_epi8(_mm_cmpeq_epi8(m, zero));
+        const auto bits = static_cast<uint32_t>(~zero_lanes) & 0xFU;
+        const __m256i perm = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(lut[bits].data()));
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + n),
+                            _mm256_permutevar8x32_epi32(v, perm));
+        n += _mm_popcnt_u32(bits);
+    }
+    compressScalar(src + i, mask + i, count - i, dst + n, n_selected - n);
+}
+#endif
+
+void compressChunk(const std::byte* src,
+                   const uint8_t* mask,
+                   int64_t count,
+                   std::byte* dst,
+                   int64_t n_selected,
+                   int64_t element_size) {
+    switch (element_size) {
+        case 1:
+            return compressScalar(reinterpret_cast<const uint8_t*>(src),
+                                  mask,
+                                  count,
+                                  reinterpret_cast<uint8_t*>(dst),
+                                  n_selected);
+        case 2:
+            return compressScalar(reinterpret_cast<const uint16_t*>(src),
+                                  mask,
+                                  count,
+                                  reinterpret_cast<uint16_t*>(dst),
+                                  n_selected);
+        case 4: {
+            const auto* src32 = reinterpret_cast<const uint32_t*>(src);
+            auto* dst32 = reinterpret_cast<uint32_t*>(dst);
+#if NOPE_X86_DISPATCH
+            if (cpuFeatures().avx512) {
+                return compress32Avx512(src32, mask, count, dst32, n_selected);
+            }
+            if (cpuFeatures().avx2) {
+                return compress32Avx2(src32, mask, count, dst32, n_selected);
+            }
+#endif
+            return compressScalar(src32, mask, count, dst32, n_selected);
+        }
+        case 8: {
+            const auto* src64 = reinterpret_cast<const uint64_t*>(src);
+            auto* dst64 = reinterpret_cast<uint64_t*>(dst);
+#if NOPE_X86_DISPATCH
+            if (cpuFeatures().avx512) {
+                return compress64Avx512(src64, mask, count, dst64, n_selected);
+            }
+            if (cpuFeatures().avx2) {
+                return compress64Avx2(src64, mask, count, dst64, n_selected);
+            }
+#endif
+            return compressScalar(src64, mask, count, dst64, n_selected);
+        }
+        default:
+            for (int64_t i = 0, n = 0; i < count; ++i) {
+                if (mask[i] != 0) {
+                    std::memcpy(dst + n * element_size,
+                                src + i * element_size,
+                                static_cast<size_t>(element_size));
+                    ++n;
+                }
+            }
+    }
+}
+
+/**
+ * \brief Adds \a src values into \a out columns along the axis at positions
+ * given by normalized contiguous indices \a idx.
+ */
+template <class T>
+void scatterAddKernel(const ScatterAddArgs& args) {
+    const auto accumulate_columns = [&](int64_t column_begin,
+                                        int64_t column_end,
+                                        int64_t lo,
+                                        int64_t hi) {
+        NdOffsetIterator<3> it(args.column_shape,
+                               args.column_dims,
+                               {args.column_strides[0], args.column_strides[1],
+                                args.column_strides[2]},
+                               column_begin);
+        for (int64_t column = column_begin; column < column_end; ++column, it.next()) {
+            const std::byte* column_src = args.src + it.offset(0);
+            std::byte* column_out = args.out + it.offset(1);
+            const int64_t* column_idx = args.idx + it.offset(2);
+            for (int64_t k = 0; k < args.column_size; ++k) {
+                const int64_t pos = column_idx[k * args.idx_axis_stride];
+                if (pos < lo || pos >= hi) {
+                    continue;
+                }
+                auto* dst = reinterpret_cast<T*>(column_out + pos * args.out_axis_stride);
+                *dst = static_cast<T>(*dst
+                                      + *reinterpret_cast<const T*>(
+                                          column_src + k * args.src_axis_stride));
+            }
+        }
+    };
+
+    if (args.n_columns >= static_cast<int64_t>(getNumThreads())) {
+        // Each thread owns disjoint set of output columns
+        const int64_t grain = std::max(int64_t{1},
+                                       kScatterGrainElements / args.column_size);
+        parallelFor(0, args.n_columns, grain, [&](int64_t begin, int64_t end) {
+            accumulate_columns(begin, end, 0, args.out_axis_size);
+        });
+    } else {
+        // Too few columns - each thread owns a range of positions along axis
+        // and skips updates that fall outside of it
+        parallelFor(0, args.out_axis_size, 1, [&](int64_t lo, int64_t hi) {
+            accumulate_columns(0, args.n_columns, lo, hi);
+        });
+    }
+}
+} // namespace
+} // namespace detail
+
+Tensor take(const Tensor& src, const Tensor& indices, int64_t axis) {
+    const auto dims = static_cast<int64_t>(src.dims());
+    axis = normalizeAxis(axis, dims);
+    const auto axis_idx = static_cast<size_t>(axis);
+    const std::vector<int64_t> idx = detail::normalizedIndices(indices,
+                                                               src.dim(axis_idx));
+
+    std::vector<int64_t> out_shape(src.shape().begin(), src.shape().begin() + axis);
+    out_shape.insert(out_shape.end(), indices.shape().begin(), indices.shape().end());
+    out_shape.insert(out_shape.end(), src.shape().begin() + axis + 1, src.shape().end());
+    Tensor out(std::move(out_shape), src.dtype());
+    if (out.numel() == 0) {
+        return out;
+    }
+
+    const int64_t element_size = src.dtype().ssize();
+    const int64_t axis_stride = src.strides()[axis_idx];
+
+    std::vector<int64_t> outer_shape(src.shape().begin(), src.shape().begin() + axis);
+    std::vector<int64_t> outer_strides(src.strides().begin(),
+                                       src.strides().begin() + axis);
+    int64_t* outer_strides_ptr[] = {outer_strides.data()};
+    const int64_t outer_dims = detail::coalesceDimensions(
+        outer_shape.data(), outer_strides_ptr, 1, axis);
+
+    std::vector<int64_t> inner_shape(src.shape().begin() + axis + 1, src.shape().end());
+    std::vector<int64_t> inner_src_strides(src.strides().begin() + axis + 1,
+                                           src.strides().end());
+    std::vector<int64_t> inner_dst_strides = createContiguousStrides(inner_shape,
+                                                                     element_size);
+    const int64_t block_bytes = std::accumulate(
+        inner_shape.begin(), inner_shape.end(), element_size, std::multiplies<>{});
+    int64_t* inner_strides_ptr[] = {inner_src_strides.data(), inner_dst_strides.data()};
+    const int64_t inner_dims = detail::coalesceDimensions(
+        inner_shape.data(), inner_strides_ptr, 2, dims - axis - 1);
+    const bool is_block_contiguous = inner_dims == 0
+                                     || (inner_dims == 1
+                                         && inner_src_strides.front() == element_size);
+    const detail::BlockCopy fixed_copy = detail::selectFixedBlockCopy(block_bytes);
+
+    const auto n_indices = static_cast<int64_t>(idx.size());
+    const int64_t n_blocks = out.numel() * element_size / block_bytes;
+    const int64_t grain = std::max(int64_t{1}, detail::kCopyGrainBytes / block_bytes);
+    const std::byte* src_data = src.data();
+    std::byte* out_data = out.data();
+
+    parallelFor(0, n_blocks, grain, [&](int64_t begin, int64_t end) {
+        detail::NdOffsetIterator<1> outer_it(
+            outer_shape.data(), outer_dims, {outer_strides.data()}, begin / n_indices);
+        int64_t j = begin % n_indices;
+        std::byte* dst = out_data + begin * block_bytes;
+        for (int64_t block = begin; block < end; ++block, dst += block_bytes) {
+            const std::byte* block_src = src_data + outer_it.offset(0)
+                                         + idx[static_cast<size_t>(j)] * axis_stride;
+            if (!is_block_contiguous) {
+                detail::copyStrided(inner_shape.data(),
+                                    inner_dims,
+                                    block_src,
+                                    inner_src_strides.data(),
+                                    dst,
+                                    inner_dst_strides.data(),
+                                    element_size);
+            } else if (fixed_copy != nullptr) {
+                fixed_copy(dst, block_src);
+            } else {
+                std::memcpy(dst, block_src, static_cast<size_t>(block_bytes));
+            }
+            if (++j == n_indices) {
+                j = 0;
+                outer_it.next();
+            }
+        }
+    });
+    return out;
+}
+
+Tensor indexSelect(const Tensor& src, int64_t axis, const Tensor& indices) {
+    if (indices.dims() != 1) {
+        throw std::length_error("Index select expects 1-D indices, got "
+                                + std::to_string(indices.dims()) + "-D");
+    }
+    return take(src, indices, axis);
+}
+
+void scatterAdd(Tensor& out, int64_t axis, const Tensor& index, const Tensor& src) {
+    if (out.dtype() != src.dtype()) {
+        throw TypesMismatchError("Scatter add source and destination data types are "
+                                 "different");
+    }
+    if (index.shape() != src.shape()) {
+        throw std::length_error("Scatter add index and source shapes are different");
+    }
+    if (out.dims() != src.dims()) {
+        throw std::length_error("Scatter add source and destination have different "
+                                "number of dimensions");
+    }
+    const auto dims = static_cast<int64_t>(out.dims());
+    axis = normalizeAxis(axis, dims);
+    const auto axis_idx = static_cast<size_t>(axis);
+    for (size_t dim = 0; dim < out.dims(); ++dim) {
+        if (dim != axis_idx && index.dim(dim) > out.dim(dim)) {
+            throw std::length_error("Scatter add index extent exceeds destination "
+                                    "extent in dimension "
+                                    + std::to_string(dim));
+        }
+    }
+    const auto kernel = detail::dispatchArithmeticDataType(out.dtype(), [](auto tag) {
+        return &detail::scatterAddKernel<typename decltype(tag)::type>;
+    });
+    const int64_t out_axis_size = out.dim(axis_idx);
+    const std::vector<int64_t> idx = detail::normalizedIndices(index, out_axis_size);
+    if (idx.empty()) {
+        return;
+    }
+
+    // Columns are all positions with fixed coordinates except the axis one
+    const std::vector<int64_t> idx_strides = createContiguousStrides(index.shape(), 1);
+    std::vector<int64_t> column_shape;
+    std::array<std::vector<int64_t>, 3> column_strides;
+    for (size_t dim = 0; dim < out.dims(); ++dim) {
+        if (dim == axis_idx) {
+            continue;
+        }
+        column_shape.push_back(index.dim(dim));
+        column_strides[0].push_back(src.strides()[dim]);
+        column_strides[1].push_back(out.strides()[dim]);
+        column_strides[2].push_back(idx_strides[dim]);
+    }
+
+    detail::ScatterAddArgs args;
+    args.column_shape = column_shape.data();
+    args.column_dims = static_cast<int64_t>(column_shape.size());
+    args.column_strides = {
+        column_strides[0].data(), column_strides[1].data(), column_strides[2].data()};
+    args.n_columns = std::accumulate(
+        column_shape.begin(), column_shape.end(), int64_t{1}, std::multiplies<>{});
+    args.column_size = index.dim(axis_idx);
+    args.src = src.data();
+    args.src_axis_stride = src.strides()[axis_idx];
+    args.out = out.data();
+    args.out_axis_stride = out.strides()[axis_idx];
+    args.out_axis_size = out_axis_size;
+    args.idx = idx.data();
+    args.idx_axis_stride = idx_strides[axis_idx];
+    kernel(args);
+}
+
+Tensor maskedSelect(const Tensor& src, const Tensor& mask) {
+    if (mask.dtype() != TensorDataType::Bool && mask.dtype() != TensorDataType::UInt8) {
+        throw TypesMismatchError("Mask data type should be Bool or UInt8, got: "
+                                 + to_string(mask.dtype()));
+    }
+    if (mask.shape() != src.shape()) {
+        throw std::length_error("Source and mask shapes are different");
+    }
+    const Tensor contiguous_src = src.contiguous();
+    const Tensor contiguous_mask = mask.contiguous();
+    const int64_t n = src.numel();
+    const int64_t n_chunks = parallelChunksCount(n, detail::kMaskGrainElements);
+    if (n_chunks == 0) {
+        return Tensor({0}, src.dtype());
+    }
+    const int64_t chunk_size = (n + n_chunks - 1) / n_chunks;
+    const auto* mask_data = contiguous_mask.unsafeData<uint8_t>();
+    const auto chunk_length = [&](int64_t chunk) {
+        return std::min(chunk_size, n - chunk * chunk_size);
+    };
+
+    // Pass 1: count selected elements per chunk
+    std::vector<int64_t> counts(static_cast<size_t>(n_chunks));
+    parallelFor(0, n_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; ++chunk) {
+            counts[static_cast<size_t>(chunk)] = detail::countNonZero(
+                mask_data + chunk * chunk_size, chunk_length(chunk));
+        }
+    });
+    std::vector<int64_t> offsets(counts.size());
+    std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), int64_t{0});
+
+    // Pass 2: each chunk compresses its elements at the known offset
+    Tensor out({offsets.back() + counts.back()}, src.dtype());
+    const int64_t element_size = src.dtype().ssize();
+    const std::byte* src_data = contiguous_src.data();
+    std::byte* out_data = out.data();
+    parallelFor(0, n_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; ++chunk) {
+            const auto i = static_cast<size_t>(chunk);
+            detail::compressChunk(src_data + chunk * chunk_size * element_size,
+                                  mask_data + chunk * chunk_size,
+                                  chunk_length(chunk),
+                                  out_data + offsets[i] * element_size,
+                                  counts[i],
+                                  element_size);
+        }
+    });
+    return out;
+}
+} // namespace nope
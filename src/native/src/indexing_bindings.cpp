@@ -0,0 +1,50 @@
+#include "indexing_bindings.h"
+
+#include "nope/indexing.h"
+#include "nope/tensor.h"
+
+namespace py = pybind11;
+
+namespace nope {
+void registerIndexingBindings(py::module_& module) {
+    module.def(
+        "take",
+        [](const Tensor& src, const Tensor& indices, int64_t axis) {
+            py::gil_scoped_release release;
+            return take(src, indices, axis);
+        },
+        py::arg("tensor"),
+        py::arg("indices"),
+        py::arg("axis") = 0);
+    module.def(
+        "index_select",
+        [](const Tensor& src, int64_t axis, const Tensor& indices) {
+            py::gil_scoped_release release;
+            return indexSelect(src, axis, indices);
+        },
+        py::arg("tensor"),
+        py::arg("axis"),
+        py::arg("indices"));
+    module.def(
+        "scatter_add",
+        [](Tensor& out, int64_t axis, const Tensor& index, const Tensor& src) {
+            {
+                py::gil_scoped_release release;
+                scatterAdd(out, axis, index, src);
+            }
+            return out;
+        },
+        py::arg("out"),
+        py::arg("axis"),
+        py::arg("index"),
+        py::arg("src"));
+    module.def(
+        "masked_select",
+        [](const Tensor& src, const Tensor& mask) {
+            py::gil_scoped_release release;
+            return maskedSelect(src, mask);
+        },
+        py::arg("tensor"),
+        py::arg("mask"));
+}
+} // namespace nope
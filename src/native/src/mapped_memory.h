@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace nope {
+namespace detail {
+struct MappedBlock {
+    void* ptr{nullptr};
+    size_t size{0};
+};
+
+/**
+ * \brief Threshold of the current allocation policy, cheap to read on every
+ * allocation.
+ */
+size_t hugePagesThreshold() noexcept;
+
+/**
+ * \brief Maps anonymous memory block of at least \a size bytes following the
+ * current allocation policy: huge page alignment and advice, NUMA placement
+ * and parallel first touch.
+ *
+ * \return Mapped block or empty block if memory mapping is not supported by
+ *      the platform.
+ *
+ * \throw std::bad_alloc if mapping fails.
+ */
+MappedBlock mapLargeBlock(size_t size);
+
+void unmapBlock(const MappedBlock& block) noexcept;
+} // namespace detail
+} // namespace nope
@@ -0,0 +1,767 @@
+#include "nope/math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "cpu_features.h"
+#include "elementwise_loop.h"
+#include "math_kernels.h"
+#include "type_dispatch.h"
+
+#if NOPE_X86_DISPATCH
+    #include <immintrin.h>
+#endif
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kMathGrainElements = 16 * 1024;
+/// Elements of strided runs gathered into a contiguous buffer at once
+constexpr int64_t kMathBlockElements = 256;
+
+/**
+ * \brief Constants of the approximations. Polynomial coefficients are
+ * Chebyshev interpolants of the approximated functions computed in quadruple
+ * precision and rounded to \a T.
+ *
+ * - kExpm1: \code (exp(r) - 1 - r) / r^2 \endcode for |r| <= ln(2) / 2.
+ * - kLog: \code (log((1 + s) / (1 - s)) - 2 s) / s^3 \endcode of z = s^2 for
+ *   |s| <= (sqrt(2) - 1) / (sqrt(2) + 1).
+ * - kErfSmall: \code erf(x) / x - 1 \endcode of z = x^2 for |x| <= 1.
+ * - kErfcx: \code exp(x^2) * erfc(x) \endcode for x in [1/2, kErfcxMax] split
+ *   into intervals starting at kErfcxBounds, polynomials of x - kErfcxCenters.
+ */
+template <class T>
+struct MathCoefficients;
+
+template <>
+struct MathCoefficients<float> {
+    static constexpr float kLog2e = 1.44269504f;
+    // ln(2) split so that n * kLn2Hi is exact for |n| < 2^9
+    static constexpr float kLn2Hi = 6.93145752e-01f;
+    static constexpr float kLn2Lo = 1.42860677e-06f;
+    // Exponents rounding to zero and infinity
+    static constexpr float kExpMin = -104.0f;
+    static constexpr float kExpMax = 89.0f;
+    static constexpr float kSubnormalScale = 16777216.0f;
+    static constexpr float kSubnormalScaleLog2 = 24.0f;
+    // tanh(x) rounds to 1 above
+    static constexpr float kTanhMax = 10.0f;
+    static constexpr float kErfcxMax = 10.5f;
+    static constexpr float kExpm1[] = {
+        0.5f, 0.166666672f, 0.0416664667f, 0.00833331048f, 0.00139336474f,
+        0.000198909882f};
+    static constexpr float kLog[] = {
+        0.666666687f, 0.400001228f, 0.285508156f, 0.233305737f};
+    static constexpr float kErfSmall[] = {
+        0.128379166f, -0.376126379f, 0.112837821f, -0.0268654302f, 0.00522103161f,
+        -0.000848408032f, 0.000112659589f, -9.66704465e-06f};
+    static constexpr float kErfcxBounds[] = {
+        0.5f, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f, 5.5f, 7.0f};
+    static constexpr float kErfcxCenters[] = {
+        0.75f, 1.25f, 1.75f, 2.5f, 3.5f, 4.75f, 6.25f, 8.75f};
+    static constexpr float kErfcx[][8] = {
+        {0.506937623f, 0.367822915f, 0.284972221f, 0.21080637f, 0.155293658f,
+         0.116302706f, 0.0891566351f, 0.0640657172f},
+        {-0.367972702f, -0.208821878f, -0.130976349f, -0.074347347f, -0.0413235761f,
+         -0.0235034488f, -0.0139212701f, -0.00722914422f},
+        {0.230958134f, 0.106795572f, 0.0557636283f, 0.0249379966f, 0.0106611336f,
+         0.0046613263f, 0.00214869576f, 0.000810697209f},
+        {-0.129836172f, -0.0502182916f, -0.0222599991f, -0.00800160132f, -0.0026730774f,
+         -0.000908101967f, -0.00032794752f, -9.03648761e-05f},
+        {0.0667905807f, 0.0220113713f, 0.00840432011f, 0.00246704509f, 0.000652686984f,
+         0.000173928842f, 4.95128006e-05f, 1.00123043e-05f},
+        {-0.0318909734f, -0.00908053946f, -0.00302074966f, -0.00073313195f,
+         -0.000155425587f, -3.27561211e-05f, -7.39517918e-06f, -1.10022381e-06f},
+        {0.0142868785f, 0.00355274929f, 0.00103913737f, 0.00021090181f, 3.61724124e-05f,
+         6.0776697e-06f, 1.0935762e-06f, 1.20497944e-07f},
+        {-0.00618515164f, -0.0013489296f, -0.000348319038f, -6.12981748e-05f,
+         -8.46785133e-06f, -1.15779687e-06f, -1.64445638e-07f, -1.42667433e-08f},
+        {0.00248696259f, 0.000481643307f, 0.000110934699f, 1.65867114e-05f,
+         1.88649142e-06f, 2.08393928e-07f, 2.38334934e-08f, 1.54354007e-09f}};
+};
+
+template <>
+struct MathCoefficients<double> {
+    static constexpr double kLog2e = 1.4426950408889634;
+    static constexpr double kLn2Hi = 6.93147180369123816490e-01;
+    static constexpr double kLn2Lo = 1.90821492927058770002e-10;
+    static constexpr double kExpMin = -746.0;
+    static constexpr double kExpMax = 710.0;
+    static constexpr double kSubnormalScale = 18014398509481984.0;
+    static constexpr double kSubnormalScaleLog2 = 54.0;
+    static constexpr double kTanhMax = 20.0;
+    static constexpr double kErfcxMax = 27.5;
+    static constexpr double kExpm1[] = {
+        0.5, 0.16666666666666671, 0.041666666666666671, 0.0083333333333261358,
+        0.001388888888888375, 0.00019841269874815834, 2.4801587325544321e-05,
+        2.7557255406285044e-06, 2.7557273647451087e-07, 2.5105214474751413e-08,
+        2.0914685161418067e-09};
+    static constexpr double kLog[] = {
+        0.66666666666666663, 0.40000000000000879, 0.28571428570803253,
+        0.22222222391794727, 0.18181795631498243, 0.15386240172447838,
+        0.13268760562036724, 0.13086757666952073};
+    static constexpr double kErfSmall[] = {
+        0.12837916709551259, -0.37612638903183754, 0.11283791670955126,
+        -0.026866170645131218, 0.0052239776254416736, -0.0008548327023403001,
+        0.00012055332978879483, -1.4925650236967501e-05, 1.6462110782018636e-06,
+        -1.6365768648832071e-07, 1.4806027146128752e-08, -1.2277734486795522e-09,
+        9.3237235181530155e-11, -6.1967364287876666e-12, 2.8067128195610805e-13};
+    static constexpr double kErfcxBounds[] = {
+        0.5, 1.0, 1.5, 2.0, 3.0, 4.0, 6.0, 9.0, 13.0, 19.0};
+    static constexpr double kErfcxCenters[] = {
+        0.75, 1.25, 1.75, 2.5, 3.5, 5.0, 7.5, 11.0, 16.0, 23.25};
+    static constexpr double kErfcx[][10] = {
+        {0.50693765029314486, 0.36782291645236109, 0.28497223473743638,
+         0.21080636406114359, 0.1552936556088943, 0.11070463773306863,
+         0.074573693062876686, 0.051080594758088446, 0.035193377824930837,
+         0.02424383530389913},
+        {-0.36797269165579538, -0.20882187596460985, -0.1309763455144852,
+         -0.074347346789794669, -0.041323577833252495, -0.021332789764826311,
+         -0.0097737711523623282, -0.0046060824175668119, -0.0021910766977257718,
+         -0.0010408254642029686},
+        {0.2309581315512983, 0.1067955714965988, 0.055763630087087269,
+         0.024937997086656904, 0.010661133192510575, 0.0040406889089370729,
+         0.001270409420159214, 0.00041368816485350823, 0.00013615066131848888,
+         4.464326118011028e-05},
+        {-0.1298360619948811, -0.050218274395907571, -0.022259995241388327,
+         -0.0080015693821016073, -0.0026730744396436528, -0.00075289681342728839,
+         -0.00016380033411213458, -3.7008402785477913e-05, -8.4440777532962475e-06,
+         -1.9130945102684605e-06},
+        {0.066790542527568733, 0.022011364250857167, 0.0084043192073288472,
+         0.002467036815701464, 0.00065268632687889567, 0.00013810242090037911,
+         2.0953457159136973e-05, 3.2978671066283647e-06, 5.2270863287542873e-07,
+         8.1906908184410154e-08},
+        {-0.031897262039681823, -0.0090816276329344445, -0.0030209746514251374,
+         -0.00073359093713920424, -0.0001554689182270078, -2.4953883570293807e-05,
+         -2.6597621675503626e-06, -2.9274584503865169e-07, -3.2295850921926567e-08,
+         -3.5035579935287361e-09},
+        {0.014289198665935013, 0.0035531099032296452, 0.0010392045224449471,
+         0.00021101982428362457, 3.6181704361437534e-05, 4.4443343489815948e-06,
+         3.3508030067796875e-07, 2.5887603727318203e-08, 1.9916727071032142e-09,
+         1.4972827821797888e-10},
+        {-0.0060515322972083474, -0.0013257829296849323, -0.00034353335347041898,
+         -5.8868964693528469e-05, -8.2379865605426552e-06, -7.8063194907915253e-07,
+         -4.1902831777545955e-08, -2.2806297024814601e-09, -1.2259645445916349e-10,
+         -6.3930066602724803e-12},
+        {0.0024376373608209199, 0.00047397031028563431, 0.00010950528846836237,
+         1.5961853155153158e-05, 1.8371878502673794e-06, 1.3529365427065687e-07,
+         5.2022659494711433e-09, 2.0016925912588467e-10, 7.5323595679373718e-12,
+         2.727183619284614e-13},
+        {-0.00093851206149370018, -0.00016296000929765523, -3.375535525600354e-05,
+         -4.2142959704294711e-06, -4.0173979694779905e-07, -2.3147488178706504e-08,
+         -6.412977872203179e-10, -1.750399000922142e-11, -4.6193589028866929e-13,
+         -1.1623381339984039e-14},
+        {0.00034675065999351383, 5.405405951244389e-05, 1.0086683334012006e-05,
+         1.0852224411274067e-06, 8.6219707764247239e-08, 3.9112329152598412e-09,
+         7.8506042378173701e-11, 1.52506720762871e-12, 2.8276862466157773e-14,
+         4.9494590742256545e-16},
+        {-0.00012335437449096325, -1.7344078966383568e-05, -2.9279380654034908e-06,
+         -2.7295256638891344e-07, -1.8176509051328069e-08, -6.5295763379192164e-10,
+         -9.5452199480650181e-12, -1.323956029510064e-13, -1.727786479668021e-15,
+         -2.1057016031313926e-17},
+        {4.2372559877675011e-05, 5.3956661158936628e-06, 8.2713249798943435e-07,
+         6.7141561007556674e-08, 3.7670177344958822e-09, 1.0775737192811558e-10,
+         1.1531679373051279e-12, 1.1455398465691128e-14, 1.0541798237943695e-16,
+         8.9535300333703811e-19},
+        {-1.4088486441332037e-05, -1.6306944557108858e-06, -2.2776276967045801e-07,
+         -1.6169857267701318e-08, -7.6801358473215164e-10, -1.7579908040383889e-11,
+         -1.3835953225272202e-13, -9.8742114880696618e-16, -6.4179595587500282e-18,
+         -3.8023988499434245e-20},
+        {4.5424755919175698e-06, 4.7951933318132091e-07, 6.1212471847213875e-08,
+         3.8112004954229917e-09, 1.5401966275062409e-10, 2.8204188396422475e-12,
+         1.6340796412621236e-14, 8.4129930071252825e-17, 3.8588826984112708e-19,
+         1.5968573222359098e-21},
+        {-1.4237320376080126e-06, -1.3746551162976253e-07, -1.6081364049194225e-08,
+         -8.8256934764053356e-10, -3.0448457262958633e-11, -4.5036575463095854e-13,
+         -1.9361482259387737e-15, -7.2022041501790478e-18, -2.3411049239947171e-20,
+         -6.7697967040505491e-23},
+        {4.4514441296068448e-07, 3.926893070055637e-08, 4.2073372335279265e-09,
+         2.1233964339146381e-10, 6.1850646860170839e-12, 7.9835315838853616e-14,
+         2.6427022868119315e-16, 7.0580623794967307e-19, 1.6632141143254896e-21,
+         3.3551834383758098e-24},
+        {-1.3223499032886487e-07, -1.0727619696381544e-08, -1.0586398406852884e-09,
+         -4.7346320145296593e-11, -1.1868743961769625e-12, -1.2459867609778504e-14,
+         -3.0869280146761165e-17, -5.9951519569638746e-20, -1.0048509094626141e-22,
+         -1.4194802700396385e-25}};
+};
+
+template <class T>
+constexpr T kSqrt2 = static_cast<T>(1.41421356237309504880);
+
+template <class T>
+constexpr T kSqrtHalf = static_cast<T>(0.70710678118654752440);
+
+/// Gelu of smaller inputs underflows to zero
+template <class T>
+constexpr T kGeluMin = -MathCoefficients<T>::kErfcxMax * kSqrt2<T>;
+
+template <class T, MathOp Op>
+T evaluateScalar(T x) noexcept {
+    if constexpr (Op == MathOp::Exp) {
+        return std::exp(x);
+    } else if constexpr (Op == MathOp::Log) {
+        return std::log(x);
+    } else if constexpr (Op == MathOp::Tanh) {
+        return std::tanh(x);
+    } else if constexpr (Op == MathOp::Sigmoid) {
+        const T e = std::exp(-std::abs(x));
+        const T q = 1 / (1 + e);
+        return x < 0 ? e * q : q;
+    } else if constexpr (Op == MathOp::Erf) {
+        return std::erf(x);
+    } else {
+        static_assert(Op == MathOp::Gelu);
+        return x < kGeluMin<T> ? -T{0} : x * std::erfc(-x * kSqrtHalf<T>) / 2;
+    }
+}
+
+template <class T, MathOp Op>
+void mathScalar(const T* src, T* dst, int64_t n) {
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = evaluateScalar<T, Op>(src[i]);
+    }
+}
+
+#if NOPE_X86_DISPATCH
+/**
+ * \brief AVX2 vector of \a T with operations used by the approximations.
+ * Arithmetic operators come from GCC vector extensions.
+ */
+template <class T>
+struct Avx2Math;
+
+template <>
+struct Avx2Math<float> {
+    using Vec = __m256;
+    static constexpr int64_t kLanes = 8;
+
+    NOPE_TARGET_AVX2 static Vec load(const float* src) noexcept {
+        return _mm256_loadu_ps(src);
+    }
+
+    NOPE_TARGET_AVX2 static void store(float* dst, Vec v) noexcept {
+        _mm256_storeu_ps(dst, v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec set1(float value) noexcept {
+        return _mm256_set1_ps(value);
+    }
+
+    NOPE_TARGET_AVX2 static Vec fma(Vec a, Vec b, Vec c) noexcept {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    /// a * b - c with a single rounding
+    NOPE_TARGET_AVX2 static Vec fms(Vec a, Vec b, Vec c) noexcept {
+        return _mm256_fmsub_ps(a, b, c);
+    }
+
+    NOPE_TARGET_AVX2 static Vec round(Vec v) noexcept {
+        return _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    NOPE_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_min_ps(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_max_ps(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec abs(Vec v) noexcept {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec signBit(Vec v) noexcept {
+        return _mm256_and_ps(_mm256_set1_ps(-0.0f), v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec bitOr(Vec a, Vec b) noexcept {
+        return _mm256_or_ps(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec bitAnd(Vec a, Vec b) noexcept {
+        return _mm256_and_ps(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec less(Vec a, Vec b) noexcept {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec greater(Vec a, Vec b) noexcept {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec greaterEqual(Vec a, Vec b) noexcept {
+        return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec equal(Vec a, Vec b) noexcept {
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec isNan(Vec v) noexcept {
+        return _mm256_cmp_ps(v, v, _CMP_UNORD_Q);
+    }
+
+    /// Lanes of \a a where \a mask is set, lanes of \a b otherwise
+    NOPE_TARGET_AVX2 static Vec select(Vec mask, Vec a, Vec b) noexcept {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+
+    NOPE_TARGET_AVX2 static bool any(Vec mask) noexcept {
+        return _mm256_movemask_ps(mask) != 0;
+    }
+
+    /// 2^n for integral n in [-126, 127]
+    NOPE_TARGET_AVX2 static Vec pow2(Vec n) noexcept {
+        const __m256i biased =
+            _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+    }
+
+    /// Exponent of positive normal \a x, \a mantissa is set to [1, 2) part
+    NOPE_TARGET_AVX2 static Vec exponent(Vec x, Vec& mantissa) noexcept {
+        const __m256i bits = _mm256_castps_si256(x);
+        mantissa = _mm256_castsi256_ps(
+            _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                            _mm256_set1_epi32(0x3f800000)));
+        return _mm256_cvtepi32_ps(
+            _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+    }
+
+    /// Elements of \a table at integral indices. Masked gather with all lanes
+    /// selected avoids GCC false positive uninitialized warning.
+    NOPE_TARGET_AVX2 static Vec gather(const float* table, Vec index) noexcept {
+        const Vec all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        return _mm256_mask_i32gather_ps(
+            _mm256_setzero_ps(), table, _mm256_cvttps_epi32(index), all, 4);
+    }
+};
+
+template <>
+struct Avx2Math<double> {
+    using Vec = __m256d;
+    static constexpr int64_t kLanes = 4;
+
+    NOPE_TARGET_AVX2 static Vec load(const double* src) noexcept {
+        return _mm256_loadu_pd(src);
+    }
+
+    NOPE_TARGET_AVX2 static void store(double* dst, Vec v) noexcept {
+        _mm256_storeu_pd(dst, v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec set1(double value) noexcept {
+        return _mm256_set1_pd(value);
+    }
+
+    NOPE_TARGET_AVX2 static Vec fma(Vec a, Vec b, Vec c) noexcept {
+        return _mm256_fmadd_pd(a, b, c);
+    }
+
+    NOPE_TARGET_AVX2 static Vec fms(Vec a, Vec b, Vec c) noexcept {
+        return _mm256_fmsub_pd(a, b, c);
+    }
+
+    NOPE_TARGET_AVX2 static Vec round(Vec v) noexcept {
+        return _mm256_round_pd(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    }
+
+    NOPE_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_min_pd(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_max_pd(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec abs(Vec v) noexcept {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec signBit(Vec v) noexcept {
+        return _mm256_and_pd(_mm256_set1_pd(-0.0), v);
+    }
+
+    NOPE_TARGET_AVX2 static Vec bitOr(Vec a, Vec b) noexcept {
+        return _mm256_or_pd(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec bitAnd(Vec a, Vec b) noexcept {
+        return _mm256_and_pd(a, b);
+    }
+
+    NOPE_TARGET_AVX2 static Vec less(Vec a, Vec b) noexcept {
+        return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec greater(Vec a, Vec b) noexcept {
+        return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec greaterEqual(Vec a, Vec b) noexcept {
+        return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec equal(Vec a, Vec b) noexcept {
+        return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);
+    }
+
+    NOPE_TARGET_AVX2 static Vec isNan(Vec v) noexcept {
+        return _mm256_cmp_pd(v, v, _CMP_UNORD_Q);
+    }
+
+    NOPE_TARGET_AVX2 static Vec select(Vec mask, Vec a, Vec b) noexcept {
+        return _mm256_blendv_pd(b, a, mask);
+    }
+
+    NOPE_TARGET_AVX2 static bool any(Vec mask) noexcept {
+        return _mm256_movemask_pd(mask) != 0;
+    }
+
+    /// 2^n for integral n in [-1022, 1023]. Adding 1.5 * 2^52 moves n into
+    /// the low mantissa bits, AVX2 has no 64-bit integer conversion.
+    NOPE_TARGET_AVX2 static Vec pow2(Vec n) noexcept {
+        const __m256i bits = _mm256_castpd_si256(n + 0x1.8p52);
+        const __m256i biased = _mm256_add_epi64(bits, _mm256_set1_epi64x(1023));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+    }
+
+    NOPE_TARGET_AVX2 static Vec exponent(Vec x, Vec& mantissa) noexcept {
+        const __m256i bits = _mm256_castpd_si256(x);
+        mantissa = _mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffff)),
+            _mm256_set1_epi64x(0x3ff0000000000000)));
+        // Biased exponent placed into the mantissa of 2^52
+        const __m256i biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                               _mm256_set1_epi64x(0x4330000000000000));
+        return _mm256_castsi256_pd(biased) - (0x1p52 + 1023.0);
+    }
+
+    NOPE_TARGET_AVX2 static Vec gather(const double* table, Vec index) noexcept {
+        const Vec all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        return _mm256_mask_i32gather_pd(
+            _mm256_setzero_pd(), table, _mm256_cvttpd_epi32(index), all, 8);
+    }
+};
+
+template <class T>
+using Avx2Vec = typename Avx2Math<T>::Vec;
+
+template <class T, size_t N>
+NOPE_TARGET_AVX2 Avx2Vec<T> polynomialAvx2(const T (&coefficients)[N], Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    Avx2Vec<T> acc = S::set1(coefficients[N - 1]);
+    for (size_t i = N - 1; i > 0; --i) {
+        acc = S::fma(acc, x, S::set1(coefficients[i - 1]));
+    }
+    return acc;
+}
+
+/**
+ * \brief expm1 of the reduced argument r = x - n * ln(2), |r| <= ln(2) / 2.
+ */
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> expm1ReducedAvx2(Avx2Vec<T> x, Avx2Vec<T>& n) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    n = S::round(x * C::kLog2e);
+    Avx2Vec<T> r = S::fma(n, S::set1(-C::kLn2Hi), x);
+    r = S::fma(n, S::set1(-C::kLn2Lo), r);
+    return S::fma(r * r, polynomialAvx2(C::kExpm1, r), r);
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> expAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    x = S::min(S::max(x, S::set1(C::kExpMin)), S::set1(C::kExpMax));
+    Avx2Vec<T> n;
+    const Avx2Vec<T> p = expm1ReducedAvx2<T>(x, n);
+    // 2^n is split into two factors, so the first product is exact and the
+    // second one overflows or underflows to subnormals with a single rounding
+    const Avx2Vec<T> n1 = S::round(n * T{0.5});
+    return (p + T{1}) * S::pow2(n1) * S::pow2(n - n1);
+}
+
+/**
+ * \brief exp(-a * b) with the product rounding error compensated.
+ */
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> expOfNegatedProductAvx2(Avx2Vec<T> a, Avx2Vec<T> b) {
+    using S = Avx2Math<T>;
+    const Avx2Vec<T> hi = a * b;
+    const Avx2Vec<T> lo = S::fms(a, b, hi);
+    const Avx2Vec<T> e = expAvx2<T>(-hi);
+    return S::fma(-lo, e, e);
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> logAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    const Avx2Vec<T> subnormal = S::less(x, S::set1(std::numeric_limits<T>::min()));
+    Avx2Vec<T> m;
+    Avx2Vec<T> e = S::exponent(S::select(subnormal, x * C::kSubnormalScale, x), m);
+    e = e - S::bitAnd(subnormal, S::set1(C::kSubnormalScaleLog2));
+    // m in [sqrt(2) / 2, sqrt(2))
+    const Avx2Vec<T> large = S::greater(m, S::set1(kSqrt2<T>));
+    m = S::select(large, m * T{0.5}, m);
+    e = e + S::bitAnd(large, S::set1(1));
+    // log(1 + f) = f - f^2 / 2 + s * (f^2 / 2 + R), s = f / (2 + f)
+    const Avx2Vec<T> f = m - T{1};
+    const Avx2Vec<T> s = f / (f + T{2});
+    const Avx2Vec<T> z = s * s;
+    const Avx2Vec<T> r = z * polynomialAvx2(C::kLog, z);
+    const Avx2Vec<T> half_f2 = T{0.5} * f * f;
+    const Avx2Vec<T> t = half_f2 - S::fma(s, half_f2 + r, e * C::kLn2Lo);
+    Avx2Vec<T> result = S::fma(e, S::set1(C::kLn2Hi), f - t);
+
+    const T inf = std::numeric_limits<T>::infinity();
+    result = S::select(S::less(x, S::set1(0)),
+                       S::set1(std::numeric_limits<T>::quiet_NaN()),
+                       result);
+    result = S::select(S::equal(x, S::set1(0)), S::set1(-inf), result);
+    return S::select(S::equal(x, S::set1(inf)), x, result);
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> tanhAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    // tanh(|x|) = -expm1(-2|x|) / (2 + expm1(-2|x|))
+    const Avx2Vec<T> a = S::min(S::abs(x), S::set1(C::kTanhMax));
+    Avx2Vec<T> n;
+    const Avx2Vec<T> p = expm1ReducedAvx2<T>(a * T{-2}, n);
+    // expm1(t) = 2^n * expm1(r) + 2^n - 1
+    const Avx2Vec<T> scale = S::pow2(n);
+    const Avx2Vec<T> em1 = S::fma(scale, p, scale - T{1});
+    return S::bitOr(S::abs(em1 / (em1 + T{2})), S::signBit(x));
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> sigmoidAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    // exp(-|x|) doesn't overflow and keeps precision of tiny results
+    const Avx2Vec<T> e = expAvx2<T>(-S::abs(x));
+    const Avx2Vec<T> q = T{1} / (e + T{1});
+    return S::select(S::less(x, S::set1(0)), e * q, q);
+}
+
+/**
+ * \brief exp(x^2) * erfc(x) for x in [1/2, kErfcxMax].
+ */
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> erfcxAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    Avx2Vec<T> index = S::set1(0);
+    for (size_t i = 1; i < std::size(C::kErfcxBounds); ++i) {
+        const Avx2Vec<T> above = S::greaterEqual(x, S::set1(C::kErfcxBounds[i]));
+        index = index + S::bitAnd(above, S::set1(1));
+    }
+    const Avx2Vec<T> s = x - S::gather(C::kErfcxCenters, index);
+    constexpr size_t kDegree = std::size(C::kErfcx) - 1;
+    Avx2Vec<T> acc = S::gather(C::kErfcx[kDegree], index);
+    for (size_t i = kDegree; i > 0; --i) {
+        acc = S::fma(acc, s, S::gather(C::kErfcx[i - 1], index));
+    }
+    return acc;
+}
+
+/**
+ * \brief erf(z) for |z| < 1.
+ */
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> erfSmallAvx2(Avx2Vec<T> z) {
+    using S = Avx2Math<T>;
+    return S::fma(z, polynomialAvx2(MathCoefficients<T>::kErfSmall, z * z), z);
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> erfAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    const Avx2Vec<T> z = S::abs(x);
+    Avx2Vec<T> result = erfSmallAvx2<T>(z);
+    const Avx2Vec<T> tail = S::greaterEqual(z, S::set1(1));
+    if (S::any(tail)) {
+        const Avx2Vec<T> clamped = S::min(z, S::set1(C::kErfcxMax));
+        const Avx2Vec<T> erfc =
+            expOfNegatedProductAvx2<T>(clamped, clamped) * erfcxAvx2<T>(clamped);
+        result = S::select(tail, T{1} - erfc, result);
+    }
+    return S::bitOr(result, S::signBit(x));
+}
+
+template <class T>
+NOPE_TARGET_AVX2 Avx2Vec<T> geluAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    using C = MathCoefficients<T>;
+    // Normal CDF is (1 + erf(x / sqrt(2))) / 2 near zero and erfc(-x / sqrt(2)) / 2
+    // in the tails, so there is no cancellation for negative x
+    const Avx2Vec<T> z = S::abs(x) * kSqrtHalf<T>;
+    const Avx2Vec<T> erf = S::bitOr(erfSmallAvx2<T>(z), S::signBit(x));
+    Avx2Vec<T> result = x * S::fma(erf, S::set1(0.5), S::set1(0.5));
+    // 1 + erf(x / sqrt(2)) loses precision closer to zero for negative x
+    const Avx2Vec<T> negative = S::less(x, S::set1(0));
+    const Avx2Vec<T> tail =
+        S::greaterEqual(z, S::select(negative, S::set1(0.5), S::set1(1)));
+    if (S::any(tail)) {
+        // exp(-x^2 / 2) is evaluated from x, as z is rounded
+        const Avx2Vec<T> a = S::min(S::abs(x), S::set1(-kGeluMin<T>));
+        const Avx2Vec<T> e = expOfNegatedProductAvx2<T>(a, a * T{0.5});
+        const Avx2Vec<T> half_erfcx =
+            erfcxAvx2<T>(S::min(z, S::set1(C::kErfcxMax))) * T{0.5};
+        // Tiny exponent is applied last, so the lower tail doesn't lose
+        // precision in subnormal intermediate results
+        const Avx2Vec<T> lower = x * half_erfcx * e;
+        const Avx2Vec<T> upper = x * S::fma(-half_erfcx, e, S::set1(1));
+        result = S::select(tail, S::select(negative, lower, upper), result);
+    }
+    return S::select(S::less(x, S::set1(kGeluMin<T>)), S::set1(-0.0), result);
+}
+
+template <class T, MathOp Op>
+NOPE_TARGET_AVX2 Avx2Vec<T> evaluateAvx2(Avx2Vec<T> x) {
+    using S = Avx2Math<T>;
+    Avx2Vec<T> result;
+    if constexpr (Op == MathOp::Exp) {
+        result = expAvx2<T>(x);
+    } else if constexpr (Op == MathOp::Log) {
+        result = logAvx2<T>(x);
+    } else if constexpr (Op == MathOp::Tanh) {
+        result = tanhAvx2<T>(x);
+    } else if constexpr (Op == MathOp::Sigmoid) {
+        result = sigmoidAvx2<T>(x);
+    } else if constexpr (Op == MathOp::Erf) {
+        result = erfAvx2<T>(x);
+    } else {
+        static_assert(Op == MathOp::Gelu);
+        result = geluAvx2<T>(x);
+    }
+    // Clamping of arguments discards NaNs
+    return S::select(S::isNan(x), x, result);
+}
+
+template <class T, MathOp Op>
+NOPE_TARGET_AVX2 void mathAvx2(const T* src, T* dst, int64_t n) {
+    using S = Avx2Math<T>;
+    const int64_t vector_end = n - n % S::kLanes;
+    int64_t i = 0;
+    for (; i < vector_end; i += S::kLanes) {
+        S::store(dst + i, evaluateAvx2<T, Op>(S::load(src + i)));
+    }
+    if (i < n) {
+        // Tail goes through the same approximation as the rest of elements
+        T buffer[S::kLanes] = {};
+        std::copy(src + i, src + n, buffer);
+        S::store(buffer, evaluateAvx2<T, Op>(S::load(buffer)));
+        std::copy(buffer, buffer + (n - i), dst + i);
+    }
+}
+#endif
+
+template <class T, MathOp Op>
+MathKernel<T> selectMathKernel() noexcept {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return &mathAvx2<T, Op>;
+    }
+#endif
+    return &mathScalar<T, Op>;
+}
+} // namespace
+
+template <class T>
+MathKernel<T> selectMathKernel(MathOp op) {
+    switch (op) {
+        case MathOp::Exp:
+            return selectMathKernel<T, MathOp::Exp>();
+        case MathOp::Log:
+            return selectMathKernel<T, MathOp::Log>();
+        case MathOp::Tanh:
+            return selectMathKernel<T, MathOp::Tanh>();
+        case MathOp::Sigmoid:
+            return selectMathKernel<T, MathOp::Sigmoid>();
+        case MathOp::Erf:
+            return selectMathKernel<T, MathOp::Erf>();
+        case MathOp::Gelu:
+            return selectMathKernel<T, MathOp::Gelu>();
+    }
+    throw std::invalid_argument("Unknown math function");
+}
+
+template MathKernel<float> selectMathKernel<float>(MathOp op);
+template MathKernel<double> selectMathKernel<double>(MathOp op);
+
+namespace {
+template <class T>
+void runMathKernel(MathKernel<T> kernel,
+                   const Tensor& src,
+                   std::vector<int64_t> src_strides,
+                   Tensor& dst) {
+    constexpr auto kItemSize = static_cast<int64_t>(sizeof(T));
+    // Source is only read, pointers of all operands share the same type
+    auto* src_data = const_cast<std::byte*>(src.data());
+    forEachElementRun<2>(
+        dst.shape(),
+        {std::move(src_strides), dst.strides()},
+        {src_data, dst.data()},
+        kMathGrainElements,
+        [kernel](const std::array<std::byte*, 2>& data,
+                 const std::array<int64_t, 2>& strides,
+                 int64_t count) {
+            const auto* src_run = reinterpret_cast<const T*>(data[0]);
+            auto* dst_run = reinterpret_cast<T*>(data[1]);
+            if (strides[0] == kItemSize && strides[1] == kItemSize) {
+                kernel(src_run, dst_run, count);
+                return;
+            }
+            const int64_t src_step = strides[0] / kItemSize;
+            const int64_t dst_step = strides[1] / kItemSize;
+            T buffer[kMathBlockElements];
+            for (int64_t begin = 0; begin < count; begin += kMathBlockElements) {
+                const int64_t n = std::min(kMathBlockElements, count - begin);
+                for (int64_t i = 0; i < n; ++i) {
+                    buffer[i] = src_run[(begin + i) * src_step];
+                }
+                kernel(buffer, buffer, n);
+                for (int64_t i = 0; i < n; ++i) {
+                    dst_run[(begin + i) * dst_step] = buffer[i];
+                }
+            }
+        });
+}
+} // namespace
+} // namespace detail
+
+Tensor applyMath(MathOp op, const Tensor& src) {
+    Tensor dst(src.shape(), src.dtype());
+    applyMath(op, src, dst);
+    return dst;
+}
+
+void applyMath(MathOp op, const Tensor& src, Tensor& dst) {
+    if (src.dtype() != dst.dtype()) {
+        throw TypesMismatchError("Source and destination data types are different");
+    }
+    std::vector<int64_t> src_strides = detail::broadcastStrides(src, dst.shape());
+    detail::dispatchDataType(
+        detail::FloatingPointTypes{}, dst.dtype(), "floating point", [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            detail::runMathKernel<T>(
+                detail::selectMathKernel<T>(op), src, std::move(src_strides), dst);
+        });
+}
+} // namespace nope
@@ -0,0 +1,46 @@
+#include "math_bindings.h"
+
+#include <utility>
+
+#include "nope/math.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+namespace {
+void defMathFunction(py::module_& module, const char* name, MathOp op) {
+    module.def(
+        name,
+        [op](const Tensor& src, const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return applyMath(op, src);
+                }();
+                return py::cast(std::move(result));
+            }
+            // Returning out itself keeps the array it might be converted from alive
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                applyMath(op, src, dst);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("out") = py::none());
+}
+} // namespace
+
+void registerMathBindings(py::module_& module) {
+    defMathFunction(module, "exp", MathOp::Exp);
+    defMathFunction(module, "log", MathOp::Log);
+    defMathFunction(module, "tanh", MathOp::Tanh);
+    defMathFunction(module, "sigmoid", MathOp::Sigmoid);
+    defMathFunction(module, "erf", MathOp::Erf);
+    defMathFunction(module, "gelu", MathOp::Gelu);
+}
+} // namespace nope
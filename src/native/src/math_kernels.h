@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nope/math.h"
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Kernel writing \a MathOp of \a n contiguous elements of \a src into
+ * \a dst, \a dst might be \a src.
+ */
+template <class T>
+using MathKernel = void (*)(const T* src, T* dst, int64_t n);
+
+/**
+ * \brief The fastest kernel of \a op for the CPU, defined for float and double.
+ *
+ * \throw std::invalid_argument if \a op is unknown.
+ */
+template <class T>
+MathKernel<T> selectMathKernel(MathOp op);
+} // namespace detail
+} // namespace nope
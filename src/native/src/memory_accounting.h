@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nope {
+namespace detail {
+struct MemoryCounters;
+
+/**
+ * \brief Accounting data kept by the storage for its release.
+ */
+struct AllocationTicket {
+    /// Counters of the tag active at allocation, nullptr if untagged
+    MemoryCounters* tag{nullptr};
+    /// Debug record identifier, 0 if not recorded
+    uint64_t debug_id{0};
+};
+
+/**
+ * \brief Adds allocation of \a bytes to the global counters and counters of the
+ * innermost tag of the calling thread.
+ */
+AllocationTicket accountAllocation(size_t bytes, bool external) noexcept;
+
+/**
+ * \brief Removes allocation accounted by accountAllocation().
+ */
+void accountDeallocation(const AllocationTicket& ticket,
+                         size_t bytes,
+                         bool external) noexcept;
+} // namespace detail
+} // namespace nope
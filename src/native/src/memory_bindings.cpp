@@ -0,0 +1,190 @@
+#include "memory_bindings.h"
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nope/allocation_policy.h"
+#include "nope/memory_stats.h"
+#include "nope/quantization.h"
+#include "nope/shared_memory.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+namespace {
+/**
+ * \brief Context manager entering \a MemoryTagGuard scope.
+ */
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(std::string tag) : tag_(std::move(tag)) {
+    }
+
+    void enter() {
+        if (guard_) {
+            throw std::runtime_error("Memory tag scope '" + tag_
+                                     + "' is already entered");
+        }
+        guard_.emplace(tag_);
+    }
+
+    void exit() {
+        guard_.reset();
+    }
+
+    const std::string& tag() const noexcept {
+        return tag_;
+    }
+
+private:
+    std::string tag_;
+    std::optional<MemoryTagGuard> guard_;
+};
+
+std::string pythonAllocationSite() {
+    // Storages might be released and allocated by interpreter finalization or
+    // by threads not attached to the interpreter
+    if (!Py_IsInitialized()) {
+        return {};
+    }
+    py::gil_scoped_acquire gil;
+    try {
+        const auto stack = py::module_::import("traceback").attr("format_stack")();
+        return py::str("").attr("join")(stack).cast<std::string>();
+    } catch (const py::error_already_set&) {
+        return {};
+    }
+}
+} // namespace
+
+void registerMemoryBindings(py::module_& module) {
+    py::enum_<NumaPlacement>(module, "NumaPlacement")
+        .value("FIRST_TOUCH", NumaPlacement::FirstTouch)
+        .value("INTERLEAVE", NumaPlacement::Interleave)
+        .value("BIND", NumaPlacement::Bind);
+    py::class_<AllocationPolicy>(module, "AllocationPolicy")
+        .def(py::init<>())
+        .def_readwrite("huge_pages_threshold", &AllocationPolicy::huge_pages_threshold)
+        .def_readwrite("parallel_first_touch", &AllocationPolicy::parallel_first_touch)
+        .def_readwrite("numa_placement", &AllocationPolicy::numa_placement)
+        .def_readwrite("numa_node", &AllocationPolicy::numa_node);
+    module.def("get_allocation_policy", &getAllocationPolicy);
+    module.def("set_allocation_policy", &setAllocationPolicy, py::arg("policy"));
+    module.def("is_numa_available", &isNumaAvailable);
+
+    py::class_<MemoryStats>(module, "MemoryStats")
+        .def_readonly("live_bytes", &MemoryStats::live_bytes)
+        .def_readonly("peak_bytes", &MemoryStats::peak_bytes)
+        .def_readonly("live_allocations", &MemoryStats::live_allocations)
+        .def_readonly("allocations", &MemoryStats::allocations)
+        .def_readonly("owned_bytes", &MemoryStats::owned_bytes)
+        .def_readonly("external_bytes", &MemoryStats::external_bytes)
+        .def("__repr__", [](const MemoryStats& stats) {
+            return "MemoryStats(live_bytes=" + std::to_string(stats.live_bytes)
+                   + ", peak_bytes=" + std::to_string(stats.peak_bytes)
+                   + ", live_allocations=" + std::to_string(stats.live_allocations)
+                   + ", allocations=" + std::to_string(stats.allocations) + ")";
+        });
+    module.def(
+        "memory_stats",
+        [](const std::optional<std::string>& tag) {
+            return tag ? memoryStats(*tag) : memoryStats();
+        },
+        py::arg("tag") = py::none());
+    module.def("memory_stats_by_tag", &memoryStatsByTag);
+    module.def("reset_peak_memory_stats", &resetPeakMemoryStats);
+    py::class_<MemoryTagScope>(module, "memory_tag")
+        .def(py::init<std::string>(), py::arg("tag"))
+        .def_property_readonly("tag", &MemoryTagScope::tag)
+        .def("__enter__",
+             [](MemoryTagScope& scope) -> MemoryTagScope& {
+                 scope.enter();
+                 return scope;
+             },
+             py::return_value_policy::reference)
+        .def("__exit__", [](MemoryTagScope& scope, py::args) {
+            scope.exit();
+        });
+
+    py::class_<AllocationRecord>(module, "AllocationRecord")
+        .def_readonly("bytes", &AllocationRecord::bytes)
+        .def_readonly("external", &AllocationRecord::external)
+        .def_readonly("tag", &AllocationRecord::tag)
+        .def_readonly("site", &AllocationRecord::site);
+    module.def(
+        "set_memory_debug",
+        [](bool enabled, bool record_sites) {
+            if (enabled) {
+                enableMemoryDebugMode(record_sites ? pythonAllocationSite
+                                                   : AllocationSiteProvider{});
+            } else {
+                disableMemoryDebugMode();
+            }
+        },
+        py::arg("enabled"),
+        py::arg("record_sites") = true);
+    module.def("is_memory_debug_enabled", &isMemoryDebugModeEnabled);
+    module.def("live_allocations", &liveAllocations);
+
+    module.def("empty_shared",
+               &emptyShared,
+               py::arg("shape"),
+               py::arg("dtype") = TensorDataType(TensorDataType::Float32));
+    module.def("to_shared_memory", &toSharedMemory, py::arg("tensor"));
+    module.def("is_shared_memory", &isSharedMemory, py::arg("tensor"));
+    // Used by the multiprocessing reducer to pass segment descriptor and view
+    // metadata instead of the data
+    module.def(
+        "_shared_memory_handle",
+        [](const Tensor& tensor) {
+            return py::make_tuple(sharedMemoryFd(tensor),
+                                  tensor.storageSize(),
+                                  tensor.shape(),
+                                  tensor.strides(),
+                                  tensor.storageOffset(),
+                                  tensor.dtype().typeId(),
+                                  tensor.isQuantized() ? py::cast(*tensor.quantization())
+                                                       : py::none());
+        },
+        py::arg("tensor"));
+    module.def(
+        "_from_shared_memory",
+        [](int fd,
+           size_t storage_size,
+           std::vector<int64_t> shape,
+           std::vector<int64_t> strides,
+           int64_t storage_offset,
+           uint8_t type_id,
+           const std::optional<QuantizationParams>& quantization) {
+            if (type_id >= TensorDataType::kTypesCount) {
+                throw std::invalid_argument("Unknown tensor data type id: "
+                                            + std::to_string(type_id));
+            }
+            const auto dtype = static_cast<TensorDataType::TypeId>(type_id);
+            Tensor tensor = fromSharedMemory(fd,
+                                             storage_size,
+                                             std::move(shape),
+                                             std::move(strides),
+                                             storage_offset,
+                                             dtype);
+            if (quantization) {
+                tensor.setQuantization(*quantization);
+            }
+            return tensor;
+        },
+        py::arg("fd"),
+        py::arg("storage_size"),
+        py::arg("shape"),
+        py::arg("strides"),
+        py::arg("storage_offset"),
+        py::arg("type_id"),
+        py::arg("quantization") = py::none());
+}
+} // namespace nope
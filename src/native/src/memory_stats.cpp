@@ -0,0 +1,217 @@
+#include "nope/memory_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "memory_accounting.h"
+
+namespace nope {
+namespace detail {
+struct MemoryCounters {
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<int64_t> peak_bytes{0};
+    std::atomic<int64_t> live_allocations{0};
+    std::atomic<int64_t> allocations{0};
+    std::atomic<int64_t> owned_bytes{0};
+    std::atomic<int64_t> external_bytes{0};
+
+    void add(int64_t bytes, bool external) noexcept {
+        const int64_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed)
+                             + bytes;
+        int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+        while (live > peak
+               && !peak_bytes.compare_exchange_weak(
+                   peak, live, std::memory_order_relaxed)) {
+        }
+        live_allocations.fetch_add(1, std::memory_order_relaxed);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        kindBytes(external).fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void remove(int64_t bytes, bool external) noexcept {
+        live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        live_allocations.fetch_sub(1, std::memory_order_relaxed);
+        kindBytes(external).fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    std::atomic<int64_t>& kindBytes(bool external) noexcept {
+        return external ? external_bytes : owned_bytes;
+    }
+
+    void resetPeak() noexcept {
+        peak_bytes.store(live_bytes.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+    }
+
+    MemoryStats snapshot() const noexcept {
+        MemoryStats stats;
+        stats.live_bytes = live_bytes.load(std::memory_order_relaxed);
+        stats.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+        stats.live_allocations = live_allocations.load(std::memory_order_relaxed);
+        stats.allocations = allocations.load(std::memory_order_relaxed);
+        stats.owned_bytes = owned_bytes.load(std::memory_order_relaxed);
+        stats.external_bytes = external_bytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+namespace {
+MemoryCounters global_counters;
+
+// Tag counters are never removed, so storages can keep raw pointers to them. Containers
+// are intentionally leaked: storages might be released during static destruction
+std::mutex tags_mutex;
+auto& tag_counters = *new std::map<std::string, std::unique_ptr<MemoryCounters>>;
+
+struct TagScope {
+    std::string name;
+    MemoryCounters* counters;
+};
+
+thread_local std::vector<TagScope> tag_stack;
+
+std::atomic<bool> debug_mode{false};
+std::mutex debug_mutex;
+auto& site_provider = *new AllocationSiteProvider;
+uint64_t next_debug_id = 1;
+auto& debug_records = *new std::unordered_map<uint64_t, AllocationRecord>;
+
+MemoryCounters* findTagCounters(const std::string& tag) {
+    std::lock_guard<std::mutex> lock(tags_mutex);
+    auto& counters = tag_counters[tag];
+    if (!counters) {
+        counters = std::make_unique<MemoryCounters>();
+    }
+    return counters.get();
+}
+
+uint64_t recordAllocation(size_t bytes, bool external) {
+    AllocationRecord record;
+    record.bytes = static_cast<int64_t>(bytes);
+    record.external = external;
+    if (!tag_stack.empty()) {
+        record.tag = tag_stack.back().name;
+    }
+    AllocationSiteProvider provider;
+    {
+        std::lock_guard<std::mutex> lock(debug_mutex);
+        provider = site_provider;
+    }
+    // Provider is called without the lock, it might allocate tensors itself
+    if (provider) {
+        record.site = provider();
+    }
+    std::lock_guard<std::mutex> lock(debug_mutex);
+    const uint64_t id = next_debug_id++;
+    debug_records.emplace(id, std::move(record));
+    return id;
+}
+} // namespace
+
+AllocationTicket accountAllocation(size_t bytes, bool external) noexcept {
+    const auto signed_bytes = static_cast<int64_t>(bytes);
+    AllocationTicket ticket;
+    global_counters.add(signed_bytes, external);
+    if (!tag_stack.empty()) {
+        ticket.tag = tag_stack.back().counters;
+        ticket.tag->add(signed_bytes, external);
+    }
+    if (debug_mode.load(std::memory_order_relaxed)) {
+        // Debug records are best effort, failing to record must not fail allocation
+        try {
+            ticket.debug_id = recordAllocation(bytes, external);
+        } catch (...) {
+        }
+    }
+    return ticket;
+}
+
+void accountDeallocation(const AllocationTicket& ticket,
+                         size_t bytes,
+                         bool external) noexcept {
+    const auto signed_bytes = static_cast<int64_t>(bytes);
+    global_counters.remove(signed_bytes, external);
+    if (ticket.tag != nullptr) {
+        ticket.tag->remove(signed_bytes, external);
+    }
+    if (ticket.debug_id != 0) {
+        std::lock_guard<std::mutex> lock(debug_mutex);
+        debug_records.erase(ticket.debug_id);
+    }
+}
+} // namespace detail
+
+MemoryStats memoryStats() {
+    return detail::global_counters.snapshot();
+}
+
+MemoryStats memoryStats(const std::string& tag) {
+    std::lock_guard<std::mutex> lock(detail::tags_mutex);
+    const auto it = detail::tag_counters.find(tag);
+    return it != detail::tag_counters.end() ? it->second->snapshot() : MemoryStats{};
+}
+
+std::map<std::string, MemoryStats> memoryStatsByTag() {
+    std::map<std::string, MemoryStats> stats;
+    std::lock_guard<std::mutex> lock(detail::tags_mutex);
+    for (const auto& [tag, counters] : detail::tag_counters) {
+        stats.emplace(tag, counters->snapshot());
+    }
+    return stats;
+}
+
+void resetPeakMemoryStats() {
+    detail::global_counters.resetPeak();
+    std::lock_guard<std::mutex> lock(detail::tags_mutex);
+    for (auto& tag_and_counters : detail::tag_counters) {
+        tag_and_counters.second->resetPeak();
+    }
+}
+
+MemoryTagGuard::MemoryTagGuard(const std::string& tag) {
+    detail::tag_stack.push_back({tag, detail::findTagCounters(tag)});
+}
+
+MemoryTagGuard::~MemoryTagGuard() {
+    detail::tag_stack.pop_back();
+}
+
+void enableMemoryDebugMode(AllocationSiteProvider site_provider) {
+    std::lock_guard<std::mutex> lock(detail::debug_mutex);
+    detail::site_provider = std::move(site_provider);
+    detail::debug_mode.store(true, std::memory_order_relaxed);
+}
+
+void disableMemoryDebugMode() {
+    std::lock_guard<std::mutex> lock(detail::debug_mutex);
+    detail::debug_mode.store(false, std::memory_order_relaxed);
+    detail::site_provider = nullptr;
+    detail::debug_records.clear();
+}
+
+bool isMemoryDebugModeEnabled() noexcept {
+    return detail::debug_mode.load(std::memory_order_relaxed);
+}
+
+std::vector<AllocationRecord> liveAllocations() {
+    std::vector<std::pair<uint64_t, AllocationRecord>> records;
+    {
+        std::lock_guard<std::mutex> lock(detail::debug_mutex);
+        records.assign(detail::debug_records.begin(), detail::debug_records.end());
+    }
+    // Oldest allocations first, leaked long-lived tensors are usually there
+    std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+    std::vector<AllocationRecord> result;
+    result.reserve(records.size());
+    for (auto& id_and_record : records) {
+        result.push_back(std::move(id_and_record.second));
+    }
+    return result;
+}
+} // namespace nope
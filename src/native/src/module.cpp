@@ -5,11 +5,24 @@
 #include <stdexcept>
 #include <type_traits>
 
+#include "arithmetic_bindings.h"
+#include "concatenation_bindings.h"
+#include "elementwise_kernel_bindings.h"
+#include "indexing_bindings.h"
+#include "math_bindings.h"
+#include "memory_bindings.h"
 #include "nope/broadcasting.h"
 #include "nope/is_contiguous.h"
+#include "nope/parallel.h"
 #include "nope/shape_and_strides_manipulation.h"
 #include "nope/tensor_data_type.h"
+#include "normalization_bindings.h"
+#include "packed_tensor_list_bindings.h"
+#include "quantization_bindings.h"
+#include "random_bindings.h"
+#include "sorting_bindings.h"
 #include "tensor_bindings.h"
+#include "ternary_bindings.h"
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -268,5 +281,19 @@ PYBIND11_MODULE(_nope, nope_module) {
         },
         py::arg("shape"),
         py::arg("strides"));
+    nope_module.def("get_num_threads", &nope::getNumThreads);
+    nope_module.def("set_num_threads", &nope::setNumThreads, py::arg("num_threads"));
     nope::registerTensorBindings(nope_module);
+    nope::registerIndexingBindings(nope_module);
+    nope::registerConcatenationBindings(nope_module);
+    nope::registerSortingBindings(nope_module);
+    nope::registerRandomBindings(nope_module);
+    nope::registerMemoryBindings(nope_module);
+    nope::registerPackedTensorListBindings(nope_module);
+    nope::registerQuantizationBindings(nope_module);
+    nope::registerMathBindings(nope_module);
+    nope::registerArithmeticBindings(nope_module);
+    nope::registerTernaryBindings(nope_module);
+    nope::registerNormalizationBindings(nope_module);
+    nope::registerElementwiseKernelBindings(nope_module);
 }
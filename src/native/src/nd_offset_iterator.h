@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Walks over the N-dimensional index space in row-major order keeping
+ * byte offsets of \a NOperands strided operands in sync.
+ *
+ * \tparam NOperands Number of operands sharing the same shape.
+ */
+template <size_t NOperands>
+class NdOffsetIterator {
+public:
+    /**
+     * \param shape Shape of the iterated index space.
+     * \param dims Number of dimensions in \a shape.
+     * \param strides Pointers to the byte strides of each operand.
+     * \param start Linear (row-major) index to start from.
+     */
+    NdOffsetIterator(const int64_t* shape,
+                     int64_t dims,
+                     const std::array<const int64_t*, NOperands>& strides,
+                     int64_t start = 0)
+        : shape_{shape}, strides_{strides}, index_(static_cast<size_t>(dims), 0) {
+        for (int64_t dim = dims - 1; dim >= 0 && start > 0; --dim) {
+            const auto i = static_cast<size_t>(dim);
+            index_[i] = start % shape_[dim];
+            start /= shape_[dim];
+            for (size_t k = 0; k < NOperands; ++k) {
+                offsets_[k] += index_[i] * strides_[k][dim];
+            }
+        }
+    }
+
+    int64_t offset(size_t operand) const noexcept {
+        return offsets_[operand];
+    }
+
+    const std::array<int64_t, NOperands>& offsets() const noexcept {
+        return offsets_;
+    }
+
+    void next() noexcept {
+        for (auto dim = static_cast<int64_t>(index_.size()) - 1; dim >= 0; --dim) {
+            const auto i = static_cast<size_t>(dim);
+            for (size_t k = 0; k < NOperands; ++k) {
+                offsets_[k] += strides_[k][dim];
+            }
+            if (++index_[i] < shape_[dim]) {
+                return;
+            }
+            for (size_t k = 0; k < NOperands; ++k) {
+                offsets_[k] -= shape_[dim] * strides_[k][dim];
+            }
+            index_[i] = 0;
+        }
+    }
+
+private:
+    const int64_t* shape_;
+    std::array<const int64_t*, NOperands> strides_;
+    std::vector<int64_t> index_;
+    std::array<int64_t, NOperands> offsets_{};
+};
+} // namespace detail
+} // namespace nope
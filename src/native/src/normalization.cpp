@@ -0,0 +1,613 @@
+#include "nope/normalization.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "cpu_features.h"
+#include "elementwise_loop.h"
+#include "math_kernels.h"
+#include "nd_offset_iterator.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "type_dispatch.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kRowsGrainElements = 16 * 1024;
+/// Elements of a row processed at once, blocks of all operands stay in L1
+constexpr int64_t kRowBlockElements = 512;
+
+template <class T>
+using NormalizeKernel = void (*)(const T* x,
+                                 T mean,
+                                 T mean_residual,
+                                 T rstd,
+                                 const T* gamma,
+                                 const T* beta,
+                                 T* out,
+                                 int64_t n);
+
+/**
+ * \brief Reductions and transformations of contiguous blocks of rows.
+ */
+template <class T>
+struct RowBlockKernels {
+    T (*max)(const T* x, int64_t n);
+    T (*sum)(const T* x, int64_t n);
+    /// Sums of deviations of elements from \a shift and of their squares
+    std::pair<T, T> (*deviations)(const T* x, T shift, int64_t n);
+    /// \code out = x - shift \endcode
+    void (*subtract)(const T* x, T shift, T* out, int64_t n);
+    /// \code out = x * factor \endcode
+    void (*scale)(const T* x, T factor, T* out, int64_t n);
+    /// \code out = (x - mean - mean_residual) * rstd * gamma + beta \endcode
+    /// indexed by presence of gamma and beta
+    std::array<std::array<NormalizeKernel<T>, 2>, 2> normalize;
+    MathKernel<T> exp;
+};
+
+template <class T>
+T maxScalar(const T* x, int64_t n) noexcept {
+    T result = -std::numeric_limits<T>::infinity();
+    for (int64_t i = 0; i < n; ++i) {
+        result = x[i] > result ? x[i] : result;
+    }
+    return result;
+}
+
+template <class T>
+T sumScalar(const T* x, int64_t n) noexcept {
+    T result{0};
+    for (int64_t i = 0; i < n; ++i) {
+        result += x[i];
+    }
+    return result;
+}
+
+template <class T>
+std::pair<T, T> deviationsScalar(const T* x, T shift, int64_t n) noexcept {
+    T sum{0};
+    T squares{0};
+    for (int64_t i = 0; i < n; ++i) {
+        const T deviation = x[i] - shift;
+        sum += deviation;
+        squares += deviation * deviation;
+    }
+    return {sum, squares};
+}
+
+template <class T>
+void subtractScalar(const T* x, T shift, T* out, int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = x[i] - shift;
+    }
+}
+
+template <class T>
+void scaleScalar(const T* x, T factor, T* out, int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = x[i] * factor;
+    }
+}
+
+template <class T, bool kGamma, bool kBeta>
+void normalizeScalar(const T* x,
+                     T mean,
+                     T mean_residual,
+                     T rstd,
+                     const T* gamma,
+                     const T* beta,
+                     T* out,
+                     int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        T value = (x[i] - mean - mean_residual) * rstd;
+        if constexpr (kGamma) {
+            value *= gamma[i];
+        }
+        if constexpr (kBeta) {
+            value += beta[i];
+        }
+        out[i] = value;
+    }
+}
+
+#if NOPE_X86_DISPATCH
+template <class T>
+using RowVector = typename Avx2Vector<T>::type;
+
+template <class T>
+constexpr int64_t kRowLanes = static_cast<int64_t>(sizeof(RowVector<T>) / sizeof(T));
+
+template <class T>
+NOPE_TARGET_AVX2 RowVector<T> loadRow(const T* x) noexcept {
+    RowVector<T> v;
+    std::memcpy(&v, x, sizeof(v));
+    return v;
+}
+
+template <class T>
+NOPE_TARGET_AVX2 void storeRow(T* out, RowVector<T> v) noexcept {
+    std::memcpy(out, &v, sizeof(v));
+}
+
+template <class T>
+NOPE_TARGET_AVX2 T maxAvx2(const T* x, int64_t n) {
+    RowVector<T> acc{};
+    acc += -std::numeric_limits<T>::infinity();
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        const RowVector<T> v = loadRow(x + i);
+        acc = v > acc ? v : acc;
+    }
+    T result = maxScalar(x + vector_end, n - vector_end);
+    for (int64_t k = 0; k < kRowLanes<T>; ++k) {
+        result = acc[k] > result ? acc[k] : result;
+    }
+    return result;
+}
+
+template <class T>
+NOPE_TARGET_AVX2 T sumAvx2(const T* x, int64_t n) {
+    RowVector<T> acc{};
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        acc += loadRow(x + i);
+    }
+    T result = sumScalar(x + vector_end, n - vector_end);
+    for (int64_t k = 0; k < kRowLanes<T>; ++k) {
+        result += acc[k];
+    }
+    return result;
+}
+
+template <class T>
+NOPE_TARGET_AVX2 std::pair<T, T> deviationsAvx2(const T* x, T shift, int64_t n) {
+    RowVector<T> sum_acc{};
+    RowVector<T> squares_acc{};
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        const RowVector<T> deviation = loadRow(x + i) - shift;
+        sum_acc += deviation;
+        squares_acc += deviation * deviation;
+    }
+    auto [sum, squares] = deviationsScalar(x + vector_end, shift, n - vector_end);
+    for (int64_t k = 0; k < kRowLanes<T>; ++k) {
+        sum += sum_acc[k];
+        squares += squares_acc[k];
+    }
+    return {sum, squares};
+}
+
+template <class T>
+NOPE_TARGET_AVX2 void subtractAvx2(const T* x, T shift, T* out, int64_t n) {
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        storeRow(out + i, loadRow(x + i) - shift);
+    }
+    subtractScalar(x + vector_end, shift, out + vector_end, n - vector_end);
+}
+
+template <class T>
+NOPE_TARGET_AVX2 void scaleAvx2(const T* x, T factor, T* out, int64_t n) {
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        storeRow(out + i, loadRow(x + i) * factor);
+    }
+    scaleScalar(x + vector_end, factor, out + vector_end, n - vector_end);
+}
+
+template <class T, bool kGamma, bool kBeta>
+NOPE_TARGET_AVX2 void normalizeAvx2(const T* x,
+                                    T mean,
+                                    T mean_residual,
+                                    T rstd,
+                                    const T* gamma,
+                                    const T* beta,
+                                    T* out,
+                                    int64_t n) {
+    const int64_t vector_end = n - n % kRowLanes<T>;
+    for (int64_t i = 0; i < vector_end; i += kRowLanes<T>) {
+        RowVector<T> value = (loadRow(x + i) - mean - mean_residual) * rstd;
+        if constexpr (kGamma) {
+            value *= loadRow(gamma + i);
+        }
+        if constexpr (kBeta) {
+            value += loadRow(beta + i);
+        }
+        storeRow(out + i, value);
+    }
+    normalizeScalar<T, kGamma, kBeta>(x + vector_end,
+                                      mean,
+                                      mean_residual,
+                                      rstd,
+                                      kGamma ? gamma + vector_end : gamma,
+                                      kBeta ? beta + vector_end : beta,
+                                      out + vector_end,
+                                      n - vector_end);
+}
+#endif
+
+template <class T>
+RowBlockKernels<T> selectRowBlockKernels() {
+    const MathKernel<T> exp = selectMathKernel<T>(MathOp::Exp);
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return {&maxAvx2<T>,
+                &sumAvx2<T>,
+                &deviationsAvx2<T>,
+                &subtractAvx2<T>,
+                &scaleAvx2<T>,
+                {{{&normalizeAvx2<T, false, false>, &normalizeAvx2<T, false, true>},
+                  {&normalizeAvx2<T, true, false>, &normalizeAvx2<T, true, true>}}},
+                exp};
+    }
+#endif
+    return {&maxScalar<T>,
+            &sumScalar<T>,
+            &deviationsScalar<T>,
+            &subtractScalar<T>,
+            &scaleScalar<T>,
+            {{{&normalizeScalar<T, false, false>, &normalizeScalar<T, false, true>},
+              {&normalizeScalar<T, true, false>, &normalizeScalar<T, true, true>}}},
+            exp};
+}
+
+/**
+ * \brief Row of an operand with arbitrary stride. Blocks of non-contiguous
+ * rows are gathered into and scattered from a buffer, so kernels always see
+ * contiguous blocks.
+ */
+template <class T>
+struct StridedRow {
+    std::byte* data{nullptr};
+    int64_t stride{0};
+
+    bool isContiguous() const noexcept {
+        return stride == static_cast<int64_t>(sizeof(T));
+    }
+
+    const T* load(int64_t begin, int64_t n, T* buffer) const noexcept {
+        if (isContiguous()) {
+            return reinterpret_cast<const T*>(data) + begin;
+        }
+        for (int64_t i = 0; i < n; ++i) {
+            std::memcpy(buffer + i, data + (begin + i) * stride, sizeof(T));
+        }
+        return buffer;
+    }
+
+    /// Destination of the block, pass it to \a store after it is written
+    T* block(int64_t begin, T* buffer) const noexcept {
+        return isContiguous() ? reinterpret_cast<T*>(data) + begin : buffer;
+    }
+
+    void store(int64_t begin, int64_t n, const T* values) const noexcept {
+        if (isContiguous()) {
+            return;
+        }
+        for (int64_t i = 0; i < n; ++i) {
+            std::memcpy(data + (begin + i) * stride, values + i, sizeof(T));
+        }
+    }
+};
+
+/**
+ * \brief Buffers of a thread processing rows of \a row_size elements.
+ */
+template <class T>
+struct RowWorkspace {
+    explicit RowWorkspace(int64_t row_size)
+        : src(kRowBlockElements),
+          out(kRowBlockElements),
+          gamma(kRowBlockElements),
+          beta(kRowBlockElements),
+          shifts(static_cast<size_t>((row_size + kRowBlockElements - 1)
+                                     / kRowBlockElements)) {
+    }
+
+    std::vector<T> src;
+    std::vector<T> out;
+    std::vector<T> gamma;
+    std::vector<T> beta;
+    /// Maximum each block of softmax was shifted by
+    std::vector<T> shifts;
+};
+
+/**
+ * \brief Invokes \a fn(rows, workspace) for every row along the last axis of
+ * \a shape, where \a rows are the rows of \a NOperands operands. Rows are
+ * split between threads.
+ */
+template <class T, size_t NOperands, class RowFunction>
+void forEachRow(const std::vector<int64_t>& shape,
+                std::array<std::vector<int64_t>, NOperands> strides,
+                const std::array<std::byte*, NOperands>& data,
+                const RowFunction& fn) {
+    const int64_t row_size = shape.back();
+    std::vector<int64_t> outer_shape(shape.begin(), shape.end() - 1);
+    std::array<int64_t, NOperands> row_strides{};
+    std::array<int64_t*, NOperands> outer_strides{};
+    std::array<const int64_t*, NOperands> iterator_strides{};
+    for (size_t k = 0; k < NOperands; ++k) {
+        row_strides[k] = strides[k].back();
+        strides[k].pop_back();
+        outer_strides[k] = strides[k].data();
+        iterator_strides[k] = outer_strides[k];
+    }
+    const int64_t outer_dims = coalesceDimensions(outer_shape.data(),
+                                                  outer_strides.data(),
+                                                  static_cast<int64_t>(NOperands),
+                                                  static_cast<int64_t>(shape.size()) - 1);
+    int64_t rows = 1;
+    for (int64_t dim = 0; dim < outer_dims; ++dim) {
+        rows *= outer_shape[static_cast<size_t>(dim)];
+    }
+    const int64_t grain_size = std::max(int64_t{1}, kRowsGrainElements / row_size);
+    parallelFor(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+        RowWorkspace<T> workspace(row_size);
+        NdOffsetIterator<NOperands> it(
+            outer_shape.data(), outer_dims, iterator_strides, begin);
+        for (int64_t row = begin; row < end; ++row, it.next()) {
+            std::array<StridedRow<T>, NOperands> operand_rows;
+            for (size_t k = 0; k < NOperands; ++k) {
+                operand_rows[k] = {data[k] + it.offset(k), row_strides[k]};
+            }
+            fn(operand_rows, workspace);
+        }
+    });
+}
+
+template <class T>
+void softmaxRow(const RowBlockKernels<T>& kernels,
+                const StridedRow<T>& src,
+                const StridedRow<T>& out,
+                int64_t n,
+                RowWorkspace<T>& workspace) {
+    T max = -std::numeric_limits<T>::infinity();
+    T sum{0};
+    size_t block = 0;
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements, ++block) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        const T* x = src.load(begin, count, workspace.src.data());
+        const T block_max = kernels.max(x, count);
+        if (block_max > max) {
+            sum *= std::exp(max - block_max);
+            max = block_max;
+        }
+        T* y = out.block(begin, workspace.out.data());
+        kernels.subtract(x, max, y, count);
+        kernels.exp(y, y, count);
+        sum += kernels.sum(y, count);
+        out.store(begin, count, y);
+        workspace.shifts[block] = max;
+    }
+    block = 0;
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements, ++block) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        auto* y = const_cast<T*>(out.load(begin, count, workspace.out.data()));
+        kernels.scale(y, std::exp(workspace.shifts[block] - max) / sum, y, count);
+        out.store(begin, count, y);
+    }
+}
+
+template <class T>
+void logSoftmaxRow(const RowBlockKernels<T>& kernels,
+                   const StridedRow<T>& src,
+                   const StridedRow<T>& out,
+                   int64_t n,
+                   RowWorkspace<T>& workspace) {
+    T max = -std::numeric_limits<T>::infinity();
+    T sum{0};
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        const T* x = src.load(begin, count, workspace.src.data());
+        const T block_max = kernels.max(x, count);
+        if (block_max > max) {
+            sum *= std::exp(max - block_max);
+            max = block_max;
+        }
+        T* exponents = workspace.out.data();
+        kernels.subtract(x, max, exponents, count);
+        kernels.exp(exponents, exponents, count);
+        sum += kernels.sum(exponents, count);
+    }
+    const T shift = max + std::log(sum);
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        const T* x = src.load(begin, count, workspace.src.data());
+        T* y = out.block(begin, workspace.out.data());
+        kernels.subtract(x, shift, y, count);
+        out.store(begin, count, y);
+    }
+}
+
+template <class T>
+void layerNormRow(const RowBlockKernels<T>& kernels,
+                  const std::array<StridedRow<T>, 4>& rows,
+                  bool has_gamma,
+                  bool has_beta,
+                  double eps,
+                  int64_t n,
+                  RowWorkspace<T>& workspace) {
+    const auto& [src, gamma, beta, out] = rows;
+    // Deviations of a block are taken from its rounded mean and correct it,
+    // statistics of blocks are combined with Chan's formula
+    double mean = 0;
+    double squared_deviations = 0;
+    int64_t processed = 0;
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        const auto block_size = static_cast<double>(count);
+        const T* x = src.load(begin, count, workspace.src.data());
+        const T shift = kernels.sum(x, count) / static_cast<T>(count);
+        const auto [deviations_sum, deviations_squares] =
+            kernels.deviations(x, shift, count);
+        const double block_mean = static_cast<double>(shift)
+                                  + static_cast<double>(deviations_sum) / block_size;
+        const double block_deviations = static_cast<double>(deviations_squares)
+                                        - static_cast<double>(deviations_sum)
+                                              * static_cast<double>(deviations_sum)
+                                              / block_size;
+        const double delta = block_mean - mean;
+        const auto total = static_cast<double>(processed + count);
+        mean += delta * block_size / total;
+        squared_deviations += block_deviations
+                              + delta * delta * static_cast<double>(processed)
+                                    * block_size / total;
+        processed += count;
+    }
+    const double rstd = 1 / std::sqrt(squared_deviations / static_cast<double>(n) + eps);
+
+    // Elements close to the mean are subtracted from its rounded value exactly,
+    // so the rounding error of a large mean is subtracted from the deviation
+    const auto mean_high = static_cast<T>(mean);
+    const auto mean_low = static_cast<T>(mean - static_cast<double>(mean_high));
+    const NormalizeKernel<T> normalize = kernels.normalize[has_gamma][has_beta];
+    for (int64_t begin = 0; begin < n; begin += kRowBlockElements) {
+        const int64_t count = std::min(kRowBlockElements, n - begin);
+        const T* x = src.load(begin, count, workspace.src.data());
+        const T* g = nullptr;
+        const T* b = nullptr;
+        if (has_gamma) {
+            g = gamma.load(begin, count, workspace.gamma.data());
+        }
+        if (has_beta) {
+            b = beta.load(begin, count, workspace.beta.data());
+        }
+        T* y = out.block(begin, workspace.out.data());
+        normalize(x, mean_high, mean_low, static_cast<T>(rstd), g, b, y, count);
+        out.store(begin, count, y);
+    }
+}
+
+void checkRowsOperands(const Tensor& src, const Tensor& out) {
+    if (!src.dtype().isFloatingPoint()) {
+        throw TypesMismatchError("Expected floating point data type, got: "
+                                 + to_string(src.dtype()));
+    }
+    if (src.dtype() != out.dtype()) {
+        throw TypesMismatchError("Source and output data types are different");
+    }
+    if (src.dims() == 0) {
+        throw std::length_error("Tensor should have at least 1 dimension");
+    }
+    if (src.shape() != out.shape()) {
+        throw std::length_error("Source and output shapes are different");
+    }
+}
+
+enum class SoftmaxKind : uint8_t { Softmax, LogSoftmax };
+
+void runSoftmax(SoftmaxKind kind, const Tensor& src, Tensor& out) {
+    checkRowsOperands(src, out);
+    if (src.numel() == 0) {
+        return;
+    }
+    dispatchDataType(FloatingPointTypes{}, src.dtype(), "floating point", [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        const RowBlockKernels<T> kernels = selectRowBlockKernels<T>();
+        const int64_t n = src.shape().back();
+        // Source is only read, pointers of all operands share the same type
+        forEachRow<T, 2>(src.shape(),
+                         {src.strides(), out.strides()},
+                         {const_cast<std::byte*>(src.data()), out.data()},
+                         [&](const std::array<StridedRow<T>, 2>& rows,
+                             RowWorkspace<T>& workspace) {
+                             if (kind == SoftmaxKind::Softmax) {
+                                 softmaxRow(kernels, rows[0], rows[1], n, workspace);
+                             } else {
+                                 logSoftmaxRow(kernels, rows[0], rows[1], n, workspace);
+                             }
+                         });
+    });
+}
+} // namespace
+} // namespace detail
+
+Tensor softmax(const Tensor& src) {
+    Tensor out(src.shape(), src.dtype());
+    softmax(src, out);
+    return out;
+}
+
+void softmax(const Tensor& src, Tensor& out) {
+    detail::runSoftmax(detail::SoftmaxKind::Softmax, src, out);
+}
+
+Tensor logSoftmax(const Tensor& src) {
+    Tensor out(src.shape(), src.dtype());
+    logSoftmax(src, out);
+    return out;
+}
+
+void logSoftmax(const Tensor& src, Tensor& out) {
+    detail::runSoftmax(detail::SoftmaxKind::LogSoftmax, src, out);
+}
+
+Tensor layerNorm(const Tensor& src,
+                 const std::optional<Tensor>& gamma,
+                 const std::optional<Tensor>& beta,
+                 double eps) {
+    Tensor out(src.shape(), src.dtype());
+    layerNorm(src, gamma, beta, eps, out);
+    return out;
+}
+
+void layerNorm(const Tensor& src,
+               const std::optional<Tensor>& gamma,
+               const std::optional<Tensor>& beta,
+               double eps,
+               Tensor& out) {
+    detail::checkRowsOperands(src, out);
+    for (const auto* parameter : {&gamma, &beta}) {
+        if (*parameter && (*parameter)->dtype() != src.dtype()) {
+            throw TypesMismatchError("Gamma and beta data types should match the source");
+        }
+    }
+    // Absent parameters are never read
+    std::array<std::vector<int64_t>, 4> strides{
+        src.strides(),
+        gamma ? detail::broadcastStrides(*gamma, src.shape())
+              : std::vector<int64_t>(src.dims(), 0),
+        beta ? detail::broadcastStrides(*beta, src.shape())
+             : std::vector<int64_t>(src.dims(), 0),
+        out.strides()};
+    if (src.numel() == 0) {
+        return;
+    }
+    const std::array<std::byte*, 4> data{
+        const_cast<std::byte*>(src.data()),
+        gamma ? const_cast<std::byte*>(gamma->data()) : nullptr,
+        beta ? const_cast<std::byte*>(beta->data()) : nullptr,
+        out.data()};
+    detail::dispatchDataType(
+        detail::FloatingPointTypes{}, src.dtype(), "floating point", [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            const detail::RowBlockKernels<T> kernels = detail::selectRowBlockKernels<T>();
+            const int64_t n = src.shape().back();
+            detail::forEachRow<T, 4>(
+                src.shape(),
+                std::move(strides),
+                data,
+                [&](const std::array<detail::StridedRow<T>, 4>& rows,
+                    detail::RowWorkspace<T>& workspace) {
+                    detail::layerNormRow(kernels,
+                                         rows,
+                                         gamma.has_value(),
+                                         beta.has_value(),
+                                         eps,
+                                         n,
+                                         workspace);
+                });
+        });
+}
+} // namespace nope
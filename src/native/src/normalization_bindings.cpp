@@ -0,0 +1,80 @@
+#include "normalization_bindings.h"
+
+#include <optional>
+#include <utility>
+
+#include "nope/normalization.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+void registerNormalizationBindings(py::module_& module) {
+    module.def(
+        "softmax",
+        [](const Tensor& tensor, const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return softmax(tensor);
+                }();
+                return py::cast(std::move(result));
+            }
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                softmax(tensor, dst);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("out") = py::none());
+    module.def(
+        "log_softmax",
+        [](const Tensor& tensor, const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return logSoftmax(tensor);
+                }();
+                return py::cast(std::move(result));
+            }
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                logSoftmax(tensor, dst);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("out") = py::none());
+    module.def(
+        "layer_norm",
+        [](const Tensor& tensor,
+           const std::optional<Tensor>& gamma,
+           const std::optional<Tensor>& beta,
+           double eps,
+           const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return layerNorm(tensor, gamma, beta, eps);
+                }();
+                return py::cast(std::move(result));
+            }
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                layerNorm(tensor, gamma, beta, eps, dst);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("gamma") = py::none(),
+        py::arg("beta") = py::none(),
+        py::arg("eps") = 1e-5,
+        py::arg("out") = py::none());
+}
+} // namespace nope
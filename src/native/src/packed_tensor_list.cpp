@@ -0,0 +1,573 @@
+#include "nope/packed_tensor_list.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "nope/strided_copy.h"
+#include "type_dispatch.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kPackedGrainElements = 64 * 1024;
+constexpr int64_t kReduceBlockElements = 16 * 1024;
+
+using PaddingTypes = TypeList<int8_t,
+                              uint8_t,
+                              int16_t,
+                              uint16_t,
+                              int32_t,
+                              uint32_t,
+                              int64_t,
+                              uint64_t,
+                              float,
+                              double,
+                              bool>;
+
+/**
+ * \brief Grain size for parallel loops over items, so a chunk holds roughly
+ * \a kPackedGrainElements elements on average.
+ */
+int64_t itemsGrain(int64_t n_items, int64_t total_elements) noexcept {
+    if (total_elements == 0) {
+        return std::max(int64_t{1}, n_items);
+    }
+    return std::max(int64_t{1}, kPackedGrainElements * n_items / total_elements);
+}
+
+template <class T>
+T scalarAs(double value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        // Any non-zero value including NaN is true
+        return !(value >= 0.0 && value <= 0.0);
+    } else if constexpr (std::is_integral_v<T>) {
+        // Upper bound of the 64-bit types is not representable by double
+        if (!(value >= static_cast<double>(std::numeric_limits<T>::lowest())
+              && value < static_cast<double>(std::numeric_limits<T>::max()) + 1.0)) {
+            throw std::out_of_range("Scalar " + std::to_string(value)
+                                    + " is not representable by "
+                                    + to_string(TensorDataType::of<T>()));
+        }
+        return static_cast<T>(value);
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+/**
+ * \brief Unsigned type wide enough to do wrapping arithmetic on \a T without
+ * integer promotion to signed int.
+ */
+template <class T>
+using WrappingType = std::conditional_t<(sizeof(T) < sizeof(unsigned)),
+                                        unsigned,
+                                        std::make_unsigned_t<T>>;
+
+struct AddOp {
+    template <class T>
+    T operator()(T lhs, T rhs) const noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            using W = WrappingType<T>;
+            return static_cast<T>(static_cast<W>(lhs) + static_cast<W>(rhs));
+        } else {
+            return lhs + rhs;
+        }
+    }
+};
+
+struct SubtractOp {
+    template <class T>
+    T operator()(T lhs, T rhs) const noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            using W = WrappingType<T>;
+            return static_cast<T>(static_cast<W>(lhs) - static_cast<W>(rhs));
+        } else {
+            return lhs - rhs;
+        }
+    }
+};
+
+struct MultiplyOp {
+    template <class T>
+    T operator()(T lhs, T rhs) const noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            using W = WrappingType<T>;
+            return static_cast<T>(static_cast<W>(lhs) * static_cast<W>(rhs));
+        } else {
+            return lhs * rhs;
+        }
+    }
+};
+
+template <class T>
+bool isNan(T value) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::isnan(value);
+    } else {
+        return false;
+    }
+}
+
+// NaNs are propagated like in NumPy maximum and minimum
+struct MaximumOp {
+    template <class T>
+    T operator()(T lhs, T rhs) const noexcept {
+        return (lhs < rhs || isNan(rhs)) ? rhs : lhs;
+    }
+};
+
+struct MinimumOp {
+    template <class T>
+    T operator()(T lhs, T rhs) const noexcept {
+        return (rhs < lhs || isNan(rhs)) ? rhs : lhs;
+    }
+};
+
+template <class Fn>
+decltype(auto) dispatchBinaryOp(PackedBinaryOp op, Fn&& fn) {
+    switch (op) {
+        case PackedBinaryOp::Add:
+            return fn(AddOp{});
+        case PackedBinaryOp::Subtract:
+            return fn(SubtractOp{});
+        case PackedBinaryOp::Multiply:
+            return fn(MultiplyOp{});
+        case PackedBinaryOp::Maximum:
+            return fn(MaximumOp{});
+        case PackedBinaryOp::Minimum:
+            return fn(MinimumOp{});
+    }
+    throw std::invalid_argument("Unknown packed binary operation");
+}
+
+template <class T, class Op, bool ScalarRhs>
+void applyContiguous(const T* lhs, const T* rhs, T* out, int64_t size, Op op) {
+    parallelFor(0, size, kPackedGrainElements, [&](int64_t begin, int64_t end) {
+        if constexpr (ScalarRhs) {
+            const T value = *rhs;
+            for (int64_t i = begin; i < end; ++i) {
+                out[i] = op(lhs[i], value);
+            }
+        } else {
+            for (int64_t i = begin; i < end; ++i) {
+                out[i] = op(lhs[i], rhs[i]);
+            }
+        }
+    });
+}
+
+template <class T>
+struct SumReducer {
+    using IntegerAcc = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+    using Acc = std::conditional_t<std::is_floating_point_v<T>, double, IntegerAcc>;
+    using Result = std::conditional_t<std::is_floating_point_v<T>, T, Acc>;
+
+    static constexpr bool kNeedsElements = false;
+
+    static Acc identity() noexcept {
+        return Acc{0};
+    }
+
+    static Acc step(Acc acc, T value) noexcept {
+        return merge(acc, static_cast<Acc>(value));
+    }
+
+    static Acc merge(Acc lhs, Acc rhs) noexcept {
+        return AddOp{}(lhs, rhs);
+    }
+
+    static Result finalize(Acc acc, int64_t /* count */) noexcept {
+        return static_cast<Result>(acc);
+    }
+};
+
+template <class T>
+struct MeanReducer : SumReducer<T> {
+    using Result = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    static Result finalize(typename SumReducer<T>::Acc acc, int64_t count) noexcept {
+        return static_cast<Result>(static_cast<double>(acc) / static_cast<double>(count));
+    }
+};
+
+template <class T, class Op, bool IsMax>
+struct ExtremumReducer {
+    using Acc = T;
+    using Result = T;
+
+    static constexpr bool kNeedsElements = true;
+
+    static Acc identity() noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            return IsMax ? -std::numeric_limits<T>::infinity()
+                         : std::numeric_limits<T>::infinity();
+        } else {
+            return IsMax ? std::numeric_limits<T>::lowest()
+                         : std::numeric_limits<T>::max();
+        }
+    }
+
+    static Acc step(Acc acc, T value) noexcept {
+        return Op{}(acc, value);
+    }
+
+    static Acc merge(Acc lhs, Acc rhs) noexcept {
+        return Op{}(lhs, rhs);
+    }
+
+    static Result finalize(Acc acc, int64_t /* count */) noexcept {
+        return acc;
+    }
+};
+
+template <class T>
+using MaxReducer = ExtremumReducer<T, MaximumOp, true>;
+
+template <class T>
+using MinReducer = ExtremumReducer<T, MinimumOp, false>;
+
+/**
+ * \brief Partial result of an item crossing boundary of the reduced block.
+ */
+template <class Acc>
+struct PartialResult {
+    int64_t item{-1};
+    Acc acc{};
+};
+
+template <class Acc>
+struct BlockPartials {
+    PartialResult<Acc> first;
+    PartialResult<Acc> last;
+};
+
+template <class T, class Reducer>
+Tensor reduceItems(const PackedTensorList& list, const char* name) {
+    using Acc = typename Reducer::Acc;
+    using Result = typename Reducer::Result;
+
+    const auto& offsets = list.offsets();
+    const auto n_items = static_cast<int64_t>(list.size());
+    if constexpr (Reducer::kNeedsElements) {
+        for (int64_t i = 0; i < n_items; ++i) {
+            if (offsets[i] == offsets[i + 1]) {
+                throw std::invalid_argument(std::string(name) + " of the empty item "
+                                            + std::to_string(i) + " has no identity");
+            }
+        }
+    }
+
+    const T* data = list.data().unsafeData<T>();
+    const int64_t total = list.numel();
+    const int64_t n_blocks = (total + kReduceBlockElements - 1) / kReduceBlockElements;
+    std::vector<Acc> accs(static_cast<size_t>(n_items), Reducer::identity());
+    std::vector<BlockPartials<Acc>> partials(static_cast<size_t>(n_blocks));
+    parallelFor(0, n_blocks, 1, [&](int64_t first_block, int64_t last_block) {
+        for (int64_t block = first_block; block < last_block; ++block) {
+            const int64_t begin = block * kReduceBlockElements;
+            const int64_t end = std::min(total, begin + kReduceBlockElements);
+            // Last item starting at or before the block beginning, skips empty items
+            auto item = static_cast<int64_t>(
+                std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()
+                - 1);
+            auto& block_partials = partials[static_cast<size_t>(block)];
+            for (int64_t pos = begin; pos < end; ++item) {
+                const int64_t item_end = offsets[static_cast<size_t>(item + 1)];
+                const int64_t segment_end = std::min(end, item_end);
+                Acc acc = Reducer::identity();
+                for (int64_t i = pos; i < segment_end; ++i) {
+                    acc = Reducer::step(acc, data[i]);
+                }
+                const int64_t item_begin = offsets[static_cast<size_t>(item)];
+                if (pos == item_begin && segment_end == item_end) {
+                    accs[static_cast<size_t>(item)] = acc;
+                } else if (pos == begin) {
+                    block_partials.first = {item, acc};
+                } else {
+                    block_partials.last = {item, acc};
+                }
+                pos = segment_end;
+            }
+        }
+    });
+    // Items crossing block boundaries are merged sequentially in the block order
+    for (const auto& block_partials : partials) {
+        for (const auto* partial : {&block_partials.first, &block_partials.last}) {
+            if (partial->item >= 0) {
+                auto& acc = accs[static_cast<size_t>(partial->item)];
+                acc = Reducer::merge(acc, partial->acc);
+            }
+        }
+    }
+
+    Tensor result({n_items}, TensorDataType::of<Result>());
+    auto* out = result.unsafeData<Result>();
+    for (int64_t i = 0; i < n_items; ++i) {
+        out[i] = Reducer::finalize(accs[static_cast<size_t>(i)],
+                                   offsets[static_cast<size_t>(i + 1)]
+                                       - offsets[static_cast<size_t>(i)]);
+    }
+    return result;
+}
+
+std::vector<std::vector<int64_t>> shapesOf(const std::vector<Tensor>& tensors) {
+    std::vector<std::vector<int64_t>> shapes;
+    shapes.reserve(tensors.size());
+    for (const auto& tensor : tensors) {
+        shapes.push_back(tensor.shape());
+    }
+    return shapes;
+}
+
+TensorDataType commonDataType(const std::vector<Tensor>& tensors) {
+    if (tensors.empty()) {
+        throw std::length_error("Can't deduce data type of the empty list of tensors");
+    }
+    const TensorDataType dtype = tensors.front().dtype();
+    for (const auto& tensor : tensors) {
+        if (tensor.dtype() != dtype) {
+            throw TypesMismatchError("Packed tensors have different data types: "
+                                     + to_string(dtype) + " and "
+                                     + to_string(tensor.dtype()));
+        }
+    }
+    return dtype;
+}
+
+template <class T>
+void fillWith(std::byte* data, int64_t count, double value) {
+    const T typed_value = scalarAs<T>(value);
+    auto* typed_data = reinterpret_cast<T*>(data);
+    std::fill(typed_data, typed_data + count, typed_value);
+}
+} // namespace
+} // namespace detail
+
+PackedTensorList::PackedTensorList(const std::vector<std::vector<int64_t>>& shapes,
+                                   TensorDataType dtype)
+    : layout_{makeLayout(shapes)}, data_{{layout_->offsets.back()}, dtype} {
+}
+
+PackedTensorList::PackedTensorList(const std::vector<Tensor>& tensors)
+    : PackedTensorList(detail::shapesOf(tensors), detail::commonDataType(tensors)) {
+    const auto n_items = static_cast<int64_t>(tensors.size());
+    const int64_t element_size = dtype().ssize();
+    std::byte* dst = data_.data();
+    const int64_t grain = detail::itemsGrain(n_items, numel());
+    parallelFor(0, n_items, grain, [&](int64_t begin, int64_t end) {
+        std::vector<int64_t> dst_strides(itemDims());
+        for (int64_t i = begin; i < end; ++i) {
+            const auto& tensor = tensors[static_cast<size_t>(i)];
+            const int64_t offset = layout_->offsets[static_cast<size_t>(i)];
+            std::byte* item_dst = dst + offset * element_size;
+            if (tensor.isContiguous()) {
+                std::memcpy(item_dst,
+                            tensor.data(),
+                            static_cast<size_t>(tensor.numel() * element_size));
+                continue;
+            }
+            fillContiguousStrides(tensor.shape().data(),
+                                  dst_strides.data(),
+                                  layout_->item_dims,
+                                  element_size);
+            detail::copyStrided(tensor.shape().data(),
+                                layout_->item_dims,
+                                tensor.data(),
+                                tensor.strides().data(),
+                                item_dst,
+                                dst_strides.data(),
+                                element_size);
+        }
+    });
+}
+
+PackedTensorList::PackedTensorList(std::shared_ptr<const Layout> layout, Tensor data)
+    : layout_{std::move(layout)}, data_{std::move(data)} {
+}
+
+std::shared_ptr<const PackedTensorList::Layout>
+PackedTensorList::makeLayout(const std::vector<std::vector<int64_t>>& shapes) {
+    auto layout = std::make_shared<Layout>();
+    layout->item_dims = shapes.empty() ? 0 : static_cast<int64_t>(shapes.front().size());
+    layout->shapes.reserve(shapes.size() * static_cast<size_t>(layout->item_dims));
+    layout->offsets.reserve(shapes.size() + 1);
+    layout->offsets.push_back(0);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        const auto& shape = shapes[i];
+        if (static_cast<int64_t>(shape.size()) != layout->item_dims) {
+            throw std::length_error("Packed tensors have different ranks: "
+                                    + std::to_string(layout->item_dims) + " and "
+                                    + std::to_string(shape.size()) + " of item "
+                                    + std::to_string(i));
+        }
+        int64_t numel = 1;
+        for (const int64_t dim : shape) {
+            if (dim < 0) {
+                throw std::length_error("Negative extent of item " + std::to_string(i));
+            }
+            numel *= dim;
+        }
+        layout->shapes.insert(layout->shapes.end(), shape.begin(), shape.end());
+        layout->offsets.push_back(layout->offsets.back() + numel);
+    }
+    return layout;
+}
+
+std::vector<int64_t> PackedTensorList::itemShape(size_t i) const {
+    const int64_t* shape = itemShapeData(i);
+    return std::vector<int64_t>(shape, shape + itemDims());
+}
+
+Tensor PackedTensorList::item(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Item index " + std::to_string(i)
+                                + " is out of bounds for the list of "
+                                + std::to_string(size()) + " tensors");
+    }
+    auto shape = itemShape(i);
+    auto strides = createContiguousStrides(shape, dtype().ssize());
+    return data_.asStrided(std::move(shape),
+                           std::move(strides),
+                           data_.storageOffset()
+                               + layout_->offsets[i] * dtype().ssize());
+}
+
+std::vector<Tensor> PackedTensorList::unpack() const {
+    std::vector<Tensor> items;
+    items.reserve(size());
+    for (size_t i = 0; i < size(); ++i) {
+        items.push_back(item(i));
+    }
+    return items;
+}
+
+Tensor PackedTensorList::toPadded(double padding_value) const {
+    const auto n_items = static_cast<int64_t>(size());
+    const auto item_dims = static_cast<int64_t>(itemDims());
+    std::vector<int64_t> padded_shape(static_cast<size_t>(item_dims + 1), 0);
+    padded_shape[0] = n_items;
+    for (int64_t i = 0; i < n_items; ++i) {
+        const int64_t* shape = itemShapeData(static_cast<size_t>(i));
+        for (int64_t dim = 0; dim < item_dims; ++dim) {
+            auto& padded_dim = padded_shape[static_cast<size_t>(dim + 1)];
+            padded_dim = std::max(padded_dim, shape[dim]);
+        }
+    }
+    Tensor padded(padded_shape, dtype());
+    const int64_t element_size = dtype().ssize();
+    const auto slice_strides = std::vector<int64_t>(padded.strides().begin() + 1,
+                                                    padded.strides().end());
+    const int64_t slice_size = n_items > 0 ? padded.numel() / n_items : 0;
+    const auto fill = detail::dispatchDataType(
+        detail::PaddingTypes{}, dtype(), "arithmetic or bool", [](auto tag) {
+            return &detail::fillWith<typename decltype(tag)::type>;
+        });
+    // Validates padding value before filling in parallel
+    fill(padded.data(), 0, padding_value);
+
+    const std::byte* src = data_.data();
+    std::byte* dst = padded.data();
+    const int64_t grain = detail::itemsGrain(n_items, padded.numel());
+    parallelFor(0, n_items, grain, [&](int64_t begin, int64_t end) {
+        std::vector<int64_t> src_strides(static_cast<size_t>(item_dims));
+        for (int64_t i = begin; i < end; ++i) {
+            std::byte* slice = dst + i * slice_size * element_size;
+            const int64_t* shape = itemShapeData(static_cast<size_t>(i));
+            const int64_t offset = layout_->offsets[static_cast<size_t>(i)];
+            if (layout_->offsets[static_cast<size_t>(i + 1)] - offset == slice_size) {
+                std::memcpy(slice,
+                            src + offset * element_size,
+                            static_cast<size_t>(slice_size * element_size));
+                continue;
+            }
+            fill(slice, slice_size, padding_value);
+            fillContiguousStrides(shape, src_strides.data(), item_dims, element_size);
+            detail::copyStrided(shape,
+                                item_dims,
+                                src + offset * element_size,
+                                src_strides.data(),
+                                slice,
+                                slice_strides.data(),
+                                element_size);
+        }
+    });
+    return padded;
+}
+
+bool PackedTensorList::hasSameLayout(const PackedTensorList& that) const noexcept {
+    return layout_ == that.layout_
+           || (layout_->item_dims == that.layout_->item_dims
+               && layout_->offsets == that.layout_->offsets
+               && layout_->shapes == that.layout_->shapes);
+}
+
+PackedTensorList emptyLike(const PackedTensorList& list, TensorDataType dtype) {
+    return PackedTensorList(list.layout_, Tensor({list.numel()}, dtype));
+}
+
+PackedTensorList
+apply(PackedBinaryOp op, const PackedTensorList& lhs, const PackedTensorList& rhs) {
+    if (lhs.dtype() != rhs.dtype()) {
+        throw TypesMismatchError("Packed lists data types are different: "
+                                 + to_string(lhs.dtype()) + " and "
+                                 + to_string(rhs.dtype()));
+    }
+    if (!lhs.hasSameLayout(rhs)) {
+        throw std::length_error("Packed lists have different layouts");
+    }
+    PackedTensorList out = emptyLike(lhs, lhs.dtype());
+    detail::dispatchArithmeticDataType(lhs.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        detail::dispatchBinaryOp(op, [&](auto op_fn) {
+            detail::applyContiguous<T, decltype(op_fn), false>(
+                lhs.data().unsafeData<T>(),
+                rhs.data().unsafeData<T>(),
+                out.data().unsafeData<T>(),
+                out.numel(),
+                op_fn);
+        });
+    });
+    return out;
+}
+
+PackedTensorList apply(PackedBinaryOp op, const PackedTensorList& lhs, double rhs) {
+    PackedTensorList out = emptyLike(lhs, lhs.dtype());
+    detail::dispatchArithmeticDataType(lhs.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        const T value = detail::scalarAs<T>(rhs);
+        detail::dispatchBinaryOp(op, [&](auto op_fn) {
+            detail::applyContiguous<T, decltype(op_fn), true>(lhs.data().unsafeData<T>(),
+                                                              &value,
+                                                              out.data().unsafeData<T>(),
+                                                              out.numel(),
+                                                              op_fn);
+        });
+    });
+    return out;
+}
+
+Tensor reduce(PackedReduction reduction, const PackedTensorList& list) {
+    return detail::dispatchArithmeticDataType(list.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        switch (reduction) {
+            case PackedReduction::Sum:
+                return detail::reduceItems<T, detail::SumReducer<T>>(list, "Sum");
+            case PackedReduction::Mean:
+                return detail::reduceItems<T, detail::MeanReducer<T>>(list, "Mean");
+            case PackedReduction::Max:
+                return detail::reduceItems<T, detail::MaxReducer<T>>(list, "Max");
+            case PackedReduction::Min:
+                return detail::reduceItems<T, detail::MinReducer<T>>(list, "Min");
+        }
+        throw std::invalid_argument("Unknown packed reduction");
+    });
+}
+} // namespace nope
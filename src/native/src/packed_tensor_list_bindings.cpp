@@ -0,0 +1,104 @@
+#include "packed_tensor_list_bindings.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nope/packed_tensor_list.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+namespace {
+template <PackedBinaryOp Op>
+void defBinaryOp(py::class_<PackedTensorList>& cls, const char* name) {
+    cls.def(name, [](const PackedTensorList& lhs, const PackedTensorList& rhs) {
+        py::gil_scoped_release release;
+        return apply(Op, lhs, rhs);
+    });
+    cls.def(name, [](const PackedTensorList& lhs, double rhs) {
+        py::gil_scoped_release release;
+        return apply(Op, lhs, rhs);
+    });
+}
+
+template <PackedReduction Reduction>
+void defReduction(py::class_<PackedTensorList>& cls, const char* name) {
+    cls.def(name, [](const PackedTensorList& list) {
+        py::gil_scoped_release release;
+        return reduce(Reduction, list);
+    });
+}
+} // namespace
+
+void registerPackedTensorListBindings(py::module_& module) {
+    py::class_<PackedTensorList> cls(module, "PackedTensorList");
+    cls.def(py::init([](const std::vector<Tensor>& tensors) {
+                py::gil_scoped_release release;
+                return PackedTensorList(tensors);
+            }),
+            py::arg("tensors"))
+        .def_static(
+            "empty",
+            [](const std::vector<std::vector<int64_t>>& shapes, TensorDataType dtype) {
+                return PackedTensorList(shapes, dtype);
+            },
+            py::arg("shapes"),
+            py::arg("dtype") = TensorDataType(TensorDataType::Float32))
+        .def("__len__", &PackedTensorList::size)
+        .def("__getitem__",
+             [](const PackedTensorList& list, int64_t i) {
+                 const auto size = static_cast<int64_t>(list.size());
+                 if (i < -size || i >= size) {
+                     throw py::index_error("Item index " + std::to_string(i)
+                                           + " is out of bounds for the list of "
+                                           + std::to_string(size) + " tensors");
+                 }
+                 return list.item(static_cast<size_t>(i < 0 ? i + size : i));
+             })
+        .def_property_readonly("dtype", &PackedTensorList::dtype)
+        .def_property_readonly("offsets", &PackedTensorList::offsets)
+        .def_property_readonly("shapes",
+                               [](const PackedTensorList& list) {
+                                   py::list shapes;
+                                   for (size_t i = 0; i < list.size(); ++i) {
+                                       const auto shape = py::cast(list.itemShape(i));
+                                       shapes.append(py::tuple(shape));
+                                   }
+                                   return shapes;
+                               })
+        .def_property_readonly(
+            "data", py::overload_cast<>(&PackedTensorList::data, py::const_))
+        .def("numel", &PackedTensorList::numel)
+        .def("unpack", &PackedTensorList::unpack)
+        .def(
+            "to_padded",
+            [](const PackedTensorList& list, double padding_value) {
+                py::gil_scoped_release release;
+                return list.toPadded(padding_value);
+            },
+            py::arg("padding_value") = 0.0)
+        .def("has_same_layout", &PackedTensorList::hasSameLayout, py::arg("other"));
+    defBinaryOp<PackedBinaryOp::Add>(cls, "__add__");
+    defBinaryOp<PackedBinaryOp::Subtract>(cls, "__sub__");
+    defBinaryOp<PackedBinaryOp::Multiply>(cls, "__mul__");
+    cls.def("__radd__", [](const PackedTensorList& rhs, double lhs) {
+        py::gil_scoped_release release;
+        return apply(PackedBinaryOp::Add, rhs, lhs);
+    });
+    cls.def("__rmul__", [](const PackedTensorList& rhs, double lhs) {
+        py::gil_scoped_release release;
+        return apply(PackedBinaryOp::Multiply, rhs, lhs);
+    });
+    defBinaryOp<PackedBinaryOp::Maximum>(cls, "maximum");
+    defBinaryOp<PackedBinaryOp::Minimum>(cls, "minimum");
+    defReduction<PackedReduction::Sum>(cls, "sum");
+    defReduction<PackedReduction::Mean>(cls, "mean");
+    defReduction<PackedReduction::Max>(cls, "max");
+    defReduction<PackedReduction::Min>(cls, "min");
+}
+} // namespace nope
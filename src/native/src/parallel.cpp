@@ -0,0 +1,222 @@
+#include "nope/parallel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nope {
+namespace detail {
+thread_local bool in_parallel_region = false;
+
+size_t defaultNumThreads() noexcept {
+    return std::max(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * \brief Pool of persistent worker threads executing at most one batch of
+ * tasks at a time. Task with index \a i is executed by the worker \a i,
+ * task 0 is executed by the submitting thread.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads) {
+        workers_.reserve(num_threads - 1);
+        for (size_t i = 1; i < num_threads; ++i) {
+            workers_.emplace_back([this, i] {
+                workerLoop(static_cast<int64_t>(i));
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    size_t size() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    /**
+     * \brief Executes \a task for each index in [0, n_tasks). Returns false
+     * without executing anything if pool is busy with another batch.
+     */
+    bool tryRun(int64_t n_tasks, const std::function<void(int64_t)>& task) {
+        std::unique_lock<std::mutex> submit_lock(submit_mutex_, std::try_to_lock);
+        if (!submit_lock.owns_lock()) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            n_tasks_ = n_tasks;
+            pending_ = n_tasks - 1;
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_cv_.notify_all();
+
+        runTask(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] {
+            return pending_ == 0;
+        });
+        task_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+        return true;
+    }
+
+private:
+    void runTask(int64_t task_idx) {
+        in_parallel_region = true;
+        try {
+            (*task_)(task_idx);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        in_parallel_region = false;
+    }
+
+    void workerLoop(int64_t worker_idx) {
+        uint64_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_cv_.wait(lock, [&] {
+                    return stop_ || generation_ != seen_generation;
+                });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+                if (worker_idx >= n_tasks_) {
+                    continue;
+                }
+            }
+            runTask(worker_idx);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --pending_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int64_t)>* task_{nullptr};
+    int64_t n_tasks_{0};
+    int64_t pending_{0};
+    uint64_t generation_{0};
+    bool stop_{false};
+    std::exception_ptr error_;
+};
+
+std::mutex& threadPoolMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::shared_ptr<ThreadPool>& threadPoolInstance() {
+    static std::shared_ptr<ThreadPool> pool;
+    return pool;
+}
+
+std::shared_ptr<ThreadPool> acquireThreadPool() {
+    std::lock_guard<std::mutex> lock(threadPoolMutex());
+    auto& pool = threadPoolInstance();
+    if (!pool) {
+        pool = std::make_shared<ThreadPool>(defaultNumThreads());
+    }
+    return pool;
+}
+} // namespace detail
+
+size_t getNumThreads() noexcept {
+    std::lock_guard<std::mutex> lock(detail::threadPoolMutex());
+    const auto& pool = detail::threadPoolInstance();
+    return pool ? pool->size() : detail::defaultNumThreads();
+}
+
+void setNumThreads(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = detail::defaultNumThreads();
+    }
+    std::shared_ptr<detail::ThreadPool> old_pool;
+    {
+        std::lock_guard<std::mutex> lock(detail::threadPoolMutex());
+        auto& pool = detail::threadPoolInstance();
+        if (pool && pool->size() == num_threads) {
+            return;
+        }
+        old_pool = std::exchange(pool, std::make_shared<detail::ThreadPool>(num_threads));
+    }
+    // Old pool is joined outside of the lock once all in-flight batches are
+    // finished and the last reference is released
+}
+
+int64_t parallelChunksCount(int64_t range_size, int64_t grain_size) noexcept {
+    if (range_size <= 0) {
+        return 0;
+    }
+    grain_size = std::max(grain_size, int64_t{1});
+    const int64_t max_chunks = (range_size + grain_size - 1) / grain_size;
+    return std::min(static_cast<int64_t>(getNumThreads()), max_chunks);
+}
+
+void parallelFor(int64_t begin,
+                 int64_t end,
+                 int64_t grain_size,
+                 const std::function<void(int64_t, int64_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+    const int64_t range_size = end - begin;
+    if (detail::in_parallel_region || parallelChunksCount(range_size, grain_size) <= 1) {
+        fn(begin, end);
+        return;
+    }
+    auto pool = detail::acquireThreadPool();
+    grain_size = std::max(grain_size, int64_t{1});
+    const int64_t n_chunks = std::min(static_cast<int64_t>(pool->size()),
+                                      (range_size + grain_size - 1) / grain_size);
+    const int64_t chunk_size = (range_size + n_chunks - 1) / n_chunks;
+    const std::function<void(int64_t)> task = [&](int64_t chunk_idx) {
+        const int64_t chunk_begin = begin + chunk_idx * chunk_size;
+        const int64_t chunk_end = std::min(end, chunk_begin + chunk_size);
+        if (chunk_begin < chunk_end) {
+            fn(chunk_begin, chunk_end);
+        }
+    };
+    if (!pool->tryRun(n_chunks, task)) {
+        // Pool is occupied by another caller - process chunks in place keeping
+        // the same partitioning
+        for (int64_t chunk_idx = 0; chunk_idx < n_chunks; ++chunk_idx) {
+            task(chunk_idx);
+        }
+    }
+}
+} // namespace nope
@@ -0,0 +1,646 @@
+#include "nope/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cpu_features.h"
+#include "nope/parallel.h"
+#include "type_dispatch.h"
+
+#if NOPE_X86_DISPATCH
+    #include <immintrin.h>
+#endif
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kQuantizeGrainElements = 64 * 1024;
+/// Largest scale ratio representable by 16-bit fixed point multiplier
+constexpr double kMaxAddScaleRatio = 32767.0;
+constexpr int32_t kMaxAddShift = 30;
+
+using QuantizedTypes = TypeList<int8_t, uint8_t>;
+
+/**
+ * \brief Requantization constants of a + b for a single channel:
+ * \code out = zero_point + ((lhs * (a - lhs_zp) + rhs * (b - rhs_zp)) >> shift) \endcode
+ * with rounding half up.
+ */
+struct AddParams {
+    int16_t lhs_multiplier{0};
+    int16_t rhs_multiplier{0};
+    int32_t shift{0};
+    int32_t lhs_zero_point{0};
+    int32_t rhs_zero_point{0};
+    int32_t out_zero_point{0};
+
+    /// Both multipliers in a single 32-bit lane, the left one in the low half
+    int32_t packedMultipliers() const noexcept {
+        return static_cast<int32_t>(
+            static_cast<uint16_t>(lhs_multiplier)
+            | (static_cast<uint32_t>(static_cast<uint16_t>(rhs_multiplier)) << 16));
+    }
+};
+
+/**
+ * \brief Requantization constants of a * b for a single channel:
+ * \code out = zero_point + round(scale * (a - lhs_zp) * (b - rhs_zp)) \endcode
+ * Scaled product is clamped to [low, high] before rounding.
+ */
+struct MulParams {
+    float scale{1.0F};
+    float low{0.0F};
+    float high{0.0F};
+    int32_t lhs_zero_point{0};
+    int32_t rhs_zero_point{0};
+    int32_t out_zero_point{0};
+};
+
+template <class Q>
+constexpr int32_t kQuantizedMin = std::numeric_limits<Q>::min();
+
+template <class Q>
+constexpr int32_t kQuantizedMax = std::numeric_limits<Q>::max();
+
+template <class Q>
+inline Q saturate(int32_t value) noexcept {
+    return static_cast<Q>(std::clamp(value, kQuantizedMin<Q>, kQuantizedMax<Q>));
+}
+
+/**
+ * \brief Splits contiguous elements of a tensor of \a shape into runs sharing
+ * the index along \a axis (a single run for -1) and processes them in
+ * parallel as \a fn(first_element, run_size, channel).
+ */
+template <class Fn>
+void forEachChannelRun(const std::vector<int64_t>& shape, int64_t axis, Fn&& fn) {
+    int64_t numel = 1;
+    int64_t inner = 1;
+    for (size_t dim = 0; dim < shape.size(); ++dim) {
+        numel *= shape[dim];
+        if (axis >= 0 && static_cast<int64_t>(dim) > axis) {
+            inner *= shape[dim];
+        }
+    }
+    if (numel == 0) {
+        return;
+    }
+    const int64_t channels = axis >= 0 ? shape[static_cast<size_t>(axis)] : 1;
+    if (axis < 0) {
+        inner = numel;
+    }
+    parallelFor(0, numel, kQuantizeGrainElements, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end;) {
+            const int64_t run = i / inner;
+            const int64_t run_end = std::min(end, (run + 1) * inner);
+            fn(i, run_end - i, run % channels);
+            i = run_end;
+        }
+    });
+}
+
+// SECTION: Quantize
+template <class Real, class Q>
+void quantizeScalar(const Real* src, Q* dst, int64_t n, float scale, int32_t zero_point) {
+    const Real inv_scale = Real{1} / static_cast<Real>(scale);
+    // Clamping before rounding keeps conversion to integer in range, NaNs go low
+    const auto low = static_cast<Real>(kQuantizedMin<Q> - zero_point);
+    const auto high = static_cast<Real>(kQuantizedMax<Q> - zero_point);
+    for (int64_t i = 0; i < n; ++i) {
+        Real value = src[i] * inv_scale;
+        value = value > low ? value : low;
+        value = value < high ? value : high;
+        dst[i] = static_cast<Q>(static_cast<int32_t>(std::nearbyint(value)) + zero_point);
+    }
+}
+
+// SECTION: Dequantize
+template <class Q>
+void dequantizeScalar(const Q* src,
+                      float* dst,
+                      int64_t n,
+                      float scale,
+                      int32_t zero_point) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<float>(static_cast<int32_t>(src[i]) - zero_point) * scale;
+    }
+}
+
+// SECTION: Add
+template <class Q>
+void addScalar(const Q* lhs, const Q* rhs, Q* out, int64_t n, const AddParams& p) {
+    const int32_t rounding = p.shift > 0 ? int32_t{1} << (p.shift - 1) : 0;
+    for (int64_t i = 0; i < n; ++i) {
+        const int32_t acc = p.lhs_multiplier * (lhs[i] - p.lhs_zero_point)
+                            + p.rhs_multiplier * (rhs[i] - p.rhs_zero_point) + rounding;
+        out[i] = saturate<Q>((acc >> p.shift) + p.out_zero_point);
+    }
+}
+
+AddParams makeAddParams(float lhs_scale,
+                        int32_t lhs_zero_point,
+                        float rhs_scale,
+                        int32_t rhs_zero_point,
+                        float out_scale,
+                        int32_t out_zero_point) {
+    const double lhs_ratio = static_cast<double>(lhs_scale) / out_scale;
+    const double rhs_ratio = static_cast<double>(rhs_scale) / out_scale;
+    const double max_ratio = std::max(lhs_ratio, rhs_ratio);
+    if (!(max_ratio < kMaxAddScaleRatio)) {
+        throw std::invalid_argument("Ratio of the operand and result scales is too "
+                                    "large: "
+                                    + std::to_string(max_ratio));
+    }
+    // The largest shift keeping both multipliers within 16 bits
+    int32_t shift = 0;
+    while (shift < kMaxAddShift
+           && std::round(std::ldexp(max_ratio, shift + 1)) <= kMaxAddScaleRatio) {
+        ++shift;
+    }
+    AddParams params;
+    const auto to_multiplier = [shift](double ratio) {
+        return static_cast<int16_t>(std::lround(std::ldexp(ratio, shift)));
+    };
+    params.lhs_multiplier = to_multiplier(lhs_ratio);
+    params.rhs_multiplier = to_multiplier(rhs_ratio);
+    params.shift = shift;
+    params.lhs_zero_point = lhs_zero_point;
+    params.rhs_zero_point = rhs_zero_point;
+    params.out_zero_point = out_zero_point;
+    return params;
+}
+
+// SECTION: Multiply
+template <class Q>
+void mulScalar(const Q* lhs, const Q* rhs, Q* out, int64_t n, const MulParams& p) {
+    for (int64_t i = 0; i < n; ++i) {
+        const int32_t product = (lhs[i] - p.lhs_zero_point) * (rhs[i] - p.rhs_zero_point);
+        float value = static_cast<float>(product) * p.scale;
+        value = value > p.low ? value : p.low;
+        value = value < p.high ? value : p.high;
+        out[i] = static_cast<Q>(static_cast<int32_t>(std::nearbyint(value))
+                                + p.out_zero_point);
+    }
+}
+
+template <class Q>
+MulParams makeMulParams(float lhs_scale,
+                        int32_t lhs_zero_point,
+                        float rhs_scale,
+                        int32_t rhs_zero_point,
+                        float out_scale,
+                        int32_t out_zero_point) {
+    MulParams params;
+    const double scale = static_cast<double>(lhs_scale) * rhs_scale / out_scale;
+    params.scale = static_cast<float>(scale);
+    params.low = static_cast<float>(kQuantizedMin<Q> - out_zero_point);
+    params.high = static_cast<float>(kQuantizedMax<Q> - out_zero_point);
+    params.lhs_zero_point = lhs_zero_point;
+    params.rhs_zero_point = rhs_zero_point;
+    params.out_zero_point = out_zero_point;
+    return params;
+}
+
+#if NOPE_X86_DISPATCH
+// Bytes are widened with sign or zero extension depending on the quantized type
+template <class Q>
+NOPE_TARGET_AVX2 inline __m256i widen16Avx2(__m128i bytes) noexcept {
+    return std::is_signed_v<Q> ? _mm256_cvtepi8_epi16(bytes)
+                               : _mm256_cvtepu8_epi16(bytes);
+}
+
+template <class Q>
+NOPE_TARGET_AVX2 inline __m256i widen32Avx2(__m128i bytes) noexcept {
+    return std::is_signed_v<Q> ? _mm256_cvtepi8_epi32(bytes)
+                               : _mm256_cvtepu8_epi32(bytes);
+}
+
+/// Saturates 8 int32 lanes into 8 bytes in the low half of the result
+template <class Q>
+NOPE_TARGET_AVX2 inline __m128i narrow32Avx2(__m256i values) noexcept {
+    const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(values),
+                                          _mm256_extracti128_si256(values, 1));
+    return std::is_signed_v<Q> ? _mm_packs_epi16(words, words)
+                               : _mm_packus_epi16(words, words);
+}
+
+template <class Q>
+NOPE_TARGET_AVX2 void quantizeAvx2(const float* src,
+                                   Q* dst,
+                                   int64_t n,
+                                   float scale,
+                                   int32_t zero_point) {
+    const __m256 inv_scale = _mm256_set1_ps(1.0F / scale);
+    const __m256 low = _mm256_set1_ps(static_cast<float>(kQuantizedMin<Q> - zero_point));
+    const __m256 high = _mm256_set1_ps(static_cast<float>(kQuantizedMax<Q> - zero_point));
+    const __m256i zp = _mm256_set1_epi32(zero_point);
+    const int64_t vector_end = n - n % 8;
+    int64_t i = 0;
+    for (; i < vector_end; i += 8) {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(src + i), inv_scale);
+        // max/min return the second operand for NaNs, the same as the scalar code
+        value = _mm256_min_ps(_mm256_max_ps(value, low), high);
+        const __m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(value), zp);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), narrow32Avx2<Q>(q));
+    }
+    quantizeScalar(src + i, dst + i, n - i, scale, zero_point);
+}
+
+template <class Q>
+NOPE_TARGET_AVX2 void addAvx2(const Q* lhs, const Q* rhs, Q* out, int64_t n,
+                              const AddParams& p) {
+    const __m256i lhs_zp = _mm256_set1_epi16(static_cast<int16_t>(p.lhs_zero_point));
+    const __m256i rhs_zp = _mm256_set1_epi16(static_cast<int16_t>(p.rhs_zero_point));
+    // (lhs, rhs) pairs of 16-bit values are multiplied and summed by vpmaddwd
+    const __m256i multipliers = _mm256_set1_epi32(p.packedMultipliers());
+    const __m256i rounding = _mm256_set1_epi32(p.shift > 0 ? 1 << (p.shift - 1) : 0);
+    const __m128i shift = _mm_cvtsi32_si128(p.shift);
+    const __m256i out_zp = _mm256_set1_epi32(p.out_zero_point);
+    const int64_t vector_end = n - n % 16;
+    int64_t i = 0;
+    for (; i < vector_end; i += 16) {
+        const __m256i a = _mm256_sub_epi16(
+            widen16Avx2<Q>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i))),
+            lhs_zp);
+        const __m256i b = _mm256_sub_epi16(
+            widen16Avx2<Q>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i))),
+            rhs_zp);
+        // Unpacking and packing work within 128-bit lanes, so the order is restored
+        __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), multipliers);
+        __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), multipliers);
+        lo = _mm256_add_epi32(_mm256_sra_epi32(_mm256_add_epi32(lo, rounding), shift),
+                              out_zp);
+        hi = _mm256_add_epi32(_mm256_sra_epi32(_mm256_add_epi32(hi, rounding), shift),
+                              out_zp);
+        const __m256i words = _mm256_packs_epi32(lo, hi);
+        const __m128i words_lo = _mm256_castsi256_si128(words);
+        const __m128i words_hi = _mm256_extracti128_si256(words, 1);
+        const __m128i bytes = std::is_signed_v<Q> ? _mm_packs_epi16(words_lo, words_hi)
+                                                  : _mm_packus_epi16(words_lo, words_hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    addScalar(lhs + i, rhs + i, out + i, n - i, p);
+}
+
+template <class Q>
+NOPE_TARGET_AVX2 void mulAvx2(const Q* lhs, const Q* rhs, Q* out, int64_t n,
+                              const MulParams& p) {
+    const __m256i lhs_zp = _mm256_set1_epi32(p.lhs_zero_point);
+    const __m256i rhs_zp = _mm256_set1_epi32(p.rhs_zero_point);
+    const __m256 scale = _mm256_set1_ps(p.scale);
+    const __m256 low = _mm256_set1_ps(p.low);
+    const __m256 high = _mm256_set1_ps(p.high);
+    const __m256i out_zp = _mm256_set1_epi32(p.out_zero_point);
+    const int64_t vector_end = n - n % 8;
+    int64_t i = 0;
+    for (; i < vector_end; i += 8) {
+        const __m256i a = _mm256_sub_epi32(
+            widen32Avx2<Q>(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lhs + i))),
+            lhs_zp);
+        const __m256i b = _mm256_sub_epi32(
+            widen32Avx2<Q>(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rhs + i))),
+            rhs_zp);
+        __m256 value = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_mullo_epi32(a, b)), scale);
+        value = _mm256_min_ps(_mm256_max_ps(value, low), high);
+        const __m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(value), out_zp);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), narrow32Avx2<Q>(q));
+    }
+    mulScalar(lhs + i, rhs + i, out + i, n - i, p);
+}
+
+template <class Q>
+NOPE_TARGET_AVX512 inline __m512i loadWiden16Avx512(const Q* src) noexcept {
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    return std::is_signed_v<Q> ? _mm512_cvtepi8_epi16(bytes)
+                               : _mm512_cvtepu8_epi16(bytes);
+}
+
+/// Shifts, offsets and saturates two halves of 32 int32 accumulators into bytes
+template <class Q>
+NOPE_TARGET_AVX512 inline void storeRequantizedAvx512(Q* dst,
+                                                      __m512i lo,
+                                                      __m512i hi,
+                                                      __m128i shift,
+                                                      __m512i out_zp) noexcept {
+    // Zero masked forms with all lanes selected are used, because GCC warns about
+    // undefined pass-through operands of the plain intrinsics
+    const auto all_dwords = static_cast<__mmask16>(0xFFFF);
+    const auto all_bytes = static_cast<__mmask32>(0xFFFFFFFF);
+    lo = _mm512_add_epi32(_mm512_maskz_sra_epi32(all_dwords, lo, shift), out_zp);
+    hi = _mm512_add_epi32(_mm512_maskz_sra_epi32(all_dwords, hi, shift), out_zp);
+    const __m512i words = _mm512_packs_epi32(lo, hi);
+    __m256i bytes;
+    if constexpr (std::is_signed_v<Q>) {
+        bytes = _mm512_maskz_cvtsepi16_epi8(all_bytes, words);
+    } else {
+        bytes = _mm512_maskz_cvtusepi16_epi8(
+            all_bytes, _mm512_max_epi16(words, _mm512_setzero_si512()));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), bytes);
+}
+
+/**
+ * \brief Loop invariants of the AVX-512 add kernels.
+ */
+struct AddConstantsAvx512 {
+    __m512i lhs_zp;
+    __m512i rhs_zp;
+    __m512i multipliers;
+    __m512i rounding;
+    __m128i shift;
+    __m512i out_zp;
+};
+
+NOPE_TARGET_AVX512 inline AddConstantsAvx512
+addConstantsAvx512(const AddParams& p) noexcept {
+    AddConstantsAvx512 c;
+    c.lhs_zp = _mm512_set1_epi16(static_cast<int16_t>(p.lhs_zero_point));
+    c.rhs_zp = _mm512_set1_epi16(static_cast<int16_t>(p.rhs_zero_point));
+    c.multipliers = _mm512_set1_epi32(p.packedMultipliers());
+    c.rounding = _mm512_set1_epi32(p.shift > 0 ? 1 << (p.shift - 1) : 0);
+    c.shift = _mm_cvtsi32_si128(p.shift);
+    c.out_zp = _mm512_set1_epi32(p.out_zero_point);
+    return c;
+}
+
+template <class Q>
+NOPE_TARGET_AVX512 void addAvx512(const Q* lhs, const Q* rhs, Q* out, int64_t n,
+                                  const AddParams& p) {
+    const AddConstantsAvx512 c = addConstantsAvx512(p);
+    const int64_t vector_end = n - n % 32;
+    int64_t i = 0;
+    for (; i < vector_end; i += 32) {
+        const __m512i a = _mm512_sub_epi16(loadWiden16Avx512(lhs + i), c.lhs_zp);
+        const __m512i b = _mm512_sub_epi16(loadWiden16Avx512(rhs + i), c.rhs_zp);
+        const __m512i lo = _mm512_add_epi32(
+            c.rounding, _mm512_madd_epi16(_mm512_unpacklo_epi16(a, b), c.multipliers));
+        const __m512i hi = _mm512_add_epi32(
+            c.rounding, _mm512_madd_epi16(_mm512_unpackhi_epi16(a, b), c.multipliers));
+        storeRequantizedAvx512(out + i, lo, hi, c.shift, c.out_zp);
+    }
+    addScalar(lhs + i, rhs + i, out + i, n - i, p);
+}
+
+// VNNI fuses multiplication of 16-bit pairs with accumulation into the rounding term
+template <class Q>
+NOPE_TARGET_AVX512_VNNI void addAvx512Vnni(const Q* lhs, const Q* rhs, Q* out, int64_t n,
+                                           const AddParams& p) {
+    const AddConstantsAvx512 c = addConstantsAvx512(p);
+    const int64_t vector_end = n - n % 32;
+    int64_t i = 0;
+    for (; i < vector_end; i += 32) {
+        const __m512i a = _mm512_sub_epi16(loadWiden16Avx512(lhs + i), c.lhs_zp);
+        const __m512i b = _mm512_sub_epi16(loadWiden16Avx512(rhs + i), c.rhs_zp);
+        const __m512i lo =
+            _mm512_dpwssd_epi32(c.rounding, _mm512_unpacklo_epi16(a, b), c.multipliers);
+        const __m512i hi =
+            _mm512_dpwssd_epi32(c.rounding, _mm512_unpackhi_epi16(a, b), c.multipliers);
+        storeRequantizedAvx512(out + i, lo, hi, c.shift, c.out_zp);
+    }
+    addScalar(lhs + i, rhs + i, out + i, n - i, p);
+}
+#endif
+
+template <class Q>
+using AddKernel = void (*)(const Q*, const Q*, Q*, int64_t, const AddParams&);
+
+template <class Q>
+using MulKernel = void (*)(const Q*, const Q*, Q*, int64_t, const MulParams&);
+
+template <class Q>
+AddKernel<Q> selectAddKernel() noexcept {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx512_vnni) {
+        return &addAvx512Vnni<Q>;
+    }
+    if (cpuFeatures().avx512) {
+        return &addAvx512<Q>;
+    }
+    if (cpuFeatures().avx2) {
+        return &addAvx2<Q>;
+    }
+#endif
+    return &addScalar<Q>;
+}
+
+template <class Q>
+MulKernel<Q> selectMulKernel() noexcept {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return &mulAvx2<Q>;
+    }
+#endif
+    return &mulScalar<Q>;
+}
+
+template <class Q>
+void quantizeFloat(const float* src, Q* dst, int64_t n, float scale, int32_t zero_point) {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return quantizeAvx2(src, dst, n, scale, zero_point);
+    }
+#endif
+    quantizeScalar(src, dst, n, scale, zero_point);
+}
+
+const QuantizationParams& checkedQuantization(const Tensor& tensor, const char* name) {
+    if (!tensor.isQuantized()) {
+        throw std::invalid_argument(std::string(name) + " tensor is not quantized");
+    }
+    return *tensor.quantization();
+}
+
+/**
+ * \brief Common axis of the per axis parameters, -1 if all are per tensor.
+ */
+int64_t commonAxis(std::initializer_list<const QuantizationParams*> params) {
+    int64_t axis = -1;
+    for (const auto* p : params) {
+        if (!p->isPerAxis()) {
+            continue;
+        }
+        if (axis >= 0 && p->axis != axis) {
+            throw std::invalid_argument("Per axis quantization parameters have different "
+                                        "axes: "
+                                        + std::to_string(axis) + " and "
+                                        + std::to_string(p->axis));
+        }
+        axis = p->axis;
+    }
+    return axis;
+}
+
+/**
+ * \brief Shared part of binary quantized operations: validates operands,
+ * allocates the result and invokes \a kernel for every run of elements with
+ * per channel constants made by \a make_params.
+ */
+template <class MakeKernel, class MakeParams>
+Tensor quantizedBinaryOp(const Tensor& lhs,
+                         const Tensor& rhs,
+                         const QuantizationParams& out_params,
+                         MakeKernel&& make_kernel,
+                         MakeParams&& make_params) {
+    const auto& lhs_params = checkedQuantization(lhs, "Left");
+    const auto& rhs_params = checkedQuantization(rhs, "Right");
+    if (lhs.dtype() != rhs.dtype()) {
+        throw TypesMismatchError("Quantized operands data types are different: "
+                                 + to_string(lhs.dtype()) + " and "
+                                 + to_string(rhs.dtype()));
+    }
+    if (lhs.shape() != rhs.shape()) {
+        throw std::length_error("Quantized operands shapes are different");
+    }
+    const int64_t axis = commonAxis({&lhs_params, &rhs_params, &out_params});
+    Tensor out(lhs.shape(), lhs.dtype());
+    out.setQuantization(out_params);
+
+    const Tensor lhs_contiguous = lhs.contiguous();
+    const Tensor rhs_contiguous = rhs.contiguous();
+    dispatchDataType(QuantizedTypes{}, lhs.dtype(), "quantized", [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        const int64_t channels = axis >= 0 ? lhs.dim(static_cast<size_t>(axis)) : 1;
+        using Params = decltype(make_params(tag, 0.0F, 0, 0.0F, 0, 0.0F, 0));
+        std::vector<Params> channel_params;
+        channel_params.reserve(static_cast<size_t>(channels));
+        for (int64_t channel = 0; channel < channels; ++channel) {
+            channel_params.push_back(make_params(tag,
+                                                 lhs_params.scale(channel),
+                                                 lhs_params.zeroPoint(channel),
+                                                 rhs_params.scale(channel),
+                                                 rhs_params.zeroPoint(channel),
+                                                 out_params.scale(channel),
+                                                 out_params.zeroPoint(channel)));
+        }
+        const auto kernel = make_kernel(tag);
+        const Q* a = lhs_contiguous.unsafeData<Q>();
+        const Q* b = rhs_contiguous.unsafeData<Q>();
+        Q* c = out.unsafeData<Q>();
+        forEachChannelRun(out.shape(), axis, [&](int64_t i, int64_t n, int64_t channel) {
+            kernel(a + i, b + i, c + i, n, channel_params[static_cast<size_t>(channel)]);
+        });
+    });
+    return out;
+}
+} // namespace
+} // namespace detail
+
+QuantizationParams QuantizationParams::perTensor(float scale, int32_t zero_point) {
+    QuantizationParams params;
+    params.scales = {scale};
+    params.zero_points = {zero_point};
+    return params;
+}
+
+QuantizationParams QuantizationParams::perAxis(std::vector<float> scales,
+                                               std::vector<int32_t> zero_points,
+                                               int64_t axis) {
+    if (axis < 0) {
+        throw std::out_of_range("Quantization axis should be non-negative, got: "
+                                + std::to_string(axis));
+    }
+    QuantizationParams params;
+    params.scales = std::move(scales);
+    params.zero_points = std::move(zero_points);
+    params.axis = axis;
+    return params;
+}
+
+bool operator==(const QuantizationParams& lhs, const QuantizationParams& rhs) noexcept {
+    return lhs.axis == rhs.axis && lhs.scales == rhs.scales
+           && lhs.zero_points == rhs.zero_points;
+}
+
+Tensor
+quantize(const Tensor& src, const QuantizationParams& params, TensorDataType dtype) {
+    if (!src.dtype().isFloatingPoint()) {
+        throw TypesMismatchError("Expected floating point data type, got: "
+                                 + to_string(src.dtype()));
+    }
+    Tensor out(src.shape(), dtype);
+    out.setQuantization(params);
+    const Tensor src_contiguous = src.contiguous();
+    detail::dispatchDataType(detail::QuantizedTypes{}, dtype, "quantized", [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        Q* dst = out.unsafeData<Q>();
+        const std::byte* data = src_contiguous.data();
+        const bool is_float = src.dtype() == TensorDataType::Float32;
+        detail::forEachChannelRun(
+            src.shape(), params.axis, [&](int64_t i, int64_t n, int64_t channel) {
+                if (is_float) {
+                    detail::quantizeFloat(reinterpret_cast<const float*>(data) + i,
+                                          dst + i,
+                                          n,
+                                          params.scale(channel),
+                                          params.zeroPoint(channel));
+                } else {
+                    detail::quantizeScalar(reinterpret_cast<const double*>(data) + i,
+                                           dst + i,
+                                           n,
+                                           params.scale(channel),
+                                           params.zeroPoint(channel));
+                }
+            });
+    });
+    return out;
+}
+
+Tensor dequantize(const Tensor& src) {
+    const auto& params = detail::checkedQuantization(src, "Dequantized");
+    Tensor out(src.shape(), TensorDataType::Float32);
+    const Tensor src_contiguous = src.contiguous();
+    const TensorDataType dtype = src.dtype();
+    detail::dispatchDataType(detail::QuantizedTypes{}, dtype, "quantized", [&](auto tag) {
+        using Q = typename decltype(tag)::type;
+        const Q* data = src_contiguous.unsafeData<Q>();
+        float* dst = out.unsafeData<float>();
+        detail::forEachChannelRun(
+            src.shape(), params.axis, [&](int64_t i, int64_t n, int64_t channel) {
+                detail::dequantizeScalar(data + i,
+                                         dst + i,
+                                         n,
+                                         params.scale(channel),
+                                         params.zeroPoint(channel));
+            });
+    });
+    return out;
+}
+
+Tensor quantizedAdd(const Tensor& lhs,
+                    const Tensor& rhs,
+                    const QuantizationParams& out_params) {
+    return detail::quantizedBinaryOp(
+        lhs,
+        rhs,
+        out_params,
+        [](auto tag) {
+            return detail::selectAddKernel<typename decltype(tag)::type>();
+        },
+        [](auto /* tag */, auto... scales_and_zero_points) {
+            return detail::makeAddParams(scales_and_zero_points...);
+        });
+}
+
+Tensor quantizedMul(const Tensor& lhs,
+                    const Tensor& rhs,
+                    const QuantizationParams& out_params) {
+    return detail::quantizedBinaryOp(
+        lhs,
+        rhs,
+        out_params,
+        [](auto tag) {
+            return detail::selectMulKernel<typename decltype(tag)::type>();
+        },
+        [](auto tag, auto... scales_and_zero_points) {
+            using Q = typename decltype(tag)::type;
+            return detail::makeMulParams<Q>(scales_and_zero_points...);
+        });
+}
+} // namespace nope
@@ -0,0 +1,89 @@
+#include "quantization_bindings.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nope/quantization.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+void registerQuantizationBindings(py::module_& module) {
+    py::class_<QuantizationParams>(module, "QuantizationParams")
+        .def_static("per_tensor",
+                    &QuantizationParams::perTensor,
+                    py::arg("scale"),
+                    py::arg("zero_point") = 0)
+        .def_static("per_axis",
+                    &QuantizationParams::perAxis,
+                    py::arg("scales"),
+                    py::arg("zero_points"),
+                    py::arg("axis"))
+        .def_readonly("scales", &QuantizationParams::scales)
+        .def_readonly("zero_points", &QuantizationParams::zero_points)
+        .def_readonly("axis", &QuantizationParams::axis)
+        .def_property_readonly("is_per_axis", &QuantizationParams::isPerAxis)
+        .def("__eq__",
+             [](const QuantizationParams& lhs, const QuantizationParams& rhs) {
+                 return lhs == rhs;
+             })
+        .def("__repr__",
+             [](const QuantizationParams& params) {
+                 return "QuantizationParams(scales="
+                        + py::repr(py::cast(params.scales)).cast<std::string>()
+                        + ", zero_points="
+                        + py::repr(py::cast(params.zero_points)).cast<std::string>()
+                        + ", axis=" + std::to_string(params.axis) + ")";
+             })
+        .def(py::pickle(
+            [](const QuantizationParams& params) {
+                return py::make_tuple(params.scales, params.zero_points, params.axis);
+            },
+            [](const py::tuple& state) {
+                QuantizationParams params;
+                params.scales = state[0].cast<std::vector<float>>();
+                params.zero_points = state[1].cast<std::vector<int32_t>>();
+                params.axis = state[2].cast<int64_t>();
+                return params;
+            }));
+
+    module.def(
+        "quantize",
+        [](const Tensor& src, const QuantizationParams& params, TensorDataType dtype) {
+            py::gil_scoped_release release;
+            return quantize(src, params, dtype);
+        },
+        py::arg("tensor"),
+        py::arg("params"),
+        py::arg("dtype") = TensorDataType(TensorDataType::Int8));
+    module.def(
+        "dequantize",
+        [](const Tensor& src) {
+            py::gil_scoped_release release;
+            return dequantize(src);
+        },
+        py::arg("tensor"));
+    module.def(
+        "quantized_add",
+        [](const Tensor& lhs, const Tensor& rhs, const QuantizationParams& params) {
+            py::gil_scoped_release release;
+            return quantizedAdd(lhs, rhs, params);
+        },
+        py::arg("lhs"),
+        py::arg("rhs"),
+        py::arg("out_params"));
+    module.def(
+        "quantized_mul",
+        [](const Tensor& lhs, const Tensor& rhs, const QuantizationParams& params) {
+            py::gil_scoped_release release;
+            return quantizedMul(lhs, rhs, params);
+        },
+        py::arg("lhs"),
+        py::arg("rhs"),
+        py::arg("out_params"));
+}
+} // namespace nope
@@ -0,0 +1,343 @@
+#include "nope/random.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "cpu_features.h"
+#include "nope/parallel.h"
+#include "nope/strided_copy.h"
+#include "type_dispatch.h"
+
+#if NOPE_X86_DISPATCH
+    #include <immintrin.h>
+#endif
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kRandomGrainElements = 64 * 1024;
+/// Number of generator blocks produced at once by a single thread
+constexpr int64_t kBlocksBatch = 256;
+
+constexpr uint32_t kPhiloxM0 = 0xD2511F53U;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57U;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9U;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85U;
+constexpr int kPhiloxRounds = 10;
+
+using PhiloxBlock = std::array<uint32_t, 4>;
+
+inline uint32_t mulhilo(uint32_t a, uint32_t b, uint32_t& hi) noexcept {
+    const uint64_t product = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    return static_cast<uint32_t>(product);
+}
+
+/**
+ * \brief Philox4x32-10 applied to counter {counter_lo, counter_hi, 0, 0}.
+ */
+PhiloxBlock philox(uint64_t counter, uint64_t key) noexcept {
+    PhiloxBlock c{
+        static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0};
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+    for (int round = 0; round < kPhiloxRounds; ++round) {
+        uint32_t hi0;
+        uint32_t hi1;
+        const uint32_t lo0 = mulhilo(kPhiloxM0, c[0], hi0);
+        const uint32_t lo1 = mulhilo(kPhiloxM1, c[2], hi1);
+        c = {hi1 ^ c[1] ^ k0, lo1, hi0 ^ c[3] ^ k1, lo0};
+        k0 += kPhiloxW0;
+        k1 += kPhiloxW1;
+    }
+    return c;
+}
+
+void philoxBlocksScalar(uint64_t first_counter,
+                        uint64_t key,
+                        PhiloxBlock* blocks,
+                        int64_t n_blocks) noexcept {
+    for (int64_t i = 0; i < n_blocks; ++i) {
+        blocks[i] = philox(first_counter + static_cast<uint64_t>(i), key);
+    }
+}
+
+#if NOPE_X86_DISPATCH
+NOPE_TARGET_AVX2 inline __m256i mulhiloAvx2(__m256i m, __m256i x, __m256i& hi) noexcept {
+    const __m256i even = _mm256_mul_epu32(x, m);
+    const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+}
+
+/**
+ * \brief Generates 8 Philox blocks per iteration keeping each of the 4 counter
+ * words of 8 blocks in its own register.
+ */
+NOPE_TARGET_AVX2 void philoxBlocksAvx2(uint64_t first_counter,
+                                       uint64_t key,
+                                       PhiloxBlock* blocks,
+                                       int64_t n_blocks) noexcept {
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(kPhiloxM0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(kPhiloxM1));
+    const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const int64_t vector_end = n_blocks - n_blocks % 8;
+    int64_t i = 0;
+    for (; i < vector_end; i += 8) {
+        const uint64_t counter = first_counter + static_cast<uint64_t>(i);
+        // Low counter words might wrap inside the batch, fall back to scalar then
+        if (static_cast<uint32_t>(counter) > std::numeric_limits<uint32_t>::max() - 7) {
+            break;
+        }
+        __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(counter)),
+                                      lane_offsets);
+        __m256i c1 = _mm256_set1_epi32(static_cast<int>(counter >> 32));
+        __m256i c2 = _mm256_setzero_si256();
+        __m256i c3 = _mm256_setzero_si256();
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < kPhiloxRounds; ++round) {
+            __m256i hi0;
+            __m256i hi1;
+            const __m256i lo0 = mulhiloAvx2(m0, c0, hi0);
+            const __m256i lo1 = mulhiloAvx2(m1, c2, hi1);
+            const __m256i key0 = _mm256_set1_epi32(static_cast<int>(k0));
+            const __m256i key1 = _mm256_set1_epi32(static_cast<int>(k1));
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), key0);
+            c1 = lo1;
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), key1);
+            c3 = lo0;
+            k0 += kPhiloxW0;
+            k1 += kPhiloxW1;
+        }
+        // Transpose 4 words x 8 blocks into 8 consecutive blocks
+        const __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+        const __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+        const __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+        const __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+        const __m256i b01 = _mm256_unpacklo_epi64(t0, t2);
+        const __m256i b23 = _mm256_unpackhi_epi64(t0, t2);
+        const __m256i b45 = _mm256_unpacklo_epi64(t1, t3);
+        const __m256i b67 = _mm256_unpackhi_epi64(t1, t3);
+        auto* dst = reinterpret_cast<__m256i*>(blocks + i);
+        _mm256_storeu_si256(dst + 0, _mm256_permute2x128_si256(b01, b23, 0x20));
+        _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(b45, b67, 0x20));
+        _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(b01, b23, 0x31));
+        _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(b45, b67, 0x31));
+    }
+    philoxBlocksScalar(first_counter + static_cast<uint64_t>(i), key, blocks + i,
+                       n_blocks - i);
+}
+#endif
+
+void philoxBlocks(uint64_t first_counter,
+                  uint64_t key,
+                  PhiloxBlock* blocks,
+                  int64_t n_blocks) noexcept {
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        return philoxBlocksAvx2(first_counter, key, blocks, n_blocks);
+    }
+#endif
+    philoxBlocksScalar(first_counter, key, blocks, n_blocks);
+}
+
+/// Uniform float in [0, 1) from 24 high bits
+inline float uniformFloat(uint32_t bits) noexcept {
+    return static_cast<float>(bits >> 8) * (1.0F / 16777216.0F);
+}
+
+/// Uniform double in [0, 1) from 53 high bits
+inline double uniformDouble(uint32_t hi, uint32_t lo) noexcept {
+    const uint64_t bits = (static_cast<uint64_t>(hi) << 32) | lo;
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/// High 64 bits of 64x64 bits product
+inline uint64_t mulhi64(uint64_t a, uint64_t b) noexcept {
+    const uint64_t a_lo = a & 0xFFFFFFFFU;
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFFU;
+    const uint64_t b_hi = b >> 32;
+    const uint64_t lo_lo = a_lo * b_lo;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t lo_hi = a_lo * b_hi;
+    const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFU) + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/**
+ * \brief Word \a attempt of the stream redrawing rejected element \a index,
+ * independent of the main stream and of the number of threads.
+ */
+uint32_t redrawWord(uint64_t index, uint64_t seed, int64_t attempt) noexcept {
+    constexpr uint64_t kRedrawKeyStep = 0x9E3779B97F4A7C15ULL;
+    const PhiloxBlock block =
+        philox(index, seed + kRedrawKeyStep * static_cast<uint64_t>(attempt / 4 + 1));
+    return block[static_cast<size_t>(attempt % 4)];
+}
+
+/**
+ * \brief Fills contiguous \a out in parallel. Element \a i is produced by
+ * \a convert(block, i % ElementsPerBlock) from the block \a i / ElementsPerBlock,
+ * converters taking the third argument also receive \a i.
+ */
+template <class T, int64_t ElementsPerBlock, class Convert>
+void fillFromBlocks(Tensor& out, uint64_t seed, Convert&& convert) {
+    Tensor dst = out.isContiguous() ? out : Tensor(out.shape(), out.dtype());
+    T* data = dst.unsafeData<T>();
+    const int64_t n = dst.numel();
+    parallelFor(0, n, kRandomGrainElements, [&](int64_t begin, int64_t end) {
+        std::array<PhiloxBlock, kBlocksBatch> blocks;
+        int64_t i = begin;
+        while (i < end) {
+            const int64_t first_block = i / ElementsPerBlock;
+            const int64_t last_block = (end - 1) / ElementsPerBlock;
+            const int64_t n_blocks = std::min(kBlocksBatch, last_block - first_block + 1);
+            philoxBlocks(
+                static_cast<uint64_t>(first_block), seed, blocks.data(), n_blocks);
+            const int64_t batch_end =
+                std::min(end, (first_block + n_blocks) * ElementsPerBlock);
+            for (; i < batch_end; ++i) {
+                const auto& block = blocks[static_cast<size_t>(i / ElementsPerBlock
+                                                               - first_block)];
+                if constexpr (std::is_invocable_v<Convert,
+                                                   const PhiloxBlock&,
+                                                   int64_t,
+                                                   int64_t>) {
+                    data[i] = convert(block, i % ElementsPerBlock, i);
+                } else {
+                    data[i] = convert(block, i % ElementsPerBlock);
+                }
+            }
+        }
+    });
+    if (dst.data() != out.data()) {
+        copyStrided(dst, out);
+    }
+}
+
+void checkFloatingPoint(const Tensor& out) {
+    if (!out.dtype().isFloatingPoint()) {
+        throw TypesMismatchError("Expected floating point data type, got: "
+                                 + to_string(out.dtype()));
+    }
+}
+} // namespace
+} // namespace detail
+
+void fillUniform(Tensor& out, double low, double high, uint64_t seed) {
+    detail::checkFloatingPoint(out);
+    if (out.dtype() == TensorDataType::Float32) {
+        const auto f_low = static_cast<float>(low);
+        const auto f_range = static_cast<float>(high - low);
+        // Rounding of the product or the sum might reach the excluded bound
+        const float f_max = std::nextafter(static_cast<float>(high), f_low);
+        detail::fillFromBlocks<float, 4>(
+            out, seed, [&](const detail::PhiloxBlock& block, int64_t j) {
+                const uint32_t bits = block[static_cast<size_t>(j)];
+                return std::min(f_low + f_range * detail::uniformFloat(bits), f_max);
+            });
+        return;
+    }
+    const double range = high - low;
+    const double max = std::nextafter(high, low);
+    detail::fillFromBlocks<double, 2>(
+        out, seed, [&](const detail::PhiloxBlock& block, int64_t j) {
+            const auto w = static_cast<size_t>(2 * j);
+            return std::min(low + range * detail::uniformDouble(block[w], block[w + 1]),
+                            max);
+        });
+}
+
+void fillNormal(Tensor& out, double mean, double stddev, uint64_t seed) {
+    detail::checkFloatingPoint(out);
+    constexpr double kTwoPi = 6.283185307179586476925286766559;
+    if (out.dtype() == TensorDataType::Float32) {
+        const auto f_mean = static_cast<float>(mean);
+        const auto f_stddev = static_cast<float>(stddev);
+        // Each pair of block words produces a pair of normal values
+        detail::fillFromBlocks<float, 4>(
+            out, seed, [&](const detail::PhiloxBlock& block, int64_t j) {
+                const auto w = static_cast<size_t>(j & ~int64_t{1});
+                // Shift into (0, 1] to avoid log(0)
+                const float u1 = detail::uniformFloat(block[w]) + (1.0F / 16777216.0F);
+                const float u2 = detail::uniformFloat(block[w + 1]);
+                const float r = std::sqrt(-2.0F * std::log(u1));
+                const float theta = static_cast<float>(kTwoPi) * u2;
+                const float z = (j & 1) ? r * std::sin(theta) : r * std::cos(theta);
+                return f_mean + f_stddev * z;
+            });
+        return;
+    }
+    detail::fillFromBlocks<double, 2>(
+        out, seed, [&](const detail::PhiloxBlock& block, int64_t j) {
+            const double u1 = detail::uniformDouble(block[0], block[1])
+                              + (1.0 / 9007199254740992.0);
+            const double u2 = detail::uniformDouble(block[2], block[3]);
+            const double r = std::sqrt(-2.0 * std::log(u1));
+            const double theta = kTwoPi * u2;
+            const double z = (j & 1) ? r * std::sin(theta) : r * std::cos(theta);
+            return mean + stddev * z;
+        });
+}
+
+void fillRandInt(Tensor& out, int64_t low, int64_t high, uint64_t seed) {
+    if (low >= high) {
+        throw std::out_of_range("Empty range [" + std::to_string(low) + ", "
+                                + std::to_string(high) + ")");
+    }
+    const uint64_t range = static_cast<uint64_t>(high) - static_cast<uint64_t>(low);
+    detail::dispatchIntegerDataType(out.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        using Limits = std::numeric_limits<T>;
+        const bool fits = std::is_signed_v<T>
+                              ? low >= static_cast<int64_t>(Limits::min())
+                                    && high - 1 <= static_cast<int64_t>(Limits::max())
+                              : low >= 0
+                                    && static_cast<uint64_t>(high - 1) <= Limits::max();
+        if (!fits) {
+            throw std::out_of_range("Range [" + std::to_string(low) + ", "
+                                    + std::to_string(high) + ") is not representable by "
+                                    + to_string(out.dtype()));
+        }
+        // Multiply-shift maps random word into the range without division, words
+        // with low product bits below the threshold are redrawn to remove the bias
+        if (range <= (uint64_t{1} << 32)) {
+            const uint64_t threshold = ((uint64_t{1} << 32) - range) % range;
+            detail::fillFromBlocks<T, 4>(
+                out,
+                seed,
+                [&](const detail::PhiloxBlock& block, int64_t j, int64_t i) {
+                    const auto index = static_cast<uint64_t>(i);
+                    uint64_t product = block[static_cast<size_t>(j)] * range;
+                    for (int64_t attempt = 0; (product & 0xFFFFFFFFU) < threshold;
+                         ++attempt) {
+                        product = detail::redrawWord(index, seed, attempt) * range;
+                    }
+                    return static_cast<T>(low + static_cast<int64_t>(product >> 32));
+                });
+            return;
+        }
+        const uint64_t threshold = (uint64_t{0} - range) % range;
+        detail::fillFromBlocks<T, 2>(
+            out, seed, [&](const detail::PhiloxBlock& block, int64_t j, int64_t i) {
+                const auto w = static_cast<size_t>(2 * j);
+                const auto index = static_cast<uint64_t>(i);
+                uint64_t bits = (static_cast<uint64_t>(block[w]) << 32) | block[w + 1];
+                for (int64_t attempt = 0; bits * range < threshold; attempt += 2) {
+                    const uint32_t hi = detail::redrawWord(index, seed, attempt);
+                    const uint32_t lo = detail::redrawWord(index, seed, attempt + 1);
+                    bits = (static_cast<uint64_t>(hi) << 32) | lo;
+                }
+                const uint64_t offset = detail::mulhi64(bits, range);
+                return static_cast<T>(static_cast<uint64_t>(low) + offset);
+            });
+    });
+}
+} // namespace nope
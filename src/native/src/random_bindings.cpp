@@ -0,0 +1,108 @@
+#include "random_bindings.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "nope/random.h"
+#include "nope/tensor.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+void registerRandomBindings(py::module_& module) {
+    auto random = module.def_submodule(
+        "random", "Reproducible counter-based (Philox4x32-10) random tensors");
+    random.def(
+        "uniform",
+        [](std::vector<int64_t> shape,
+           double low,
+           double high,
+           TensorDataType dtype,
+           uint64_t seed) {
+            py::gil_scoped_release release;
+            Tensor out(std::move(shape), dtype);
+            fillUniform(out, low, high, seed);
+            return out;
+        },
+        py::arg("shape"),
+        py::arg("low") = 0.0,
+        py::arg("high") = 1.0,
+        py::arg("dtype") = TensorDataType(TensorDataType::Float32),
+        py::arg("seed") = 0);
+    random.def(
+        "normal",
+        [](std::vector<int64_t> shape,
+           double mean,
+           double stddev,
+           TensorDataType dtype,
+           uint64_t seed) {
+            py::gil_scoped_release release;
+            Tensor out(std::move(shape), dtype);
+            fillNormal(out, mean, stddev, seed);
+            return out;
+        },
+        py::arg("shape"),
+        py::arg("mean") = 0.0,
+        py::arg("stddev") = 1.0,
+        py::arg("dtype") = TensorDataType(TensorDataType::Float32),
+        py::arg("seed") = 0);
+    random.def(
+        "randint",
+        [](std::vector<int64_t> shape,
+           int64_t low,
+           int64_t high,
+           TensorDataType dtype,
+           uint64_t seed) {
+            py::gil_scoped_release release;
+            Tensor out(std::move(shape), dtype);
+            fillRandInt(out, low, high, seed);
+            return out;
+        },
+        py::arg("shape"),
+        py::arg("low"),
+        py::arg("high"),
+        py::arg("dtype") = TensorDataType(TensorDataType::Int64),
+        py::arg("seed") = 0);
+    random.def(
+        "uniform_",
+        [](Tensor& out, double low, double high, uint64_t seed) {
+            {
+                py::gil_scoped_release release;
+                fillUniform(out, low, high, seed);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("low") = 0.0,
+        py::arg("high") = 1.0,
+        py::arg("seed") = 0);
+    random.def(
+        "normal_",
+        [](Tensor& out, double mean, double stddev, uint64_t seed) {
+            {
+                py::gil_scoped_release release;
+                fillNormal(out, mean, stddev, seed);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("mean") = 0.0,
+        py::arg("stddev") = 1.0,
+        py::arg("seed") = 0);
+    random.def(
+        "randint_",
+        [](Tensor& out, int64_t low, int64_t high, uint64_t seed) {
+            {
+                py::gil_scoped_release release;
+                fillRandInt(out, low, high, seed);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("low"),
+        py::arg("high"),
+        py::arg("seed") = 0);
+}
+} // namespace nope
@@ -1,6 +1,60 @@
 #include "nope/shape_and_strides_manipulation.h"
 
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
 namespace nope {
+namespace detail {
+int64_t coalesceDimensions(int64_t* shape,
+                           int64_t* const* strides,
+                           int64_t n_operands,
+                           int64_t dims) noexcept {
+    if (dims == 0) {
+        return 0;
+    }
+    int64_t last = 0;
+    for (int64_t dim = 1; dim < dims; ++dim) {
+        if (shape[dim] == 1) {
+            continue;
+        }
+        bool can_coalesce = true;
+        for (int64_t i = 0; i < n_operands && can_coalesce; ++i) {
+            can_coalesce = shape[dim] * strides[i][dim] == strides[i][last];
+        }
+        if (shape[last] != 1 && !can_coalesce) {
+            ++last;
+            shape[last] = shape[dim];
+        } else {
+            shape[last] = shape[last] * shape[dim];
+        }
+        for (int64_t i = 0; i < n_operands; ++i) {
+            strides[i][last] = strides[i][dim];
+        }
+    }
+    return last + 1;
+}
+
+std::pair<int64_t, int64_t> stridedExtent(const std::vector<int64_t>& shape,
+                                          const std::vector<int64_t>& strides,
+                                          int64_t element_size) noexcept {
+    int64_t lowest = 0;
+    int64_t highest = element_size;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (shape[i] <= 0) {
+            return {0, 0};
+        }
+        const int64_t reach = (shape[i] - 1) * strides[i];
+        if (reach < 0) {
+            lowest += reach;
+        } else {
+            highest += reach;
+        }
+    }
+    return {lowest, highest};
+}
+} // namespace detail
+
 void calculateEffectiveShapeAndStrides(std::vector<int64_t>& shape,
                                        std::vector<int64_t>& strides) {
     if (shape.size() != strides.size()) {
@@ -32,6 +86,9 @@ void fillContiguousStrides(const int64_t* shape,
                            int64_t* strides,
                            int64_t dims,
                            int64_t element_size) {
+    if (dims == 0) {
+        return;
+    }
     strides[dims - 1] = element_size;
     for (int64_t dim = dims - 2; dim >= 0; --dim) {
         strides[dim] = strides[dim + 1] * shape[dim + 1];
@@ -47,4 +104,12 @@ std::vector<int64_t> createContiguousStrides(const std::vector<int64_t>& shape,
     // clang-format on
     return strides;
 }
+int64_t normalizeAxis(int64_t axis, int64_t dims) {
+    if (axis < -dims || axis >= dims) {
+        throw std::out_of_range("Axis " + std::to_string(axis)
+                                + " is out of bounds for tensor of dimension "
+                                + std::to_string(dims));
+    }
+    return axis < 0 ? axis + dims : axis;
+}
 } // namespace nope
@@ -0,0 +1,196 @@
+#include "nope/shared_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "nope/quantization.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "nope/strided_copy.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define NOPE_HAS_SHARED_MEMORY 1
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#else
+    #define NOPE_HAS_SHARED_MEMORY 0
+#endif
+
+namespace nope {
+namespace detail {
+namespace {
+#if NOPE_HAS_SHARED_MEMORY
+struct Segment {
+    int fd{-1};
+    size_t mapped_size{0};
+};
+
+// Storage release hook receives only the data pointer, so descriptors and
+// mapping sizes are kept aside
+std::mutex segments_mutex;
+std::unordered_map<const std::byte*, Segment> segments;
+
+[[noreturn]] void throwSystemError(int error, const char* what) {
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+int createSegment(size_t size) {
+    #if defined(__linux__)
+    const int fd = memfd_create("nope_tensor", MFD_CLOEXEC);
+    #else
+    // Object is unlinked right away and lives as long as its descriptors
+    static std::atomic<uint64_t> counter{0};
+    const std::string name = "/nope_" + std::to_string(getpid()) + "_"
+                             + std::to_string(counter.fetch_add(1));
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+    #endif
+    if (fd < 0) {
+        throwSystemError(errno, "Failed to create shared memory segment");
+    }
+    // Empty mappings are not allowed
+    if (ftruncate(fd, static_cast<off_t>(std::max(size, size_t{1}))) != 0) {
+        const int error = errno;
+        close(fd);
+        throwSystemError(error, "Failed to resize shared memory segment");
+    }
+    return fd;
+}
+
+/**
+ * \brief Maps segment taking ownership of \a fd.
+ */
+std::byte* mapSegment(int fd, size_t size) {
+    const size_t mapped_size = std::max(size, size_t{1});
+    void* ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        const int error = errno;
+        close(fd);
+        throwSystemError(error, "Failed to map shared memory segment");
+    }
+    auto* data = static_cast<std::byte*>(ptr);
+    std::lock_guard<std::mutex> lock(segments_mutex);
+    segments[data] = Segment{fd, mapped_size};
+    return data;
+}
+
+void unmapSegment(std::byte* data) {
+    Segment segment;
+    {
+        std::lock_guard<std::mutex> lock(segments_mutex);
+        auto it = segments.find(data);
+        if (it == segments.end()) {
+            return;
+        }
+        segment = it->second;
+        segments.erase(it);
+    }
+    munmap(data, segment.mapped_size);
+    close(segment.fd);
+}
+
+/**
+ * \brief Creates tensor owning the mapped segment, unmaps it on failure.
+ */
+Tensor segmentTensor(std::byte* data,
+                     std::vector<int64_t> shape,
+                     std::vector<int64_t> strides,
+                     TensorDataType dtype) {
+    try {
+        return Tensor(data, std::move(shape), std::move(strides), dtype, &unmapSegment);
+    } catch (...) {
+        unmapSegment(data);
+        throw;
+    }
+}
+#else
+[[noreturn]] void throwNotSupported() {
+    throw std::runtime_error("Shared memory tensors are not supported on this platform");
+}
+#endif
+} // namespace
+} // namespace detail
+
+Tensor emptyShared(std::vector<int64_t> shape, TensorDataType dtype) {
+#if NOPE_HAS_SHARED_MEMORY
+    std::vector<int64_t> strides = createContiguousStrides(shape, dtype.ssize());
+    int64_t size = dtype.ssize();
+    for (const int64_t dim : shape) {
+        size *= dim;
+    }
+    const auto bytes_size = static_cast<size_t>(size);
+    std::byte* data = detail::mapSegment(detail::createSegment(bytes_size), bytes_size);
+    return detail::segmentTensor(data, std::move(shape), std::move(strides), dtype);
+#else
+    static_cast<void>(shape);
+    static_cast<void>(dtype);
+    detail::throwNotSupported();
+#endif
+}
+
+Tensor toSharedMemory(const Tensor& tensor) {
+    if (isSharedMemory(tensor)) {
+        return tensor;
+    }
+    Tensor shared = emptyShared(tensor.shape(), tensor.dtype());
+    copyStrided(tensor, shared);
+    if (const QuantizationParams* params = tensor.quantization()) {
+        shared.setQuantization(*params);
+    }
+    return shared;
+}
+
+bool isSharedMemory(const Tensor& tensor) noexcept {
+#if NOPE_HAS_SHARED_MEMORY
+    return tensor.storageBytesFree() == &detail::unmapSegment;
+#else
+    static_cast<void>(tensor);
+    return false;
+#endif
+}
+
+int sharedMemoryFd(const Tensor& tensor) {
+#if NOPE_HAS_SHARED_MEMORY
+    if (isSharedMemory(tensor)) {
+        std::lock_guard<std::mutex> lock(detail::segments_mutex);
+        const auto it = detail::segments.find(tensor.storageData());
+        if (it != detail::segments.end()) {
+            return it->second.fd;
+        }
+    }
+#endif
+    throw std::invalid_argument("Tensor storage is not a shared memory segment");
+}
+
+Tensor fromSharedMemory(int fd,
+                        size_t storage_size,
+                        std::vector<int64_t> shape,
+                        std::vector<int64_t> strides,
+                        int64_t storage_offset,
+                        TensorDataType dtype) {
+#if NOPE_HAS_SHARED_MEMORY
+    std::byte* data = detail::mapSegment(fd, storage_size);
+    const int64_t item_size = dtype.ssize();
+    const Tensor storage = detail::segmentTensor(
+        data, {static_cast<int64_t>(storage_size) / item_size}, {item_size}, dtype);
+    return storage.asStrided(std::move(shape), std::move(strides), storage_offset);
+#else
+    static_cast<void>(fd);
+    static_cast<void>(storage_size);
+    static_cast<void>(shape);
+    static_cast<void>(strides);
+    static_cast<void>(storage_offset);
+    static_cast<void>(dtype);
+    detail::throwNotSupported();
+#endif
+}
+} // namespace nope
@@ -0,0 +1,376 @@
+#include "nope/sorting.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "nd_offset_iterator.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+#include "type_dispatch.h"
+
+namespace nope {
+namespace detail {
+/**
+ * \brief Rows of the source tensor along the sorted axis and destinations of
+ * the first \a k sorted values and/or indices (nullptr if not requested).
+ */
+struct SortRowsArgs {
+    const int64_t* rows_shape{nullptr};
+    int64_t rows_dims{0};
+    std::array<const int64_t*, 3> rows_strides{};
+    int64_t n_rows{0};
+    int64_t row_size{0};
+    int64_t k{0};
+    bool descending{false};
+    bool with_indices{false};
+    const std::byte* src{nullptr};
+    int64_t src_axis_stride{0};
+    std::byte* values{nullptr};
+    int64_t values_axis_stride{0};
+    std::byte* indices{nullptr};
+    int64_t indices_axis_stride{0};
+};
+
+namespace {
+constexpr int64_t kRadixSortMinRowSize = 256;
+constexpr int64_t kHeapSelectRatio = 64;
+constexpr int64_t kSortGrainElements = 16 * 1024;
+
+template <size_t Size>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<1> {
+    using type = uint8_t;
+};
+
+template <>
+struct UnsignedOfSize<2> {
+    using type = uint16_t;
+};
+
+template <>
+struct UnsignedOfSize<4> {
+    using type = uint32_t;
+};
+
+template <>
+struct UnsignedOfSize<8> {
+    using type = uint64_t;
+};
+
+/**
+ * \brief Order preserving mapping of arithmetic values into unsigned keys:
+ * a < b if and only if encode(a) < encode(b).
+ *
+ * Floating point keys are not invertible: -0.0 is encoded as +0.0 and all
+ * NaNs as a single key, so sorted floating point values are gathered from the
+ * source by sorted indices instead of being decoded.
+ */
+template <class T>
+struct RadixKey {
+    using type = typename UnsignedOfSize<sizeof(T)>::type;
+
+    static constexpr type kSignBit = type{1} << (8 * sizeof(T) - 1);
+
+    static type encode(T value) noexcept {
+        type bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        if constexpr (std::is_floating_point_v<T>) {
+            if (std::isnan(value)) {
+                return std::numeric_limits<type>::max();
+            }
+            // -0.0 and +0.0 are equal, so they should keep their relative order
+            if (bits == kSignBit) {
+                bits = 0;
+            }
+            // Negative values have reversed order of magnitude bits
+            return (bits & kSignBit) ? static_cast<type>(~bits)
+                                     : static_cast<type>(bits | kSignBit);
+        } else if constexpr (std::is_signed_v<T>) {
+            return static_cast<type>(bits ^ kSignBit);
+        } else {
+            return bits;
+        }
+    }
+
+    static T decode(type key) noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            key = (key & kSignBit) ? static_cast<type>(key ^ kSignBit)
+                                   : static_cast<type>(~key);
+        } else if constexpr (std::is_signed_v<T>) {
+            key = static_cast<type>(key ^ kSignBit);
+        }
+        T value;
+        std::memcpy(&value, &key, sizeof(T));
+        return value;
+    }
+};
+
+/**
+ * \brief Stable LSD radix sort of \a keys with optional payload \a indices.
+ * Passes where all keys share the same digit are skipped.
+ */
+template <class Key>
+void radixSort(Key* keys,
+               Key* keys_tmp,
+               int64_t* indices,
+               int64_t* indices_tmp,
+               int64_t n) {
+    constexpr size_t kPasses = sizeof(Key);
+    std::array<std::array<int64_t, 256>, kPasses> histograms{};
+    for (int64_t i = 0; i < n; ++i) {
+        for (size_t pass = 0; pass < kPasses; ++pass) {
+            ++histograms[pass][(keys[i] >> (8 * pass)) & 0xFFU];
+        }
+    }
+    Key* src_keys = keys;
+    Key* dst_keys = keys_tmp;
+    int64_t* src_indices = indices;
+    int64_t* dst_indices = indices_tmp;
+    for (size_t pass = 0; pass < kPasses; ++pass) {
+        auto& histogram = histograms[pass];
+        const size_t shift = 8 * pass;
+        if (histogram[(src_keys[0] >> shift) & 0xFFU] == n) {
+            continue;
+        }
+        std::exclusive_scan(
+            histogram.begin(), histogram.end(), histogram.begin(), int64_t{0});
+        for (int64_t i = 0; i < n; ++i) {
+            const int64_t pos = histogram[(src_keys[i] >> shift) & 0xFFU]++;
+            dst_keys[pos] = src_keys[i];
+            if (indices != nullptr) {
+                dst_indices[pos] = src_indices[i];
+            }
+        }
+        std::swap(src_keys, dst_keys);
+        std::swap(src_indices, dst_indices);
+    }
+    if (src_keys != keys) {
+        std::copy(src_keys, src_keys + n, keys);
+        if (indices != nullptr) {
+            std::copy(src_indices, src_indices + n, indices);
+        }
+    }
+}
+
+/**
+ * \brief Orders first \a k elements of the row by ascending (key, index) pairs.
+ */
+template <class Key>
+void sortRow(std::vector<Key>& keys,
+             std::vector<Key>& keys_tmp,
+             std::vector<int64_t>& indices,
+             std::vector<int64_t>& indices_tmp,
+             bool with_indices,
+             int64_t k) {
+    const auto n = static_cast<int64_t>(keys.size());
+    if (k == 0) {
+        return;
+    }
+    if (with_indices) {
+        std::iota(indices.begin(), indices.end(), int64_t{0});
+    }
+    if (k * kHeapSelectRatio <= n) {
+        // Bounded max-heap keeps the k best (key, index) pairs seen so far.
+        // Indices only increase, so a tie never replaces the heap top
+        std::vector<std::pair<Key, int64_t>> heap;
+        heap.reserve(static_cast<size_t>(k));
+        for (int64_t i = 0; i < n; ++i) {
+            const Key key = keys[static_cast<size_t>(i)];
+            if (static_cast<int64_t>(heap.size()) < k) {
+                heap.emplace_back(key, i);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (key < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {key, i};
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        std::sort_heap(heap.begin(), heap.end());
+        for (size_t i = 0; i < heap.size(); ++i) {
+            keys[i] = heap[i].first;
+            indices[i] = heap[i].second;
+        }
+        return;
+    }
+    if (n < kRadixSortMinRowSize) {
+        if (!with_indices) {
+            std::sort(keys.begin(), keys.end());
+            return;
+        }
+        std::stable_sort(indices.begin(), indices.end(), [&](int64_t lhs, int64_t rhs) {
+            return keys[static_cast<size_t>(lhs)] < keys[static_cast<size_t>(rhs)];
+        });
+        for (int64_t i = 0; i < n; ++i) {
+            keys_tmp[static_cast<size_t>(i)] = keys[static_cast<size_t>(
+                indices[static_cast<size_t>(i)])];
+        }
+        keys.swap(keys_tmp);
+        return;
+    }
+    radixSort(keys.data(),
+              keys_tmp.data(),
+              with_indices ? indices.data() : nullptr,
+              indices_tmp.data(),
+              n);
+}
+
+template <class T>
+void sortRowsKernel(const SortRowsArgs& args) {
+    using Key = typename RadixKey<T>::type;
+    constexpr bool kGatherValues = std::is_floating_point_v<T>;
+
+    const int64_t row_size = args.row_size;
+    const int64_t k = args.k;
+    const bool descending = args.descending;
+    const bool with_indices = args.with_indices || kGatherValues;
+    const int64_t grain = std::max(int64_t{1}, kSortGrainElements / row_size);
+    parallelFor(0, args.n_rows, grain, [&](int64_t begin, int64_t end) {
+        const auto n = static_cast<size_t>(row_size);
+        std::vector<Key> keys(n);
+        std::vector<Key> keys_tmp(n);
+        std::vector<int64_t> row_indices(n);
+        std::vector<int64_t> row_indices_tmp(with_indices ? n : 0);
+
+        NdOffsetIterator<3> it(args.rows_shape,
+                               args.rows_dims,
+                               {args.rows_strides[0], args.rows_strides[1],
+                                args.rows_strides[2]},
+                               begin);
+        for (int64_t row = begin; row < end; ++row, it.next()) {
+            const std::byte* row_src = args.src + it.offset(0);
+            for (int64_t i = 0; i < row_size; ++i) {
+                const Key key = RadixKey<T>::encode(
+                    *reinterpret_cast<const T*>(row_src + i * args.src_axis_stride));
+                keys[static_cast<size_t>(i)] = descending ? static_cast<Key>(~key) : key;
+            }
+            sortRow(keys, keys_tmp, row_indices, row_indices_tmp, with_indices, k);
+            if (args.values != nullptr) {
+                std::byte* row_values = args.values + it.offset(1);
+                for (int64_t i = 0; i < k; ++i) {
+                    auto* value = reinterpret_cast<T*>(row_values
+                                                       + i * args.values_axis_stride);
+                    if constexpr (kGatherValues) {
+                        const int64_t index = row_indices[static_cast<size_t>(i)];
+                        std::memcpy(
+                            value, row_src + index * args.src_axis_stride, sizeof(T));
+                    } else {
+                        const Key key = keys[static_cast<size_t>(i)];
+                        *value = RadixKey<T>::decode(descending ? static_cast<Key>(~key)
+                                                                : key);
+                    }
+                }
+            }
+            if (args.indices != nullptr) {
+                std::byte* row_indices_out = args.indices + it.offset(2);
+                for (int64_t i = 0; i < k; ++i) {
+                    *reinterpret_cast<int64_t*>(row_indices_out
+                                                + i * args.indices_axis_stride) =
+                        row_indices[static_cast<size_t>(i)];
+                }
+            }
+        }
+    });
+}
+
+/**
+ * \brief Sorts each row of \a src along \a axis writing first \a k elements of
+ * the sorted rows into \a values and/or \a indices (might be nullptr).
+ */
+void sortRows(const Tensor& src,
+              int64_t axis,
+              bool descending,
+              int64_t k,
+              Tensor* values,
+              Tensor* indices) {
+    const auto kernel = dispatchArithmeticDataType(src.dtype(), [](auto tag) {
+        return &sortRowsKernel<typename decltype(tag)::type>;
+    });
+    const auto axis_idx = static_cast<size_t>(axis);
+    const int64_t row_size = src.dim(axis_idx);
+    if (values != nullptr && values->numel() == 0) {
+        return;
+    }
+    if (indices != nullptr && indices->numel() == 0) {
+        return;
+    }
+
+    std::vector<int64_t> rows_shape;
+    std::array<std::vector<int64_t>, 3> rows_strides;
+    for (size_t dim = 0; dim < src.dims(); ++dim) {
+        if (dim == axis_idx) {
+            continue;
+        }
+        rows_shape.push_back(src.dim(dim));
+        rows_strides[0].push_back(src.strides()[dim]);
+        rows_strides[1].push_back(values != nullptr ? values->strides()[dim] : 0);
+        rows_strides[2].push_back(indices != nullptr ? indices->strides()[dim] : 0);
+    }
+
+    SortRowsArgs args;
+    args.rows_shape = rows_shape.data();
+    args.rows_dims = static_cast<int64_t>(rows_shape.size());
+    args.rows_strides = {
+        rows_strides[0].data(), rows_strides[1].data(), rows_strides[2].data()};
+    args.n_rows = std::accumulate(
+        rows_shape.begin(), rows_shape.end(), int64_t{1}, std::multiplies<>{});
+    args.row_size = row_size;
+    args.k = k;
+    args.descending = descending;
+    args.with_indices = indices != nullptr || k < row_size;
+    args.src = src.data();
+    args.src_axis_stride = src.strides()[axis_idx];
+    if (values != nullptr) {
+        args.values = values->data();
+        args.values_axis_stride = values->strides()[axis_idx];
+    }
+    if (indices != nullptr) {
+        args.indices = indices->data();
+        args.indices_axis_stride = indices->strides()[axis_idx];
+    }
+    kernel(args);
+}
+} // namespace
+} // namespace detail
+
+Tensor sort(const Tensor& src, int64_t axis, bool descending) {
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    Tensor values(src.shape(), src.dtype());
+    detail::sortRows(src, axis, descending, src.dim(static_cast<size_t>(axis)), &values,
+                     nullptr);
+    return values;
+}
+
+Tensor argsort(const Tensor& src, int64_t axis, bool descending) {
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    Tensor indices(src.shape(), TensorDataType::Int64);
+    detail::sortRows(src, axis, descending, src.dim(static_cast<size_t>(axis)), nullptr,
+                     &indices);
+    return indices;
+}
+
+std::pair<Tensor, Tensor> topk(const Tensor& src, int64_t k, int64_t axis, bool largest) {
+    axis = normalizeAxis(axis, static_cast<int64_t>(src.dims()));
+    const auto axis_idx = static_cast<size_t>(axis);
+    if (k < 0 || k > src.dim(axis_idx)) {
+        throw std::out_of_range("k = " + std::to_string(k)
+                                + " is out of bounds for axis with size "
+                                + std::to_string(src.dim(axis_idx)));
+    }
+    std::vector<int64_t> out_shape = src.shape();
+    out_shape[axis_idx] = k;
+    Tensor values(out_shape, src.dtype());
+    Tensor indices(std::move(out_shape), TensorDataType::Int64);
+    detail::sortRows(src, axis, largest, k, &values, &indices);
+    return {std::move(values), std::move(indices)};
+}
+} // namespace nope
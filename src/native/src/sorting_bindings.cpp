@@ -0,0 +1,39 @@
+#include "sorting_bindings.h"
+
+#include "nope/sorting.h"
+#include "nope/tensor.h"
+
+namespace py = pybind11;
+
+namespace nope {
+void registerSortingBindings(py::module_& module) {
+    module.def(
+        "sort",
+        [](const Tensor& src, int64_t axis, bool descending) {
+            py::gil_scoped_release release;
+            return sort(src, axis, descending);
+        },
+        py::arg("tensor"),
+        py::arg("axis") = -1,
+        py::arg("descending") = false);
+    module.def(
+        "argsort",
+        [](const Tensor& src, int64_t axis, bool descending) {
+            py::gil_scoped_release release;
+            return argsort(src, axis, descending);
+        },
+        py::arg("tensor"),
+        py::arg("axis") = -1,
+        py::arg("descending") = false);
+    module.def(
+        "topk",
+        [](const Tensor& src, int64_t k, int64_t axis, bool largest) {
+            py::gil_scoped_release release;
+            return topk(src, k, axis, largest);
+        },
+        py::arg("tensor"),
+        py::arg("k"),
+        py::arg("axis") = -1,
+        py::arg("largest") = true);
+}
+} // namespace nope
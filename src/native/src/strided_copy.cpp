@@ -0,0 +1,118 @@
+#include "nope/strided_copy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "nd_offset_iterator.h"
+#include "nope/parallel.h"
+#include "nope/shape_and_strides_manipulation.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kCopyGrainBytes = 64 * 1024;
+
+template <size_t ElementSize>
+void copyRowOfElements(const std::byte* src,
+                       int64_t src_stride,
+                       std::byte* dst,
+                       int64_t dst_stride,
+                       int64_t count) noexcept {
+    for (int64_t i = 0; i < count; ++i, src += src_stride, dst += dst_stride) {
+        std::memcpy(dst, src, ElementSize);
+    }
+}
+
+void copyRow(const std::byte* src,
+             int64_t src_stride,
+             std::byte* dst,
+             int64_t dst_stride,
+             int64_t count,
+             int64_t element_size) noexcept {
+    if (src_stride == element_size && dst_stride == element_size) {
+        std::memcpy(dst, src, static_cast<size_t>(count * element_size));
+        return;
+    }
+    switch (element_size) {
+        case 1:
+            return copyRowOfElements<1>(src, src_stride, dst, dst_stride, count);
+        case 2:
+            return copyRowOfElements<2>(src, src_stride, dst, dst_stride, count);
+        case 4:
+            return copyRowOfElements<4>(src, src_stride, dst, dst_stride, count);
+        case 8:
+            return copyRowOfElements<8>(src, src_stride, dst, dst_stride, count);
+        default:
+            for (int64_t i = 0; i < count; ++i, src += src_stride, dst += dst_stride) {
+                std::memcpy(dst, src, static_cast<size_t>(element_size));
+            }
+    }
+}
+} // namespace
+
+void copyStrided(const int64_t* shape,
+                 int64_t dims,
+                 const std::byte* src,
+                 const int64_t* src_strides,
+                 std::byte* dst,
+                 const int64_t* dst_strides,
+                 int64_t element_size) {
+    if (std::any_of(shape, shape + dims, [](int64_t dim) {
+            return dim == 0;
+        })) {
+        return;
+    }
+    if (dims == 0) {
+        std::memcpy(dst, src, static_cast<size_t>(element_size));
+        return;
+    }
+    std::vector<int64_t> eff_shape(shape, shape + dims);
+    std::vector<int64_t> eff_src_strides(src_strides, src_strides + dims);
+    std::vector<int64_t> eff_dst_strides(dst_strides, dst_strides + dims);
+    int64_t* strides[] = {eff_src_strides.data(), eff_dst_strides.data()};
+    dims = coalesceDimensions(eff_shape.data(), strides, 2, dims);
+
+    const int64_t row_size = eff_shape[static_cast<size_t>(dims - 1)];
+    const int64_t src_row_stride = eff_src_strides[static_cast<size_t>(dims - 1)];
+    const int64_t dst_row_stride = eff_dst_strides[static_cast<size_t>(dims - 1)];
+    const int64_t outer_dims = dims - 1;
+    int64_t n_rows = 1;
+    for (int64_t dim = 0; dim < outer_dims; ++dim) {
+        n_rows *= eff_shape[static_cast<size_t>(dim)];
+    }
+    const int64_t grain = std::max(int64_t{1},
+                                   kCopyGrainBytes / (row_size * element_size));
+    parallelFor(0, n_rows, grain, [&](int64_t begin, int64_t end) {
+        NdOffsetIterator<2> it(eff_shape.data(),
+                               outer_dims,
+                               {eff_src_strides.data(), eff_dst_strides.data()},
+                               begin);
+        for (int64_t row = begin; row < end; ++row, it.next()) {
+            copyRow(src + it.offset(0),
+                    src_row_stride,
+                    dst + it.offset(1),
+                    dst_row_stride,
+                    row_size,
+                    element_size);
+        }
+    });
+}
+} // namespace detail
+
+void copyStrided(const Tensor& src, Tensor& dst) {
+    if (src.dtype() != dst.dtype()) {
+        throw TypesMismatchError("Source and destination data types are different");
+    }
+    if (src.shape() != dst.shape()) {
+        throw std::length_error("Source and destination shapes are different");
+    }
+    detail::copyStrided(src.shape().data(),
+                        static_cast<int64_t>(src.dims()),
+                        src.data(),
+                        src.strides().data(),
+                        dst.data(),
+                        dst.strides().data(),
+                        src.dtype().ssize());
+}
+} // namespace nope
@@ -1,18 +1,28 @@
 #include "nope/tensor.h"
 
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <numeric>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
+#include "mapped_memory.h"
+#include "memory_accounting.h"
+#include "nope/is_contiguous.h"
+#include "nope/quantization.h"
 #include "nope/shape_and_strides_manipulation.h"
+#include "nope/strided_copy.h"
 
 namespace nope {
 namespace detail {
 size_t calcDataSize(const std::vector<int64_t>& shape, int64_t element_size) noexcept {
     // clang-format off
     return static_cast<size_t>(
-        std::accumulate(shape.begin(), shape.end(), element_size)
+        std::accumulate(shape.begin(), shape.end(), element_size, std::multiplies<>{})
     );
     // clang-format on
 }
@@ -43,27 +53,168 @@ Tensor::Tensor(std::byte* bytes,
                std::vector<int64_t> shape,
                std::vector<int64_t> strides,
                TensorDataType dtype,
-               BytesFree bytes_free)
-    : storage_{Storage::fromBytes(
-        bytes, detail::calcDataSize(shape, dtype.ssize()), bytes_free)},
-      shape_{std::move(shape)},
+               BytesFree bytes_free,
+               std::unique_ptr<DataOwner> owner)
+    : shape_{std::move(shape)},
       strides_{std::move(strides)},
       dtype_{dtype} {
+    if (shape_.size() != strides_.size()) {
+        throw std::length_error("Shape and strides have different lengths");
+    }
+    const auto [lowest, highest] = detail::stridedExtent(shape_, strides_, dtype.ssize());
+    storage_ = Storage::fromBytes(bytes + lowest,
+                                  static_cast<size_t>(highest - lowest),
+                                  bytes_free,
+                                  std::move(owner));
+    storage_offset_ = -lowest;
+}
+
+int64_t Tensor::numel() const noexcept {
+    return std::accumulate(
+        shape_.begin(), shape_.end(), int64_t{1}, std::multiplies<>{});
+}
+
+bool Tensor::isContiguous() const noexcept {
+    return nope::isContiguous(shape_, strides_, itemSize());
+}
+
+Tensor Tensor::contiguous() const {
+    if (isContiguous()) {
+        return *this;
+    }
+    Tensor dst(shape_, dtype_);
+    copyStrided(*this, dst);
+    dst.quantization_ = quantization_;
+    return dst;
 }
 
-std::shared_ptr<Tensor::Storage> Tensor::Storage::allocateContiguous(
-    const std::vector<int64_t>& shape, int64_t element_size) {
+Tensor Tensor::asStrided(std::vector<int64_t> shape,
+                         std::vector<int64_t> strides,
+                         int64_t storage_offset) const {
+    if (shape.size() != strides.size()) {
+        throw std::length_error("Shape and strides have different lengths");
+    }
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (shape[i] < 0) {
+            throw std::out_of_range("Negative view extent in dimension "
+                                    + std::to_string(i));
+        }
+    }
+    const auto [lowest, highest] = detail::stridedExtent(shape, strides, dtype_.ssize());
+    if (highest > lowest
+        && (storage_offset + lowest < 0
+            || storage_offset + highest > static_cast<int64_t>(storageSize()))) {
+        throw std::out_of_range("View with storage offset "
+                                + std::to_string(storage_offset) + " exceeds storage of "
+                                + std::to_string(storageSize()) + " bytes");
+    }
+    Tensor view(*this);
+    view.shape_ = std::move(shape);
+    view.strides_ = std::move(strides);
+    view.storage_offset_ = storage_offset;
+    if (quantization_ && quantization_->isPerAxis()) {
+        view.quantization_.reset();
+    }
+    return view;
+}
+
+void Tensor::setQuantization(const QuantizationParams& params) {
+    if (dtype_ != TensorDataType::Int8 && dtype_ != TensorDataType::UInt8) {
+        throw TypesMismatchError("Only Int8 and UInt8 tensors can be quantized, got: "
+                                 + to_string(dtype_));
+    }
+    size_t n_params = 1;
+    if (params.isPerAxis()) {
+        if (params.axis >= static_cast<int64_t>(dims())) {
+            throw std::out_of_range("Quantization axis " + std::to_string(params.axis)
+                                    + " is out of bounds for tensor of "
+                                    + std::to_string(dims()) + " dimensions");
+        }
+        n_params = static_cast<size_t>(dim(static_cast<size_t>(params.axis)));
+    }
+    if (params.scales.size() != n_params || params.zero_points.size() != n_params) {
+        throw std::length_error("Expected " + std::to_string(n_params)
+                                + " quantization scales and zero points, got "
+                                + std::to_string(params.scales.size()) + " and "
+                                + std::to_string(params.zero_points.size()));
+    }
+    for (const float scale : params.scales) {
+        if (!(scale > 0.0F && std::isfinite(scale))) {
+            throw std::invalid_argument("Quantization scale should be positive, got: "
+                                        + std::to_string(scale));
+        }
+    }
+    const int32_t lowest = dtype_ == TensorDataType::Int8 ? -128 : 0;
+    for (const int32_t zero_point : params.zero_points) {
+        if (zero_point < lowest || zero_point > lowest + 255) {
+            throw std::out_of_range("Zero point " + std::to_string(zero_point)
+                                    + " is out of " + to_string(dtype_) + " range");
+        }
+    }
+    quantization_ = std::make_shared<const QuantizationParams>(params);
+}
+
+constexpr size_t Tensor::Storage::headerSize() noexcept {
+    return (sizeof(Storage) + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void Tensor::Storage::account() noexcept {
+    const detail::AllocationTicket ticket =
+        detail::accountAllocation(size, bytes_free != nullptr);
+    tag_counters = ticket.tag;
+    debug_id = ticket.debug_id;
+}
+
+Tensor::StoragePtr Tensor::Storage::allocateContiguous(const std::vector<int64_t>& shape,
+                                                       int64_t element_size) {
     const auto size = detail::calcDataSize(shape, element_size);
-    DataPtr data_ptr(new std::byte[size], [](std::byte* bytes) {
-        delete[] bytes;
-    });
-    return std::make_shared<Storage>(std::move(data_ptr), size);
+    if (headerSize() + size >= detail::hugePagesThreshold()) {
+        const detail::MappedBlock mapped = detail::mapLargeBlock(headerSize() + size);
+        if (mapped.ptr != nullptr) {
+            auto* storage = new (mapped.ptr) Storage;
+            storage->data = static_cast<std::byte*>(mapped.ptr) + headerSize();
+            storage->size = size;
+            storage->mapped_size = mapped.size;
+            storage->account();
+            return StoragePtr{storage};
+        }
+    }
+    void* block = ::operator new(headerSize() + size, std::align_val_t{kAlignment});
+    auto* storage = new (block) Storage;
+    storage->data = static_cast<std::byte*>(block) + headerSize();
+    storage->size = size;
+    storage->account();
+    return StoragePtr{storage};
 }
 
-std::shared_ptr<Tensor::Storage> Tensor::Storage::fromBytes(std::byte* bytes,
-                                                            size_t bytes_size,
-                                                            BytesFree bytes_free) {
-    return std::make_shared<Storage>(DataPtr{bytes, bytes_free}, bytes_size);
+Tensor::StoragePtr Tensor::Storage::fromBytes(std::byte* bytes,
+                                              size_t bytes_size,
+                                              BytesFree bytes_free,
+                                              std::unique_ptr<DataOwner> owner) {
+    void* block = ::operator new(headerSize(), std::align_val_t{kAlignment});
+    auto* storage = new (block) Storage;
+    storage->data = bytes;
+    storage->size = bytes_size;
+    storage->bytes_free = bytes_free;
+    storage->owner = std::move(owner);
+    storage->account();
+    return StoragePtr{storage};
+}
+
+void Tensor::Storage::destroy(Storage* storage) noexcept {
+    detail::accountDeallocation({storage->tag_counters, storage->debug_id},
+                                storage->size,
+                                storage->bytes_free != nullptr);
+    if (storage->bytes_free != nullptr) {
+        storage->bytes_free(storage->data);
+    }
+    const size_t mapped_size = storage->mapped_size;
+    storage->~Storage();
+    if (mapped_size != 0) {
+        detail::unmapBlock({storage, mapped_size});
+        return;
+    }
+    ::operator delete(storage, std::align_val_t{kAlignment});
 }
 
 template <class T>
@@ -1,28 +1,59 @@
 #include "tensor_bindings.h"
 
-#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 
+#include "nope/is_contiguous.h"
+#include "nope/quantization.h"
+#include "nope/shape_and_strides_manipulation.h"
 #include "nope/tensor.h"
 #include "nope/tensor_data_type.h"
 
 #include <pybind11/attr.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include <pybind11/buffer_info.h>
 #include <pybind11/detail/common.h>
 
 namespace py = pybind11;
 
 namespace nope {
+TensorDataType typeIdToTensorDataType(uint8_t type_id) {
+    if (type_id >= TensorDataType::kTypesCount) {
+        throw std::invalid_argument("Unknown tensor data type id: "
+                                    + std::to_string(type_id));
+    }
+    return static_cast<TensorDataType::TypeId>(type_id);
+}
+
 void registerTensorDataType(py::module_& module) {
     py::class_<nope::TensorDataType>(module, "TensorDataType")
         .def_property_readonly("value", &TensorDataType::typeId)
         .def_property_readonly("size", &TensorDataType::size)
-        .def("__str__", [](const TensorDataType& dtype) {
-            using std::to_string;
+        .def("__eq__", [](const TensorDataType& lhs, const TensorDataType& rhs) {
+            return lhs == rhs;
+        })
+        .def("__hash__", &TensorDataType::typeId)
+        .def("__str__",
+             [](const TensorDataType& dtype) {
+                 using std::to_string;
 
-            return to_string(dtype);
-        });
+                 return to_string(dtype);
+             })
+        .def(py::pickle(
+            [](const TensorDataType& dtype) {
+                return dtype.typeId();
+            },
+            [](uint8_t type_id) {
+                return typeIdToTensorDataType(type_id);
+            }));
 #define DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT(name, value) \
     module.attr(name) = TensorDataType(TensorDataType::value)
 
@@ -32,50 +63,33 @@ void registerTensorDataType(py::module_& module) {
     DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("uint16", UInt16);
     DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("int32", Int32);
     DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("uint32", UInt32);
+    DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("int64", Int64);
+    DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("uint64", UInt64);
     DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("float32", Float32);
     DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("float64", Float64);
+    DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT("bool_", Bool);
 
 #undef DEFINE_TENSOR_DATA_TYPE_AS_MODULE_CONSTANT
+
+    module.def("promote_types", &promoteTypes, py::arg("lhs"), py::arg("rhs"));
 }
 
 std::string tensorDataTypeToFormatDescriptor(const TensorDataType& dtype) {
-#define SWITCH_TYPE_ID_CASE(type, type_id) \
-    case TensorDataType::type_id:          \
-        return py::format_descriptor<type>::format();
-
-    switch (dtype.typeId()) {
-        SWITCH_TYPE_ID_CASE(int8_t, Int8);
-        SWITCH_TYPE_ID_CASE(uint8_t, UInt8);
-        SWITCH_TYPE_ID_CASE(int16_t, Int16);
-        SWITCH_TYPE_ID_CASE(uint16_t, UInt16);
-        SWITCH_TYPE_ID_CASE(int32_t, Int32);
-        SWITCH_TYPE_ID_CASE(uint32_t, UInt32);
-        SWITCH_TYPE_ID_CASE(float, Float32);
-        SWITCH_TYPE_ID_CASE(double, Float64);
-        default:
-            throw std::logic_error("Unknown tensor data type id: " + to_string(dtype));
+    const char format = dtype.formatCode();
+    if (format == '\0') {
+        throw std::logic_error("Unknown tensor data type id: " + to_string(dtype));
     }
-#undef SWITCH_TYPE_ID_CASE
+    return std::string(1, format);
 }
 
 TensorDataType formatDescriptorToTensorDataType(const std::string& format) {
-#define CHECK_IF_FORMAT_REFER_TO(type)                   \
-    if (format == py::format_descriptor<type>::format()) \
-    return TensorDataType::of<type>()
-
-    CHECK_IF_FORMAT_REFER_TO(int8_t);
-    CHECK_IF_FORMAT_REFER_TO(uint8_t);
-    CHECK_IF_FORMAT_REFER_TO(int16_t);
-    CHECK_IF_FORMAT_REFER_TO(uint16_t);
-    CHECK_IF_FORMAT_REFER_TO(int32_t);
-    CHECK_IF_FORMAT_REFER_TO(uint32_t);
-    CHECK_IF_FORMAT_REFER_TO(float);
-    CHECK_IF_FORMAT_REFER_TO(double);
-
-#undef CHECK_IF_FORMAT_REFER_TO
-
+    // Buffers of builtin types have single character native format codes
+    if (format.size() == 1) {
+        if (const auto dtype = TensorDataType::fromFormatCode(format.front())) {
+            return *dtype;
+        }
+    }
     throw std::runtime_error("Unknown tensor data type format: " + format);
-    return TensorDataType::Float32;
 }
 
 std::vector<py::ssize_t> convertToSSizeVector(const std::vector<int64_t>& src) {
@@ -101,6 +115,99 @@ std::vector<int64_t> convertToInt64Vector(const std::vector<py::ssize_t>& src) {
     return dst;
 }
 
+/**
+ * \brief Holds a reference to the Python object exporting tensor data. Storage
+ * might be released by a thread not holding GIL.
+ */
+class PyObjectOwner final : public Tensor::DataOwner {
+public:
+    explicit PyObjectOwner(const py::object& object) : object_{object.inc_ref()} {
+    }
+
+    PyObjectOwner(const PyObjectOwner& /* that */) = delete;
+
+    PyObjectOwner& operator=(const PyObjectOwner& /* that */) = delete;
+
+    ~PyObjectOwner() override {
+        py::gil_scoped_acquire acquire;
+        object_.dec_ref();
+    }
+
+private:
+    py::handle object_;
+};
+
+/**
+ * \brief Rebuilds pickled tensor as a view of the \a buffer holding the whole
+ * tensor storage. Writable out-of-band buffers are referred without copying,
+ * read-only ones (e.g. in-band bytes) are copied into owned storage.
+ */
+Tensor tensorFromStorageBuffer(const py::buffer& buffer,
+                               std::vector<int64_t> shape,
+                               std::vector<int64_t> strides,
+                               int64_t storage_offset,
+                               TensorDataType dtype,
+                               const std::optional<QuantizationParams>& quantization) {
+    const py::buffer_info info = buffer.request();
+    if (!isContiguous(convertToInt64Vector(info.shape),
+                      convertToInt64Vector(info.strides),
+                      static_cast<size_t>(info.itemsize))) {
+        throw std::invalid_argument("Tensor storage buffer should be contiguous");
+    }
+    const int64_t item_size = dtype.ssize();
+    const int64_t storage_size = static_cast<int64_t>(info.size * info.itemsize);
+    std::vector<int64_t> storage_shape{storage_size / item_size};
+    Tensor storage = info.readonly
+                         ? Tensor(std::move(storage_shape), dtype)
+                         : Tensor(static_cast<std::byte*>(info.ptr),
+                                  std::move(storage_shape),
+                                  {item_size},
+                                  dtype,
+                                  &detail::freeNothing,
+                                  std::make_unique<PyObjectOwner>(buffer));
+    if (info.readonly) {
+        std::copy_n(static_cast<const std::byte*>(info.ptr),
+                    storage.storageSize(),
+                    storage.storageData());
+    }
+    Tensor tensor =
+        storage.asStrided(std::move(shape), std::move(strides), storage_offset);
+    if (quantization) {
+        tensor.setQuantization(*quantization);
+    }
+    return tensor;
+}
+
+/**
+ * \brief Pickles tensor as its whole storage plus view metadata, so views are
+ * not compacted. Protocol 5 passes storage as PickleBuffer allowing consumers
+ * to transfer it out-of-band without copying.
+ */
+py::tuple reduceTensor(const Tensor& tensor, int protocol) {
+    const int64_t item_size = tensor.dtype().ssize();
+    // Storages not divisible into elements are compacted
+    const bool compact = tensor.storageSize() % static_cast<size_t>(item_size) != 0;
+    const Tensor base = compact ? tensor.contiguous() : tensor;
+    const auto n_elements = static_cast<int64_t>(base.storageSize()) / item_size;
+    const Tensor storage = base.asStrided({n_elements}, {item_size}, 0);
+    py::object payload;
+    if (protocol >= 5) {
+        payload = py::module_::import("pickle").attr("PickleBuffer")(storage);
+    } else {
+        payload = py::bytes(reinterpret_cast<const char*>(storage.storageData()),
+                            storage.storageSize());
+    }
+    return py::make_tuple(
+        py::module_::import("nope._nope").attr("_tensor_from_storage_buffer"),
+        py::make_tuple(payload,
+                       base.shape(),
+                       base.strides(),
+                       base.storageOffset(),
+                       base.dtype(),
+                       base.isQuantized() ? py::cast(*base.quantization())
+                                          : py::none()));
+}
+
 void registerTensorBindings(py::module_& module) {
     registerTensorDataType(module);
 
@@ -116,22 +223,54 @@ void registerTensorBindings(py::module_& module) {
             };
         })
         .def(py::init([](py::buffer b) {
-            py::buffer_info info = b.request();
+                 py::buffer_info info = b.request();
 
-            return Tensor(static_cast<std::byte*>(info.ptr),
-                          convertToInt64Vector(info.shape),
-                          convertToInt64Vector(info.strides),
-                          formatDescriptorToTensorDataType(info.format));
-        }))
+                 // Tensor refers to the buffer memory without copying it, so
+                 // its storage and all views keep the buffer alive
+                 return Tensor(static_cast<std::byte*>(info.ptr),
+                               convertToInt64Vector(info.shape),
+                               convertToInt64Vector(info.strides),
+                               formatDescriptorToTensorDataType(info.format),
+                               &detail::freeNothing,
+                               std::make_unique<PyObjectOwner>(b));
+             }))
         .def_property_readonly("shape", &Tensor::shape)
         .def_property_readonly("strides", &Tensor::strides)
         .def_property_readonly("dims", &Tensor::dims)
         .def_property_readonly("dtype", &Tensor::dtype)
         .def_property_readonly("item_size", &Tensor::itemSize)
+        .def_property_readonly("is_contiguous", &Tensor::isContiguous)
+        .def_property_readonly("storage_offset", &Tensor::storageOffset)
+        .def("as_strided",
+             &Tensor::asStrided,
+             py::arg("shape"),
+             py::arg("strides"),
+             py::arg("storage_offset"))
+        .def("numel", &Tensor::numel)
+        .def_property_readonly("quantization",
+                               [](const Tensor& t) -> std::optional<QuantizationParams> {
+                                   if (const auto* params = t.quantization()) {
+                                       return *params;
+                                   }
+                                   return std::nullopt;
+                               })
+        .def("set_quantization", &Tensor::setQuantization, py::arg("params"))
+        .def("clear_quantization", &Tensor::clearQuantization)
+        .def("__reduce_ex__", &reduceTensor, py::arg("protocol"))
         .def("__str__", [](const Tensor& t) {
             std::ostringstream stream;
             stream << t;
             return stream.str();
         });
+    py::implicitly_convertible<py::buffer, Tensor>();
+
+    module.def("_tensor_from_storage_buffer",
+               &tensorFromStorageBuffer,
+               py::arg("buffer"),
+               py::arg("shape"),
+               py::arg("strides"),
+               py::arg("storage_offset"),
+               py::arg("dtype"),
+               py::arg("quantization") = py::none());
 }
 } // namespace nope
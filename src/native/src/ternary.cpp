@@ -0,0 +1,379 @@
+#include "nope/ternary.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cpu_features.h"
+#include "elementwise_loop.h"
+#include "type_dispatch.h"
+
+namespace nope {
+namespace detail {
+namespace {
+constexpr int64_t kTernaryGrainElements = 32 * 1024;
+
+/**
+ * \brief Contiguous run kernel of 3 operands. The first operand is always
+ * contiguous, splatted ones point to a single value loaded once for the run.
+ */
+template <class M, class T>
+using TernaryRunKernel = void (*)(const M* first,
+                                  const T* second,
+                                  const T* third,
+                                  T* out,
+                                  int64_t n);
+
+using TernaryStridedKernel = void (*)(const std::array<std::byte*, 4>& data,
+                                      const std::array<int64_t, 4>& strides,
+                                      int64_t n);
+
+/**
+ * \brief Kernels of a ternary operation indexed by splat flags of the second
+ * and the third operands.
+ */
+template <class M, class T>
+struct TernaryKernels {
+    std::array<std::array<TernaryRunKernel<M, T>, 2>, 2> contiguous{};
+    TernaryStridedKernel strided{nullptr};
+};
+
+// SECTION: where
+template <class T>
+T selectScalar(uint8_t mask, T a, T b) noexcept {
+    return mask != 0 ? a : b;
+}
+
+template <class T, bool kASplat, bool kBSplat>
+void whereRunScalar(
+    const uint8_t* mask, const T* a, const T* b, T* out, int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = selectScalar(mask[i], a[kASplat ? 0 : i], b[kBSplat ? 0 : i]);
+    }
+}
+
+template <class T>
+void whereRunStrided(const std::array<std::byte*, 4>& data,
+                     const std::array<int64_t, 4>& strides,
+                     int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        T a;
+        T b;
+        std::memcpy(&a, data[1] + i * strides[1], sizeof(T));
+        std::memcpy(&b, data[2] + i * strides[2], sizeof(T));
+        const auto mask = static_cast<uint8_t>(data[0][i * strides[0]]);
+        const T value = selectScalar(mask, a, b);
+        std::memcpy(data[3] + i * strides[3], &value, sizeof(T));
+    }
+}
+
+#if NOPE_X86_DISPATCH
+/**
+ * \brief Vector of mask bytes corresponding to \a NLanes lanes of 256-bit
+ * register, widened to the lane size before the blend.
+ */
+template <int64_t NLanes>
+struct MaskVector {
+    typedef uint8_t type __attribute__((vector_size(NLanes)));
+};
+
+template <class T, bool kASplat, bool kBSplat>
+NOPE_TARGET_AVX2 void
+whereRunAvx2(const uint8_t* mask, const T* a, const T* b, T* out, int64_t n) {
+    using Vec = typename Avx2Vector<T>::type;
+    constexpr auto kLanes = static_cast<int64_t>(sizeof(Vec) / sizeof(T));
+    using Mask = typename MaskVector<kLanes>::type;
+    Vec va{};
+    Vec vb{};
+    if constexpr (kASplat) {
+        va += *a;
+    }
+    if constexpr (kBSplat) {
+        vb += *b;
+    }
+    const int64_t vector_end = n - n % kLanes;
+    int64_t i = 0;
+    for (; i < vector_end; i += kLanes) {
+        Mask bytes;
+        std::memcpy(&bytes, mask + i, sizeof(Mask));
+        if constexpr (!kASplat) {
+            std::memcpy(&va, a + i, sizeof(Vec));
+        }
+        if constexpr (!kBSplat) {
+            std::memcpy(&vb, b + i, sizeof(Vec));
+        }
+        const Vec result = __builtin_convertvector(bytes, Vec) != 0 ? va : vb;
+        std::memcpy(out + i, &result, sizeof(Vec));
+    }
+    whereRunScalar<T, kASplat, kBSplat>(
+        mask + i, kASplat ? a : a + i, kBSplat ? b : b + i, out + i, n - i);
+}
+#endif
+
+template <class T>
+TernaryKernels<uint8_t, T> selectWhereKernels() noexcept {
+    TernaryKernels<uint8_t, T> kernels;
+    kernels.contiguous = {{
+        {&whereRunScalar<T, false, false>, &whereRunScalar<T, false, true>},
+        {&whereRunScalar<T, true, false>, &whereRunScalar<T, true, true>},
+    }};
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        kernels.contiguous = {{
+            {&whereRunAvx2<T, false, false>, &whereRunAvx2<T, false, true>},
+            {&whereRunAvx2<T, true, false>, &whereRunAvx2<T, true, true>},
+        }};
+    }
+#endif
+    kernels.strided = &whereRunStrided<T>;
+    return kernels;
+}
+
+// SECTION: clip
+template <class T>
+T clipScalar(T x, T lo, T hi) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        // NaN bounds are propagated the same as NaNs of x
+        x = x < lo || std::isnan(lo) ? lo : x;
+        return x > hi || std::isnan(hi) ? hi : x;
+    } else {
+        x = x < lo ? lo : x;
+        return x > hi ? hi : x;
+    }
+}
+
+template <class T, bool kLoSplat, bool kHiSplat>
+void clipRunScalar(const T* x, const T* lo, const T* hi, T* out, int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = clipScalar(x[i], lo[kLoSplat ? 0 : i], hi[kHiSplat ? 0 : i]);
+    }
+}
+
+template <class T>
+void clipRunStrided(const std::array<std::byte*, 4>& data,
+                    const std::array<int64_t, 4>& strides,
+                    int64_t n) noexcept {
+    for (int64_t i = 0; i < n; ++i) {
+        const T x = *reinterpret_cast<const T*>(data[0] + i * strides[0]);
+        const T lo = *reinterpret_cast<const T*>(data[1] + i * strides[1]);
+        const T hi = *reinterpret_cast<const T*>(data[2] + i * strides[2]);
+        *reinterpret_cast<T*>(data[3] + i * strides[3]) = clipScalar(x, lo, hi);
+    }
+}
+
+#if NOPE_X86_DISPATCH
+template <class T, bool kLoSplat, bool kHiSplat>
+NOPE_TARGET_AVX2 void
+clipRunAvx2(const T* x, const T* lo, const T* hi, T* out, int64_t n) {
+    using Vec = typename Avx2Vector<T>::type;
+    constexpr auto kLanes = static_cast<int64_t>(sizeof(Vec) / sizeof(T));
+    Vec low{};
+    Vec high{};
+    if constexpr (kLoSplat) {
+        low += *lo;
+    }
+    if constexpr (kHiSplat) {
+        high += *hi;
+    }
+    const int64_t vector_end = n - n % kLanes;
+    int64_t i = 0;
+    for (; i < vector_end; i += kLanes) {
+        Vec value;
+        std::memcpy(&value, x + i, sizeof(Vec));
+        if constexpr (!kLoSplat) {
+            std::memcpy(&low, lo + i, sizeof(Vec));
+        }
+        if constexpr (!kHiSplat) {
+            std::memcpy(&high, hi + i, sizeof(Vec));
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            // NaN of x is kept, NaN bounds are selected: v <= v is false only
+            // for NaN lanes
+            value = (value < low) | !(low <= low) ? low : value;
+            value = (value > high) | !(high <= high) ? high : value;
+        } else {
+            // Compiled into max/min
+            value = value < low ? low : value;
+            value = value > high ? high : value;
+        }
+        std::memcpy(out + i, &value, sizeof(Vec));
+    }
+    clipRunScalar<T, kLoSplat, kHiSplat>(
+        x + i, kLoSplat ? lo : lo + i, kHiSplat ? hi : hi + i, out + i, n - i);
+}
+#endif
+
+template <class T>
+TernaryKernels<T, T> selectClipKernels() noexcept {
+    TernaryKernels<T, T> kernels;
+    kernels.contiguous = {{
+        {&clipRunScalar<T, false, false>, &clipRunScalar<T, false, true>},
+        {&clipRunScalar<T, true, false>, &clipRunScalar<T, true, true>},
+    }};
+#if NOPE_X86_DISPATCH
+    if (cpuFeatures().avx2) {
+        kernels.contiguous = {{
+            {&clipRunAvx2<T, false, false>, &clipRunAvx2<T, false, true>},
+            {&clipRunAvx2<T, true, false>, &clipRunAvx2<T, true, true>},
+        }};
+    }
+#endif
+    kernels.strided = &clipRunStrided<T>;
+    return kernels;
+}
+
+/**
+ * \brief Applies \a kernels to \a operands broadcasted to the shape of \a out.
+ * Runs where the first operand and output are contiguous and others are
+ * contiguous or a single value take the contiguous kernels.
+ */
+template <class M, class T>
+void runTernary(const TernaryKernels<M, T>& kernels,
+                const std::array<const Tensor*, 3>& operands,
+                Tensor& out) {
+    constexpr auto kItemSize = static_cast<int64_t>(sizeof(T));
+    constexpr auto kFirstItemSize = static_cast<int64_t>(sizeof(M));
+    std::array<std::vector<int64_t>, 4> strides;
+    std::array<std::byte*, 4> data{};
+    for (size_t k = 0; k < operands.size(); ++k) {
+        strides[k] = broadcastStrides(*operands[k], out.shape());
+        // Operands are only read, kernels cast the bytes to the mask and value types
+        data[k] = const_cast<std::byte*>(operands[k]->data());
+    }
+    strides[3] = out.strides();
+    data[3] = out.data();
+    const auto is_splat_or_contiguous = [](int64_t stride) {
+        return stride == 0 || stride == kItemSize;
+    };
+    forEachElementRun<4>(
+        out.shape(),
+        std::move(strides),
+        data,
+        kTernaryGrainElements,
+        [&](const std::array<std::byte*, 4>& run_data,
+            const std::array<int64_t, 4>& run_strides,
+            int64_t count) {
+            if (run_strides[0] == kFirstItemSize && run_strides[3] == kItemSize
+                && is_splat_or_contiguous(run_strides[1])
+                && is_splat_or_contiguous(run_strides[2])) {
+                const auto kernel = kernels.contiguous[run_strides[1] == 0 ? 1 : 0]
+                                                      [run_strides[2] == 0 ? 1 : 0];
+                kernel(reinterpret_cast<const M*>(run_data[0]),
+                       reinterpret_cast<const T*>(run_data[1]),
+                       reinterpret_cast<const T*>(run_data[2]),
+                       reinterpret_cast<T*>(run_data[3]),
+                       count);
+                return;
+            }
+            kernels.strided(run_data, run_strides, count);
+        });
+}
+
+/**
+ * \brief 0-dimensional tensor holding \a value.
+ */
+template <class T>
+Tensor scalarTensor(T value) {
+    Tensor tensor({}, TensorDataType::of<T>());
+    *tensor.unsafeData<T>() = value;
+    return tensor;
+}
+
+template <class T>
+T unboundedLow() noexcept {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return -std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::lowest();
+    }
+}
+
+template <class T>
+T unboundedHigh() noexcept {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::max();
+    }
+}
+
+void checkMask(const Tensor& mask) {
+    if (mask.dtype() != TensorDataType::Bool && mask.dtype() != TensorDataType::UInt8) {
+        throw TypesMismatchError("Mask data type should be bool or uint8, got "
+                                 + to_string(mask.dtype()));
+    }
+}
+} // namespace
+} // namespace detail
+
+Tensor where(const Tensor& mask, const Tensor& a, const Tensor& b) {
+    detail::checkMask(mask);
+    Tensor out(detail::broadcastTensorShapes({mask, a, b}), a.dtype());
+    where(mask, a, b, out);
+    return out;
+}
+
+void where(const Tensor& mask, const Tensor& a, const Tensor& b, Tensor& out) {
+    detail::checkMask(mask);
+    if (a.dtype() != b.dtype() || a.dtype() != out.dtype()) {
+        throw TypesMismatchError("Operands and output data types are different");
+    }
+    const std::array<const Tensor*, 3> operands{&mask, &a, &b};
+    using detail::runTernary;
+    using detail::selectWhereKernels;
+    // Elements are selected as raw bits of the same size
+    switch (out.itemSize()) {
+        case 1:
+            return runTernary(selectWhereKernels<uint8_t>(), operands, out);
+        case 2:
+            return runTernary(selectWhereKernels<uint16_t>(), operands, out);
+        case 4:
+            return runTernary(selectWhereKernels<uint32_t>(), operands, out);
+        case 8:
+            return runTernary(selectWhereKernels<uint64_t>(), operands, out);
+        default:
+            throw TypesMismatchError("where is not supported for data type "
+                                     + to_string(out.dtype()));
+    }
+}
+
+Tensor
+clip(const Tensor& x, const std::optional<Tensor>& lo, const std::optional<Tensor>& hi) {
+    std::vector<Tensor> operands{x};
+    for (const auto* bound : {&lo, &hi}) {
+        if (*bound) {
+            operands.push_back(**bound);
+        }
+    }
+    Tensor out(detail::broadcastTensorShapes(operands), x.dtype());
+    clip(x, lo, hi, out);
+    return out;
+}
+
+void clip(const Tensor& x,
+          const std::optional<Tensor>& lo,
+          const std::optional<Tensor>& hi,
+          Tensor& out) {
+    if (!lo && !hi) {
+        throw std::invalid_argument("At least one of clip bounds is required");
+    }
+    if ((lo && lo->dtype() != x.dtype()) || (hi && hi->dtype() != x.dtype())
+        || out.dtype() != x.dtype()) {
+        throw TypesMismatchError("Operands and output data types are different");
+    }
+    detail::dispatchArithmeticDataType(x.dtype(), [&](auto tag) {
+        using T = typename decltype(tag)::type;
+        // Missing bound never limits x, it is splatted by kernels
+        const Tensor low = lo ? *lo : detail::scalarTensor(detail::unboundedLow<T>());
+        const Tensor high = hi ? *hi : detail::scalarTensor(detail::unboundedHigh<T>());
+        detail::runTernary(detail::selectClipKernels<T>(), {&x, &low, &high}, out);
+    });
+}
+} // namespace nope
@@ -0,0 +1,64 @@
+#include "ternary_bindings.h"
+
+#include <optional>
+#include <utility>
+
+#include "nope/tensor.h"
+#include "nope/ternary.h"
+
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace nope {
+void registerTernaryBindings(py::module_& module) {
+    module.def(
+        "where",
+        [](const Tensor& mask,
+           const Tensor& a,
+           const Tensor& b,
+           const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return where(mask, a, b);
+                }();
+                return py::cast(std::move(result));
+            }
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                where(mask, a, b, dst);
+            }
+            return out;
+        },
+        py::arg("mask"),
+        py::arg("a"),
+        py::arg("b"),
+        py::arg("out") = py::none());
+    module.def(
+        "clip",
+        [](const Tensor& x,
+           const std::optional<Tensor>& lo,
+           const std::optional<Tensor>& hi,
+           const py::object& out) -> py::object {
+            if (out.is_none()) {
+                Tensor result = [&] {
+                    py::gil_scoped_release release;
+                    return clip(x, lo, hi);
+                }();
+                return py::cast(std::move(result));
+            }
+            Tensor dst = out.cast<Tensor>();
+            {
+                py::gil_scoped_release release;
+                clip(x, lo, hi, dst);
+            }
+            return out;
+        },
+        py::arg("tensor"),
+        py::arg("lo") = py::none(),
+        py::arg("hi") = py::none(),
+        py::arg("out") = py::none());
+}
+} // namespace nope
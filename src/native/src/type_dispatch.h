@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "nope/tensor.h"
+#include "nope/tensor_data_type.h"
+
+namespace nope {
+namespace detail {
+template <class T>
+struct TypeTag {
+    using type = T;
+};
+
+template <class... Ts>
+struct TypeList {};
+
+using IntegerTypes =
+    TypeList<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t>;
+
+using FloatingPointTypes = TypeList<float, double>;
+
+using ArithmeticTypes = TypeList<int8_t,
+                                 uint8_t,
+                                 int16_t,
+                                 uint16_t,
+                                 int32_t,
+                                 uint32_t,
+                                 int64_t,
+                                 uint64_t,
+                                 float,
+                                 double>;
+
+/**
+ * \brief Invokes \a fn with \a TypeTag<T> for every type \a T of the list.
+ */
+template <class... Ts, class Fn>
+void forEachType(TypeList<Ts...> /* types */, Fn&& fn) {
+    (fn(TypeTag<Ts>{}), ...);
+}
+
+template <class Result, class Fn, class T>
+Result invokeWithTypeTag(Fn& fn) {
+    return fn(TypeTag<T>{});
+}
+
+/**
+ * \brief Table of \a fn instantiations indexed by TypeId, nullptr for the types
+ * missing in the list.
+ */
+template <class Result, class Fn, class... Ts>
+constexpr auto makeDispatchTable(TypeList<Ts...> /* types */) {
+    std::array<Result (*)(Fn&), TensorDataType::kTypesCount> table{};
+    ((table[TensorDataType::typeIdOf<Ts>()] = &invokeWithTypeTag<Result, Fn, Ts>), ...);
+    return table;
+}
+
+/**
+ * \brief Invokes \a fn with \a TypeTag<T> where \a T is the builtin type
+ * referred by \a dtype using a single lookup in a table of instantiations.
+ *
+ * \throw TypesMismatchError if \a dtype is not in \a Types.
+ */
+template <class... Ts, class Fn>
+decltype(auto) dispatchDataType(TypeList<Ts...> types,
+                                TensorDataType dtype,
+                                const char* expected,
+                                Fn&& fn) {
+    using F = std::remove_reference_t<Fn>;
+    using Result = std::common_type_t<std::invoke_result_t<F&, TypeTag<Ts>>...>;
+    static constexpr auto kTable = makeDispatchTable<Result, F>(types);
+    const auto thunk = dtype.typeId() < kTable.size() ? kTable[dtype.typeId()] : nullptr;
+    if (thunk == nullptr) {
+        throw TypesMismatchError(std::string("Expected ") + expected
+                                 + " data type, got: " + to_string(dtype));
+    }
+    return thunk(fn);
+}
+
+/**
+ * \brief Invokes \a fn with \a TypeTag<T> where \a T is the builtin integer
+ * type referred by \a dtype.
+ *
+ * \throw TypesMismatchError if \a dtype is not an integer type.
+ */
+template <class Fn>
+decltype(auto) dispatchIntegerDataType(TensorDataType dtype, Fn&& fn) {
+    return dispatchDataType(IntegerTypes{}, dtype, "integer", std::forward<Fn>(fn));
+}
+
+/**
+ * \brief Invokes \a fn with \a TypeTag<T> where \a T is the builtin integer or
+ * floating point type referred by \a dtype.
+ *
+ * \throw TypesMismatchError if \a dtype is not an arithmetic type.
+ */
+template <class Fn>
+decltype(auto) dispatchArithmeticDataType(TensorDataType dtype, Fn&& fn) {
+    return dispatchDataType(ArithmeticTypes{}, dtype, "arithmetic", std::forward<Fn>(fn));
+}
+} // namespace detail
+} // namespace nope
@@ -1,9 +1,98 @@
 from ._nope import (
     is_contiguous,
     broadcast_shapes,
-    calculate_effective_shape_and_strides
+    calculate_effective_shape_and_strides,
+    get_num_threads,
+    set_num_threads,
+    promote_types
 )
 
+from ._nope import (
+    AllocationPolicy,
+    NumaPlacement,
+    get_allocation_policy,
+    set_allocation_policy,
+    is_numa_available,
+    empty_shared,
+    to_shared_memory,
+    is_shared_memory,
+    MemoryStats,
+    memory_stats,
+    memory_stats_by_tag,
+    reset_peak_memory_stats,
+    memory_tag,
+    AllocationRecord,
+    set_memory_debug,
+    is_memory_debug_enabled,
+    live_allocations
+)
+
+from ._nope import (
+    take,
+    index_select,
+    scatter_add,
+    masked_select
+)
+
+from ._nope import (
+    concatenate,
+    stack,
+    split,
+    chunk,
+    unbind
+)
+
+from ._nope import (
+    sort,
+    argsort,
+    topk
+)
+
+from ._nope import (
+    exp,
+    log,
+    tanh,
+    sigmoid,
+    erf,
+    gelu
+)
+
+from ._nope import (
+    add,
+    subtract,
+    multiply,
+    divide,
+    BroadcastPattern,
+    select_broadcast_pattern,
+    set_broadcast_pattern_kernels_enabled,
+    are_broadcast_pattern_kernels_enabled
+)
+
+from ._nope import (
+    where,
+    clip
+)
+
+from ._nope import (
+    softmax,
+    log_softmax,
+    layer_norm
+)
+
+from ._nope import ElementwiseKernel
+
+from ._nope import PackedTensorList
+
+from ._nope import (
+    QuantizationParams,
+    quantize,
+    dequantize,
+    quantized_add,
+    quantized_mul
+)
+
+from . import random
+from . import multiprocessing
 from .tensor import Tensor, TensorDataType
 
 from ._nope import (
@@ -13,6 +102,11 @@ from ._nope import (
     uint16,
     int32,
     uint32,
+    int64,
+    uint64,
     float32,
-    float64
+    float64,
+    bool_
 )
+
+multiprocessing.init_reductions()
@@ -0,0 +1,38 @@
+"""Zero-copy transfer of tensors between processes.
+
+Tensors sent through multiprocessing queues, pipes and process arguments
+are pickled as a shared memory segment file descriptor plus view metadata.
+The receiving process maps the same pages, so the transfer cost doesn't
+depend on the tensor size. Tensors which are not in shared memory yet are
+copied there once; allocate them with `nope.empty_shared` to avoid the copy.
+"""
+from multiprocessing.context import get_spawning_popen
+from multiprocessing.reduction import DupFd, ForkingPickler
+
+from ._nope import (
+    Tensor,
+    to_shared_memory,
+    _from_shared_memory,
+    _shared_memory_handle
+)
+
+
+def _rebuild_tensor(dup_fd, storage_size, shape, strides, storage_offset,
+                    type_id, quantization):
+    return _from_shared_memory(dup_fd.detach(), storage_size, shape, strides,
+                               storage_offset, type_id, quantization)
+
+
+def _reduce_tensor(tensor):
+    shared = to_shared_memory(tensor)
+    popen = get_spawning_popen()
+    if popen is not None:
+        # Descriptors of process arguments are passed to the child when it is
+        # started, so the segment should stay open until then
+        popen.__dict__.setdefault("_nope_shared_tensors", []).append(shared)
+    fd, *metadata = _shared_memory_handle(shared)
+    return _rebuild_tensor, (DupFd(fd), *metadata)
+
+
+def init_reductions() -> None:
+    ForkingPickler.register(Tensor, _reduce_tensor)
@@ -0,0 +1,8 @@
+from ._nope import random as _random
+
+uniform = _random.uniform
+normal = _random.normal
+randint = _random.randint
+uniform_ = _random.uniform_
+normal_ = _random.normal_
+randint_ = _random.randint_
@@ -0,0 +1,46 @@
+import pytest
+import numpy as np
+
+import nope
+
+
+@pytest.fixture
+def restore_allocation_policy():
+    policy = nope.get_allocation_policy()
+    yield
+    nope.set_allocation_policy(policy)
+
+
+def test_allocation_policy_round_trip(restore_allocation_policy) -> None:
+    policy = nope.AllocationPolicy()
+    policy.huge_pages_threshold = 1 << 20
+    policy.parallel_first_touch = False
+    policy.numa_placement = nope.NumaPlacement.INTERLEAVE
+    nope.set_allocation_policy(policy)
+
+    actual = nope.get_allocation_policy()
+    assert actual.huge_pages_threshold == 1 << 20
+    assert not actual.parallel_first_touch
+    assert actual.numa_placement == nope.NumaPlacement.INTERLEAVE
+    assert isinstance(nope.is_numa_available(), bool)
+
+
+@pytest.mark.parametrize("placement", (nope.NumaPlacement.FIRST_TOUCH,
+                                       nope.NumaPlacement.INTERLEAVE,
+                                       nope.NumaPlacement.BIND))
+@pytest.mark.parametrize("first_touch", (True, False))
+def test_large_tensors_are_usable(placement, first_touch: bool,
+                                  restore_allocation_policy) -> None:
+    policy = nope.AllocationPolicy()
+    policy.huge_pages_threshold = 1 << 20
+    policy.parallel_first_touch = first_touch
+    policy.numa_placement = placement
+    nope.set_allocation_policy(policy)
+
+    tensor = nope.random.uniform((512, 1024), seed=1)
+    expected = np.asarray(nope.random.uniform((16,), seed=1))
+    values = np.asarray(tensor)
+    assert values.ctypes.data % 64 == 0
+    np.testing.assert_array_equal(values.ravel()[:16], expected)
+    np.testing.assert_array_equal(np.asarray(nope.sort(tensor))[:, -1],
+                                  values.max(axis=1))
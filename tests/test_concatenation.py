@@ -0,0 +1,132 @@
+import gc
+
+import pytest
+import numpy as np
+
+import nope
+
+
+@pytest.mark.parametrize("axis", (0, 1, -1))
+def test_concatenate_mixed_layouts(axis: int) -> None:
+    rng = np.random.default_rng(0)
+    shape = [6, 5]
+    shape[axis] = 3
+    contiguous = rng.normal(size=shape)
+    transposed = rng.normal(size=shape[::-1]).T
+    strided = rng.normal(size=(shape[0] * 2, shape[1] * 3))[::2, ::3]
+    empty_shape = list(shape)
+    empty_shape[axis] = 0
+    empty = np.zeros(empty_shape)
+
+    tensors = [contiguous, transposed, empty, strided]
+    actual = np.asarray(nope.concatenate(tensors, axis=axis))
+    assert actual.flags.c_contiguous
+    np.testing.assert_array_equal(actual, np.concatenate(tensors, axis=axis))
+
+
+def test_concatenate_many_inputs() -> None:
+    tensors = [np.full((33, 7), i, dtype=np.int16) for i in range(200)]
+
+    for axis in (0, 1):
+        np.testing.assert_array_equal(nope.concatenate(tensors, axis),
+                                      np.concatenate(tensors, axis))
+
+
+@pytest.mark.parametrize("axis", (0, 1, 2, -1))
+def test_stack(axis: int) -> None:
+    rng = np.random.default_rng(1)
+    tensors = [rng.normal(size=(4, 3)).astype(np.float32),
+               rng.normal(size=(3, 4)).astype(np.float32).T,
+               rng.normal(size=(4, 3)).astype(np.float32)]
+
+    np.testing.assert_array_equal(nope.stack(tensors, axis=axis),
+                                  np.stack(tensors, axis=axis))
+
+
+def test_stack_scalars() -> None:
+    np.testing.assert_array_equal(nope.stack([np.array(1.0), np.array(2.0)]),
+                                  np.array([1.0, 2.0]))
+
+
+def test_split_views() -> None:
+    values = np.arange(7 * 4, dtype=np.int32).reshape(7, 4)
+    tensor = nope.Tensor(values)
+
+    parts = nope.split(tensor, 3)
+    assert [part.shape for part in parts] == [[3, 4], [3, 4], [1, 4]]
+    for part, expected in zip(parts, np.split(values, [3, 6])):
+        np.testing.assert_array_equal(part, expected)
+
+    parts = nope.split(tensor, [1, 0, 3], axis=1)
+    assert [part.shape for part in parts] == [[7, 1], [7, 0], [7, 3]]
+    np.testing.assert_array_equal(parts[2], values[:, 1:])
+
+    # Views share memory with the source
+    values[6, 3] = -1
+    assert np.asarray(parts[2])[6, 2] == -1
+    assert parts[2].storage_offset == 4
+
+
+def test_chunk_and_unbind() -> None:
+    values = np.arange(5 * 6, dtype=np.float64).reshape(5, 6)
+    tensor = nope.Tensor(values)
+
+    chunks = nope.chunk(tensor, 4, axis=1)
+    assert [part.shape for part in chunks] == [[5, 2], [5, 2], [5, 2]]
+    np.testing.assert_array_equal(nope.concatenate(chunks, axis=1), values)
+
+    rows = nope.unbind(tensor, axis=-1)
+    assert len(rows) == 6
+    for i, row in enumerate(rows):
+        assert row.shape == [5]
+        np.testing.assert_array_equal(row, values[:, i])
+    np.testing.assert_array_equal(nope.stack(rows, axis=1), values)
+
+
+def test_reversed_inputs() -> None:
+    values = np.arange(10.0)[::-1]
+    parts = nope.split(values, 3)
+    for part, expected in zip(parts, np.split(values, [3, 6, 9])):
+        np.testing.assert_array_equal(part, expected)
+    np.testing.assert_array_equal(nope.concatenate(nope.chunk(values, 4)), values)
+    np.testing.assert_array_equal(nope.stack([values]), values[np.newaxis])
+
+    matrix = np.arange(12, dtype=np.int32).reshape(3, 4)[::-1, ::-2]
+    columns = nope.unbind(matrix, axis=1)
+    for i, column in enumerate(columns):
+        np.testing.assert_array_equal(column, matrix[:, i])
+    np.testing.assert_array_equal(nope.stack(columns, axis=1), matrix)
+
+
+def test_views_keep_source_alive() -> None:
+    parts = nope.split(np.arange(10.0), 3)
+    rows = nope.unbind(np.arange(12.0).reshape(3, 4)[::-1])
+    gc.collect()
+    # Reuse memory of the sources if they were freed
+    np.full(100, -1.0)
+    np.testing.assert_array_equal(nope.concatenate(parts), np.arange(10.0))
+    np.testing.assert_array_equal(rows[0], [8.0, 9.0, 10.0, 11.0])
+
+
+def test_errors() -> None:
+    a = np.zeros((2, 3), dtype=np.float32)
+    with pytest.raises(ValueError):
+        nope.concatenate([])
+    with pytest.raises(ValueError):
+        nope.concatenate([a, np.zeros((3, 3), dtype=np.float32)], axis=1)
+    with pytest.raises(RuntimeError):
+        nope.concatenate([a, np.zeros((2, 3))])
+    with pytest.raises(IndexError):
+        nope.concatenate([a], axis=2)
+    with pytest.raises(ValueError):
+        nope.stack([a, np.zeros((3, 2), dtype=np.float32)])
+
+    tensor = nope.Tensor(a)
+    with pytest.raises(ValueError):
+        nope.split(tensor, 0)
+    with pytest.raises(ValueError):
+        nope.split(tensor, [1, 2])
+    with pytest.raises(ValueError):
+        nope.chunk(tensor, 0)
+    with pytest.raises(IndexError):
+        nope.unbind(tensor, 2)
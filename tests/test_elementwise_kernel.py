@@ -0,0 +1,154 @@
+import ctypes
+
+import pytest
+import numpy as np
+
+import nope
+
+LOOP_TYPE = ctypes.CFUNCTYPE(None, ctypes.POINTER(ctypes.c_void_p),
+                             ctypes.POINTER(ctypes.c_int64), ctypes.c_int64,
+                             ctypes.c_void_p)
+
+
+def make_loop(n_inputs, in_ctype, out_ctype, function):
+    """Wraps Python function of scalars into the inner loop of ElementwiseKernel"""
+
+    def loop(data, strides, count, user_data):
+        for i in range(count):
+            args = [
+                in_ctype.from_address(data[k] + i * strides[k]).value
+                for k in range(n_inputs)
+            ]
+            out = out_ctype.from_address(data[n_inputs] + i * strides[n_inputs])
+            out.value = function(*args, user_data)
+
+    return LOOP_TYPE(loop)
+
+
+def make_fma_kernel():
+    kernel = nope.ElementwiseKernel("fma", 3)
+    kernel.register_loop(
+        nope.float64,
+        make_loop(3, ctypes.c_double, ctypes.c_double, lambda a, b, c, _: a * b + c))
+    return kernel
+
+
+def test_properties() -> None:
+    kernel = make_fma_kernel()
+    assert kernel.name == "fma"
+    assert kernel.n_inputs == 3
+    assert kernel.grain_size > 0
+    assert kernel.has_loop(nope.float64)
+    assert not kernel.has_loop(nope.float32)
+    assert repr(kernel) == "ElementwiseKernel(name='fma', n_inputs=3)"
+
+
+def test_broadcasting() -> None:
+    rng = np.random.default_rng(0)
+    a = rng.normal(size=(4, 1, 5))
+    b = rng.normal(size=(3, 1))
+    c = rng.normal(size=(5, ))
+
+    actual = np.asarray(make_fma_kernel()(a, b, c))
+    assert actual.shape == (4, 3, 5)
+    np.testing.assert_allclose(actual, a * b + c, rtol=1e-15)
+
+
+def test_strided_inputs() -> None:
+    base = np.random.default_rng(1).normal(size=(12, 20))
+    view = base[::3, 1::2]
+
+    actual = make_fma_kernel()(view, view, np.array(1.0))
+    np.testing.assert_allclose(actual, view * view + 1, rtol=1e-15)
+
+
+def test_output_data_type_and_out() -> None:
+    kernel = nope.ElementwiseKernel("greater", 2, grain_size=16)
+    kernel.register_loop(nope.int32,
+                         make_loop(2, ctypes.c_int32, ctypes.c_bool,
+                                   lambda a, b, _: a > b),
+                         out_dtype=nope.bool_)
+    a = np.arange(-20, 20, dtype=np.int32).reshape(8, 5)
+    b = np.array([0, 3, -3, 10, -10], dtype=np.int32)
+
+    actual = np.asarray(kernel(a, b))
+    assert actual.dtype == np.bool_
+    np.testing.assert_array_equal(actual, a > b)
+
+    out = np.zeros((8, 5), dtype=np.bool_)
+    kernel(a, b, out=nope.Tensor(out))
+    np.testing.assert_array_equal(out, a > b)
+    out = np.zeros((8, 5), dtype=np.bool_)
+    assert kernel(a, b, out=out) is out
+    np.testing.assert_array_equal(out, a > b)
+
+    with pytest.raises(RuntimeError):
+        kernel(a, b, out=nope.Tensor(np.zeros((8, 5), dtype=np.int32)))
+
+
+def test_in_place() -> None:
+    values = np.linspace(-1, 1, 100)
+    tensor = nope.Tensor(values.copy())
+
+    make_fma_kernel()(tensor, tensor, tensor, out=tensor)
+    np.testing.assert_allclose(tensor, values * values + values, rtol=1e-15)
+
+
+def test_user_data() -> None:
+    scale = ctypes.c_double(2.5)
+    kernel = nope.ElementwiseKernel("scale", 1)
+    kernel.register_loop(
+        nope.float64,
+        make_loop(1, ctypes.c_double, ctypes.c_double,
+                  lambda x, user_data: x * ctypes.c_double.from_address(user_data).value),
+        user_data=ctypes.addressof(scale))
+
+    np.testing.assert_allclose(kernel(np.arange(10.0)), np.arange(10.0) * 2.5)
+
+
+def test_errors() -> None:
+    kernel = make_fma_kernel()
+    a = np.zeros(4)
+    with pytest.raises(ValueError):
+        kernel(a, a)
+    with pytest.raises(ValueError):
+        kernel(a, a, np.zeros(3))
+    with pytest.raises(RuntimeError):
+        kernel(a, a, np.zeros(4, dtype=np.float32))
+    with pytest.raises(RuntimeError):
+        kernel(np.zeros(4, dtype=np.float32), np.zeros(4, dtype=np.float32),
+               np.zeros(4, dtype=np.float32))
+    with pytest.raises(ValueError):
+        nope.ElementwiseKernel("too_many_inputs", 9)
+    with pytest.raises(ValueError):
+        kernel.register_loop(nope.float32, 0)
+
+
+def test_numba_cfunc() -> None:
+    numba = pytest.importorskip("numba")
+    from numba import types
+
+    signature = types.void(types.CPointer(types.voidptr), types.CPointer(types.int64),
+                           types.int64, types.voidptr)
+
+    @numba.cfunc(signature)
+    def hypot_loop(data, strides, count, user_data):
+        pointers = numba.carray(data, 3)
+        steps = numba.carray(strides, 3)
+        item_size = 8
+        x = numba.carray(pointers[0], (count - 1) * steps[0] // item_size + 1,
+                         dtype=np.float64)
+        y = numba.carray(pointers[1], (count - 1) * steps[1] // item_size + 1,
+                         dtype=np.float64)
+        z = numba.carray(pointers[2], (count - 1) * steps[2] // item_size + 1,
+                         dtype=np.float64)
+        for i in range(count):
+            z[i * steps[2] // item_size] = np.hypot(x[i * steps[0] // item_size],
+                                                    y[i * steps[1] // item_size])
+
+    kernel = nope.ElementwiseKernel("hypot", 2)
+    kernel.register_loop(nope.float64, hypot_loop)
+    x = np.random.default_rng(2).normal(size=(300, 70))
+    y = np.random.default_rng(3).normal(size=(70, ))
+
+    np.testing.assert_allclose(kernel(x, y), np.hypot(x, y), rtol=1e-15)
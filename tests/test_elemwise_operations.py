@@ -1,90 +1,202 @@
-# import pytest
-# import numpy as np
-# from typing import Callable
+import pytest
+import numpy as np
+from typing import Callable
 
-# from nope import elemwise_sum, elemwise_mul
+import nope
 
 
-# def elementwise_sum_op(a, b):
-#     expected = a + b
-#     actual = elemwise_sum(a, b)
-#     np.testing.assert_allclose(actual, expected,
-#                                err_msg=f"Test failed for input:\na={a}\nb={b}")
+def elementwise_sum_op(a, b):
+    expected = a + b
+    actual = nope.add(a, b)
+    np.testing.assert_allclose(actual, expected,
+                               err_msg=f"Test failed for input:\na={a}\nb={b}")
 
 
-# def elementwise_mul_op(a, b):
-#     expected = a * b
-#     actual = elemwise_mul(a, b)
-#     np.testing.assert_allclose(actual, expected,
-#                                err_msg=f"Test failed for input:\na={a}\nb={b}")
+def elementwise_sub_op(a, b):
+    expected = a - b
+    actual = nope.subtract(a, b)
+    np.testing.assert_allclose(actual, expected,
+                               err_msg=f"Test failed for input:\na={a}\nb={b}")
 
 
-# BinaryOperation = Callable[[np.ndarray, np.ndarray], np.ndarray]
-# OPERATIONS_SET = (elementwise_sum_op, elementwise_mul_op)
+def elementwise_mul_op(a, b):
+    expected = a * b
+    actual = nope.multiply(a, b)
+    np.testing.assert_allclose(actual, expected,
+                               err_msg=f"Test failed for input:\na={a}\nb={b}")
 
 
-# @pytest.mark.parametrize("binary_op", OPERATIONS_SET)
-# @pytest.mark.parametrize("operands_shapes", )
-# def test_elementwise_op_1d_and_1d_continuous(binary_op: BinaryOperation):
-#     a = np.array([1, 2, 3])
-#     b = np.array([2, 3, 5])
+BinaryOperation = Callable[[np.ndarray, np.ndarray], None]
+OPERATIONS_SET = (elementwise_sum_op, elementwise_sub_op, elementwise_mul_op)
 
-#     test_op(a, b)
 
+@pytest.fixture(params=[True, False], ids=["pattern_kernels", "generic"])
+def pattern_kernels(request):
+    previous = nope.are_broadcast_pattern_kernels_enabled()
+    nope.set_broadcast_pattern_kernels_enabled(request.param)
+    yield request.param
+    nope.set_broadcast_pattern_kernels_enabled(previous)
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_1d_and_1d_non_continuous(test_op):
-#     base = np.arange(10, dtype=np.int32)
-#     a = base[::2]
-#     b = base[:5]
 
-#     test_op(a, b)
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_1d_and_1d_continuous(test_op: BinaryOperation,
+                                             pattern_kernels):
+    a = np.array([1, 2, 3])
+    b = np.array([2, 3, 5])
 
+    test_op(a, b)
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_2d_and_2d_continuous(test_op):
-#     a = np.hstack([10 * np.arange(4, dtype=np.int32), ] * 4)
-#     b = np.hstack([np.arange(4, dtype=np.int32), ] * 4)
 
-#     test_op(a, b)
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_1d_and_1d_non_continuous(test_op, pattern_kernels):
+    base = np.arange(10, dtype=np.int32)
+    a = base[::2]
+    b = base[:5]
 
+    test_op(a, b)
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_2d_and_2d_non_continuous(test_op):
-#     b = np.arange(16).reshape((4, 4))
-#     a = b * 10
 
-#     test_op(a[::2, ::2], b[::2, ::2])
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_2d_and_2d_continuous(test_op, pattern_kernels):
+    a = np.hstack([10 * np.arange(4, dtype=np.int32), ] * 4)
+    b = np.hstack([np.arange(4, dtype=np.int32), ] * 4)
 
+    test_op(a, b)
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_3d_and_3d_continuous(test_op):
-#     b = np.arange(5 * 5 * 3, dtype=np.int32).reshape((5, 5, 3))
-#     a = b * 10
 
-#     test_op(a, b)
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_2d_and_2d_non_continuous(test_op, pattern_kernels):
+    b = np.arange(16).reshape((4, 4))
+    a = b * 10
 
+    test_op(a[::2, ::2], b[::2, ::2])
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_1d_and_1d_with_newaxis(test_op):
-#     a = 10 * np.arange(4)
-#     b = np.arange(3)
 
-#     test_op(a[:, np.newaxis], b[np.newaxis, :])
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_3d_and_3d_continuous(test_op, pattern_kernels):
+    b = np.arange(5 * 5 * 3, dtype=np.int32).reshape((5, 5, 3))
+    a = b * 10
 
+    test_op(a, b)
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_2d_and_1d_continuous(test_op):
-#     a = np.arange(5 * 4, dtype=np.float32).reshape((4, 5))
-#     b = np.arange(5, dtype=np.float32)
 
-#     test_op(a, b)
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_1d_and_1d_with_newaxis(test_op, pattern_kernels):
+    a = 10 * np.arange(4)
+    b = np.arange(3)
 
+    test_op(a[:, np.newaxis], b[np.newaxis, :])
 
-# @pytest.mark.parametrize("test_op", OPERATIONS_SET)
-# def test_elementwise_op_4d_and_3d_non_continuous(test_op):
-#     a = 100 * np.arange(8 * 1 * 6 * 1, dtype=np.int32).reshape((8, 1, 6, 1))
-#     b_src = np.arange(7 * 3 * 5, dtype=np.int32).reshape(7, 3, 5)
-#     b = b_src[:, ::3, :]
 
-#     test_op(a, b)
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_2d_and_1d_continuous(test_op, pattern_kernels):
+    a = np.arange(5 * 4, dtype=np.float32).reshape((4, 5))
+    b = np.arange(5, dtype=np.float32)
+
+    test_op(a, b)
+    test_op(b, a)
+
+
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+def test_elementwise_op_4d_and_3d_non_continuous(test_op, pattern_kernels):
+    a = 100 * np.arange(8 * 1 * 6 * 1, dtype=np.int32).reshape((8, 1, 6, 1))
+    b_src = np.arange(7 * 3 * 5, dtype=np.int32).reshape(7, 3, 5)
+    b = b_src[:, ::3, :]
+
+    test_op(a, b)
+
+
+@pytest.mark.parametrize("test_op", OPERATIONS_SET)
+@pytest.mark.parametrize("dtype", (np.int8, np.uint16, np.int32, np.int64,
+                                   np.float32, np.float64))
+@pytest.mark.parametrize("shapes", (((1000, ), ()), ((), (1000, )), ((300, 70), (70, )),
+                                    ((70, ), (300, 70)), ((300, 70), (300, 1)),
+                                    ((300, 1), (300, 70)), ((4, 30, 50), (30, 1))))
+def test_elementwise_op_broadcast_patterns(test_op, dtype, shapes, pattern_kernels):
+    rng = np.random.default_rng(0)
+    a = rng.integers(0, 100, size=shapes[0]).astype(dtype)
+    b = rng.integers(1, 100, size=shapes[1]).astype(dtype)
+
+    test_op(a, b)
+
+
+@pytest.mark.parametrize("lhs_shape, rhs_shape, expected", (
+    ((1000, ), (), nope.BroadcastPattern.SCALAR_RHS),
+    ((), (1000, ), nope.BroadcastPattern.SCALAR_LHS),
+    ((300, 70), (70, ), nope.BroadcastPattern.ROW_RHS),
+    ((8, 300, 70), (70, ), nope.BroadcastPattern.ROW_RHS),
+    ((1, 70), (300, 70), nope.BroadcastPattern.ROW_LHS),
+    ((300, 70), (300, 1), nope.BroadcastPattern.COLUMN_RHS),
+    ((8, 16, 1), (8, 16, 70), nope.BroadcastPattern.COLUMN_LHS),
+    ((300, 70), (300, 70), nope.BroadcastPattern.GENERIC),
+    ((8, 1, 70), (16, 1), nope.BroadcastPattern.COLUMN_RHS),
+    ((8, 1, 70), (16, 70), nope.BroadcastPattern.GENERIC),
+))
+def test_select_broadcast_pattern(lhs_shape, rhs_shape, expected):
+    lhs = np.zeros(lhs_shape, dtype=np.float32)
+    rhs = np.zeros(rhs_shape, dtype=np.float32)
+    out = nope.Tensor(np.zeros(np.broadcast_shapes(lhs_shape, rhs_shape),
+                               dtype=np.float32))
+
+    assert nope.select_broadcast_pattern(lhs, rhs, out) == expected
+
+    nope.set_broadcast_pattern_kernels_enabled(False)
+    try:
+        assert (nope.select_broadcast_pattern(lhs, rhs, out)
+                == nope.BroadcastPattern.GENERIC)
+    finally:
+        nope.set_broadcast_pattern_kernels_enabled(True)
+
+
+def test_divide(pattern_kernels):
+    rng = np.random.default_rng(1)
+    a = rng.normal(size=(64, 33)).astype(np.float32)
+    b = rng.uniform(1, 2, size=(64, 1)).astype(np.float32)
+
+    np.testing.assert_allclose(nope.divide(a, b), a / b, rtol=1e-6)
+    np.testing.assert_allclose(nope.divide(2.0 * np.ones(5), np.arange(1.0, 6.0)),
+                               2.0 / np.arange(1.0, 6.0), rtol=1e-15)
+
+    with pytest.raises(RuntimeError):
+        nope.divide(np.ones(4, dtype=np.int32), np.ones(4, dtype=np.int32))
+
+
+def test_integer_wrap_around(pattern_kernels):
+    a = np.array([120, 127, -128], dtype=np.int8)
+    b = np.array([10], dtype=np.int8)
+
+    np.testing.assert_array_equal(nope.add(a, b), a + b)
+    np.testing.assert_array_equal(nope.multiply(a, b), a * b)
+
+
+def test_out_and_in_place(pattern_kernels):
+    rng = np.random.default_rng(2)
+    a = rng.normal(size=(40, 50))
+    bias = rng.normal(size=(50, ))
+
+    out = np.zeros((40, 50))
+    nope.add(a, bias, out=nope.Tensor(out))
+    np.testing.assert_allclose(out, a + bias, rtol=1e-15)
+
+    transposed = np.zeros((50, 40)).T
+    nope.add(a, bias, out=nope.Tensor(transposed))
+    np.testing.assert_allclose(transposed, a + bias, rtol=1e-15)
+
+    out = np.zeros((40, 50))
+    assert nope.subtract(a, bias, out=out) is out
+    np.testing.assert_allclose(out, a - bias, rtol=1e-15)
+
+    tensor = nope.Tensor(a.copy())
+    scale = rng.normal(size=(40, 1))
+    nope.multiply(tensor, scale, out=tensor)
+    np.testing.assert_allclose(tensor, a * scale, rtol=1e-15)
+
+
+def test_errors():
+    a = np.zeros((4, 5), dtype=np.float32)
+    with pytest.raises(ValueError):
+        nope.add(a, np.zeros(4, dtype=np.float32))
+    with pytest.raises(RuntimeError):
+        nope.add(a, np.zeros(5, dtype=np.float64))
+    with pytest.raises(ValueError):
+        nope.add(a, a, out=nope.Tensor(np.zeros((3, 5), dtype=np.float32)))
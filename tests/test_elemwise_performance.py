@@ -1,40 +1,83 @@
-# import pytest
-# import numpy as np
+import pytest
+import numpy as np
 
-# from nope import elemwise_sum
+import nope
 
 
-# SHAPES_SET = ((13, ), (123, ), (1027,), (1, 123), (8, 256, 128, 100))
-# TYPES_SET = (np.float32, np.float64,)
+SHAPES_SET = ((13, ), (123, ), (1027,), (1, 123), (8, 256, 128, 100))
+TYPES_SET = (np.float32, np.float64,)
 
+# Broadcast patterns: (lhs shape, rhs shape)
+PATTERNS_SET = {
+    "scalar": ((1024 * 1024, ), ()),
+    "row": ((16384, 64), (64, )),
+    "column": ((16384, 64), (16384, 1)),
+    "column_3d": ((32, 64, 1024), (64, 1)),
+}
 
-# def shape_to_str(value):
-#     if isinstance(value, tuple):
-#         return str(value)
 
+def shape_to_str(value):
+    if isinstance(value, tuple):
+        return str(value)
 
-# @pytest.mark.parametrize("shape", SHAPES_SET, ids=shape_to_str)
-# @pytest.mark.parametrize("dtype", TYPES_SET)
-# def test_benchmark_elementwise_sum_continuous_matching_shapes_numpy(benchmark,
-#                                                                     shape,
-#                                                                     dtype):
-#     def test_func():
-#         return a + b
 
-#     a = np.zeros(shape, dtype=dtype)
-#     b = np.ones(shape, dtype=dtype)
+@pytest.fixture(params=[True, False], ids=["pattern_kernels", "generic"])
+def pattern_kernels(request):
+    previous = nope.are_broadcast_pattern_kernels_enabled()
+    nope.set_broadcast_pattern_kernels_enabled(request.param)
+    yield request.param
+    nope.set_broadcast_pattern_kernels_enabled(previous)
 
-#     result = benchmark(test_func)
 
+@pytest.mark.parametrize("shape", SHAPES_SET, ids=shape_to_str)
+@pytest.mark.parametrize("dtype", TYPES_SET)
+def test_benchmark_elementwise_sum_continuous_matching_shapes_numpy(benchmark,
+                                                                    shape,
+                                                                    dtype):
+    def test_func():
+        return a + b
 
-# @pytest.mark.parametrize("shape", SHAPES_SET, ids=shape_to_str)
-# @pytest.mark.parametrize("dtype", TYPES_SET)
-# def test_benchmark_elementwise_sum_continuous_matching_shapes_nope(benchmark,
-#                                                                    shape,
-#                                                                    dtype):
-#     a = np.zeros(shape, dtype=dtype)
-#     b = np.ones(shape, dtype=dtype)
+    a = np.zeros(shape, dtype=dtype)
+    b = np.ones(shape, dtype=dtype)
 
-#     result = benchmark(elemwise_sum, a, b)
+    benchmark(test_func)
 
-#     np.testing.assert_equal(result, a + b)
+
+@pytest.mark.parametrize("shape", SHAPES_SET, ids=shape_to_str)
+@pytest.mark.parametrize("dtype", TYPES_SET)
+def test_benchmark_elementwise_sum_continuous_matching_shapes_nope(benchmark,
+                                                                   shape,
+                                                                   dtype):
+    a = np.zeros(shape, dtype=dtype)
+    b = np.ones(shape, dtype=dtype)
+
+    result = benchmark(nope.add, a, b)
+
+    np.testing.assert_equal(result, a + b)
+
+
+@pytest.mark.parametrize("pattern", PATTERNS_SET)
+@pytest.mark.parametrize("dtype", TYPES_SET)
+def test_benchmark_elementwise_mul_broadcast_pattern_numpy(benchmark, pattern, dtype):
+    lhs_shape, rhs_shape = PATTERNS_SET[pattern]
+    a = np.ones(lhs_shape, dtype=dtype)
+    b = np.full(rhs_shape, 2, dtype=dtype)
+    out = np.empty(np.broadcast_shapes(lhs_shape, rhs_shape), dtype=dtype)
+
+    benchmark(np.multiply, a, b, out=out)
+
+
+@pytest.mark.parametrize("pattern", PATTERNS_SET)
+@pytest.mark.parametrize("dtype", TYPES_SET)
+def test_benchmark_elementwise_mul_broadcast_pattern_nope(benchmark,
+                                                          pattern,
+                                                          dtype,
+                                                          pattern_kernels):
+    lhs_shape, rhs_shape = PATTERNS_SET[pattern]
+    a = np.ones(lhs_shape, dtype=dtype)
+    b = np.full(rhs_shape, 2, dtype=dtype)
+    out = nope.Tensor(np.empty(np.broadcast_shapes(lhs_shape, rhs_shape), dtype=dtype))
+
+    benchmark(nope.multiply, a, b, out=out)
+
+    np.testing.assert_equal(np.asarray(out), a * b)
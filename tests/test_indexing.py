@@ -0,0 +1,147 @@
+from __future__ import annotations
+
+import pytest
+import numpy as np
+
+import nope
+
+
+INDEX_TYPES = (np.int8, np.uint8, np.int16, np.int32, np.int64, np.uint64)
+VALUE_TYPES = (np.int8, np.int32, np.float32, np.float64)
+
+
+@pytest.mark.parametrize("index_type", INDEX_TYPES)
+@pytest.mark.parametrize("axis", (0, 1, 2, -1))
+def test_take_matches_numpy(index_type: type, axis: int) -> None:
+    src = np.arange(4 * 5 * 6, dtype=np.float32).reshape(4, 5, 6)
+    indices = np.array([[3, 0], [1, 1]], dtype=index_type)
+
+    actual = np.asarray(nope.take(nope.Tensor(src), nope.Tensor(indices), axis))
+
+    np.testing.assert_array_equal(actual, np.take(src, indices, axis=axis))
+
+
+def test_take_wraps_negative_indices() -> None:
+    src = np.arange(20, dtype=np.int32).reshape(4, 5)
+    indices = np.array([-1, -5, 2], dtype=np.int64)
+
+    actual = np.asarray(nope.take(nope.Tensor(src), nope.Tensor(indices), 1))
+
+    np.testing.assert_array_equal(actual, np.take(src, indices, axis=1))
+
+
+def test_take_from_non_contiguous_tensor() -> None:
+    base = np.arange(6 * 8 * 10, dtype=np.float64).reshape(6, 8, 10)
+    src = base[::2, :, 1::3].transpose(1, 0, 2)
+    indices = np.array([7, 2, 2, 0], dtype=np.int32)
+
+    actual = np.asarray(nope.take(nope.Tensor(src), nope.Tensor(indices), 0))
+
+    np.testing.assert_array_equal(actual, np.take(src, indices, axis=0))
+
+
+def test_take_raises_on_out_of_bounds_index() -> None:
+    src = np.zeros((3, 4), dtype=np.float32)
+    with pytest.raises(IndexError):
+        nope.take(nope.Tensor(src), nope.Tensor(np.array([4], dtype=np.int64)), 1)
+
+
+def test_take_rejects_floating_point_indices() -> None:
+    src = np.zeros((3, 4), dtype=np.float32)
+    with pytest.raises(RuntimeError):
+        nope.take(nope.Tensor(src), nope.Tensor(np.array([1.0], dtype=np.float32)), 1)
+
+
+@pytest.mark.parametrize("axis", (0, 1))
+def test_index_select(axis: int) -> None:
+    src = np.arange(30, dtype=np.int32).reshape(5, 6)
+    indices = np.array([4, 0, 3], dtype=np.int64)
+
+    actual = np.asarray(nope.index_select(nope.Tensor(src), axis, nope.Tensor(indices)))
+
+    np.testing.assert_array_equal(actual, np.take(src, indices, axis=axis))
+
+
+def test_index_select_requires_1d_indices() -> None:
+    src = np.zeros((3, 4), dtype=np.float32)
+    indices = np.zeros((2, 2), dtype=np.int64)
+    with pytest.raises(ValueError):
+        nope.index_select(nope.Tensor(src), 0, nope.Tensor(indices))
+
+
+def scatter_add_reference(out: np.ndarray, axis: int, index: np.ndarray,
+                          src: np.ndarray) -> np.ndarray:
+    expected = out.copy()
+    for pos in np.ndindex(*index.shape):
+        dst_pos = list(pos)
+        dst_pos[axis] = index[pos]
+        expected[tuple(dst_pos)] += src[pos]
+    return expected
+
+
+@pytest.mark.parametrize("value_type", VALUE_TYPES)
+@pytest.mark.parametrize("axis", (0, 1))
+@pytest.mark.parametrize("num_threads", (1, 4))
+def test_scatter_add(value_type: type, axis: int, num_threads: int) -> None:
+    rng = np.random.default_rng(42)
+    out = np.zeros((4, 6), dtype=value_type)
+    src = rng.integers(0, 10, size=(7, 5)).astype(value_type)
+    if axis == 1:
+        src = src.T.copy()
+    index = rng.integers(0, out.shape[axis], size=src.shape).astype(np.int32)
+    expected = scatter_add_reference(out, axis, index, src)
+
+    previous_num_threads = nope.get_num_threads()
+    nope.set_num_threads(num_threads)
+    try:
+        nope.scatter_add(nope.Tensor(out), axis, nope.Tensor(index), nope.Tensor(src))
+    finally:
+        nope.set_num_threads(previous_num_threads)
+
+    np.testing.assert_array_equal(out, expected)
+
+
+def test_scatter_add_1d_histogram() -> None:
+    out = np.zeros(16, dtype=np.float64)
+    index = np.random.default_rng(0).integers(0, 16, size=100_000, dtype=np.uint16)
+    src = np.ones(index.shape, dtype=np.float64)
+
+    nope.scatter_add(nope.Tensor(out), 0, nope.Tensor(index), nope.Tensor(src))
+
+    np.testing.assert_array_equal(out, np.bincount(index, minlength=16))
+
+
+def test_scatter_add_rejects_mismatched_types() -> None:
+    out = np.zeros(4, dtype=np.float32)
+    index = np.zeros(4, dtype=np.int64)
+    src = np.zeros(4, dtype=np.float64)
+    with pytest.raises(RuntimeError):
+        nope.scatter_add(nope.Tensor(out), 0, nope.Tensor(index), nope.Tensor(src))
+
+
+@pytest.mark.parametrize("value_type", (np.uint8, np.int16, np.float32, np.int64))
+@pytest.mark.parametrize("size", (0, 1, 15, 1000, 300_001))
+@pytest.mark.parametrize("mask_type", (np.bool_, np.uint8))
+def test_masked_select(value_type: type, size: int, mask_type: type) -> None:
+    rng = np.random.default_rng(size)
+    src = rng.integers(0, 100, size=size).astype(value_type)
+    mask = (rng.random(size) < 0.3).astype(mask_type)
+
+    actual = np.asarray(nope.masked_select(nope.Tensor(src), nope.Tensor(mask)))
+
+    np.testing.assert_array_equal(actual, src[mask.astype(bool)])
+
+
+def test_masked_select_non_contiguous() -> None:
+    src = np.arange(100, dtype=np.float32).reshape(10, 10)[::2, ::3]
+    mask = src % 3 == 0
+
+    actual = np.asarray(nope.masked_select(nope.Tensor(src), nope.Tensor(mask)))
+
+    np.testing.assert_array_equal(actual, src[mask])
+
+
+def test_masked_select_rejects_non_boolean_mask() -> None:
+    src = np.zeros(4, dtype=np.float32)
+    with pytest.raises(RuntimeError):
+        nope.masked_select(nope.Tensor(src), nope.Tensor(np.zeros(4, dtype=np.int32)))
@@ -0,0 +1,114 @@
+import gc
+import math
+
+import pytest
+import numpy as np
+
+import nope
+
+FLOAT_DTYPES = ((np.float32, 1e-6), (np.float64, 1e-14))
+
+vectorized_erf = np.vectorize(math.erf, otypes=(np.float64, ))
+
+
+def reference_sigmoid(x):
+    return 1.0 / (1.0 + np.exp(-x))
+
+
+def reference_gelu(x):
+    return x * (1.0 + vectorized_erf(x / math.sqrt(2.0))) / 2.0
+
+
+FUNCTIONS = (
+    (nope.exp, np.exp, (-20, 20)),
+    (nope.log, np.log, (1e-3, 1e3)),
+    (nope.tanh, np.tanh, (-10, 10)),
+    (nope.sigmoid, reference_sigmoid, (-20, 20)),
+    (nope.erf, vectorized_erf, (-5, 5)),
+    (nope.gelu, reference_gelu, (-5, 5)),
+)
+
+
+@pytest.mark.parametrize("np_dtype,rtol", FLOAT_DTYPES)
+@pytest.mark.parametrize("function,reference,interval", FUNCTIONS)
+def test_matches_reference(function, reference, interval, np_dtype, rtol) -> None:
+    values = np.random.default_rng(0).uniform(*interval, size=(13, 1029))
+    values = values.astype(np_dtype)
+
+    result = np.asarray(function(values))
+    assert result.dtype == np_dtype
+    assert result.shape == values.shape
+    np.testing.assert_allclose(result,
+                               reference(values.astype(np.float64)),
+                               rtol=rtol,
+                               atol=np.finfo(np_dtype).tiny)
+
+
+@pytest.mark.parametrize("np_dtype,rtol", FLOAT_DTYPES)
+def test_special_values(np_dtype, rtol) -> None:
+    values = np.array([np.nan, np.inf, -np.inf, 0.0, -0.0], dtype=np_dtype)
+
+    np.testing.assert_array_equal(nope.exp(values), [np.nan, np.inf, 0, 1, 1])
+    np.testing.assert_array_equal(nope.tanh(values), [np.nan, 1, -1, 0, 0])
+    np.testing.assert_array_equal(nope.sigmoid(values), [np.nan, 1, 0, 0.5, 0.5])
+    np.testing.assert_array_equal(nope.erf(values), [np.nan, 1, -1, 0, 0])
+    np.testing.assert_array_equal(nope.gelu(values), [np.nan, np.inf, 0, 0, 0])
+    with np.errstate(divide="ignore", invalid="ignore"):
+        np.testing.assert_array_equal(
+            nope.log(np.array([np.nan, np.inf, 0, -1], dtype=np_dtype)),
+            [np.nan, np.inf, -np.inf, np.nan])
+
+
+@pytest.mark.parametrize("function,reference,interval", FUNCTIONS)
+def test_strided_input(function, reference, interval) -> None:
+    values = np.random.default_rng(1).uniform(*interval, size=(40, 60))
+    view = values[::3, 1::2]
+
+    np.testing.assert_allclose(function(view), reference(view), rtol=1e-14)
+
+
+@pytest.mark.parametrize("function,reference,interval", FUNCTIONS)
+def test_broadcasting_into_out(function, reference, interval) -> None:
+    row = np.random.default_rng(2).uniform(*interval, size=(17, ))
+    out = np.zeros((5, 17))
+
+    result = function(row, out=nope.Tensor(out))
+    expected = np.broadcast_to(reference(row), (5, 17))
+    np.testing.assert_allclose(out, expected, rtol=1e-14)
+    np.testing.assert_allclose(result, expected, rtol=1e-14)
+
+
+def test_out_array_is_returned() -> None:
+    values = np.linspace(-3, 3, 100)
+    out = np.empty_like(values)
+    assert nope.exp(values, out=out) is out
+
+    # The only reference to the temporary out array is the result
+    result = nope.exp(values, out=np.empty_like(values))
+    gc.collect()
+    np.testing.assert_allclose(result, np.exp(values), rtol=1e-14)
+
+
+def test_in_place() -> None:
+    values = np.linspace(-3, 3, 1000)
+    tensor = nope.Tensor(values.copy())
+
+    nope.sigmoid(tensor, out=tensor)
+    np.testing.assert_allclose(tensor, reference_sigmoid(values), rtol=1e-14)
+
+
+def test_empty_and_zero_dimensional() -> None:
+    assert np.asarray(nope.exp(np.zeros((0, 3)))).shape == (0, 3)
+    assert float(np.asarray(nope.exp(np.array(0.0)))) == 1.0
+
+
+def test_not_floating_point() -> None:
+    with pytest.raises(RuntimeError):
+        nope.exp(np.arange(10, dtype=np.int32))
+    with pytest.raises(RuntimeError):
+        nope.exp(np.zeros(3), out=nope.Tensor(np.zeros(3, dtype=np.float32)))
+
+
+def test_not_broadcastable() -> None:
+    with pytest.raises(ValueError):
+        nope.exp(np.zeros(4), out=nope.Tensor(np.zeros(3)))
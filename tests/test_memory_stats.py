@@ -0,0 +1,79 @@
+import numpy as np
+
+import nope
+
+
+def test_global_stats_follow_tensor_lifetime() -> None:
+    before = nope.memory_stats()
+    tensor = nope.random.uniform((256, 256), seed=1)
+    during = nope.memory_stats()
+    assert during.live_bytes - before.live_bytes == 256 * 256 * 4
+    assert during.live_allocations - before.live_allocations == 1
+    assert during.allocations - before.allocations == 1
+    assert during.peak_bytes >= during.live_bytes
+
+    del tensor
+    after = nope.memory_stats()
+    assert after.live_bytes == before.live_bytes
+    assert after.live_allocations == before.live_allocations
+
+
+def test_external_buffers_are_accounted_separately() -> None:
+    array = np.zeros((128, 8), dtype=np.float64)
+    before = nope.memory_stats()
+    tensor = nope.Tensor(array)
+    during = nope.memory_stats()
+    assert during.external_bytes - before.external_bytes == array.nbytes
+    assert during.owned_bytes == before.owned_bytes
+    del tensor
+    assert nope.memory_stats().external_bytes == before.external_bytes
+
+
+def test_peak_is_reset_to_live_bytes() -> None:
+    tensor = nope.random.uniform((1024, 64), seed=2)
+    del tensor
+    assert nope.memory_stats().peak_bytes > nope.memory_stats().live_bytes
+    nope.reset_peak_memory_stats()
+    stats = nope.memory_stats()
+    assert stats.peak_bytes == stats.live_bytes
+
+
+def test_nested_tags() -> None:
+    with nope.memory_tag("test_outer"):
+        outer = nope.random.uniform((16,), seed=0)
+        with nope.memory_tag("test_inner"):
+            inner = nope.random.randint((32,), 0, 10, seed=0)
+        after_inner = nope.random.uniform((8,), seed=0)
+
+    assert nope.memory_stats("test_outer").live_bytes == (16 + 8) * 4
+    assert nope.memory_stats("test_outer").live_allocations == 2
+    assert nope.memory_stats("test_inner").live_bytes == 32 * 8
+    assert "test_inner" in nope.memory_stats_by_tag()
+
+    # Storage stays attributed to its tag until released
+    del outer, inner, after_inner
+    assert nope.memory_stats("test_outer").live_bytes == 0
+    assert nope.memory_stats("test_outer").peak_bytes == (16 + 8) * 4
+    assert nope.memory_stats("test_never_used").allocations == 0
+
+
+def test_debug_mode_records_allocation_sites() -> None:
+    nope.set_memory_debug(True)
+    try:
+        assert nope.is_memory_debug_enabled()
+        with nope.memory_tag("test_debug"):
+            leaked = nope.random.uniform((4, 4), seed=3)
+        records = [record for record in nope.live_allocations()
+                   if record.tag == "test_debug"]
+        assert len(records) == 1
+        assert records[0].bytes == 4 * 4 * 4
+        assert not records[0].external
+        assert "test_debug_mode_records_allocation_sites" in records[0].site
+
+        del leaked
+        assert all(record.tag != "test_debug"
+                   for record in nope.live_allocations())
+    finally:
+        nope.set_memory_debug(False)
+    assert not nope.is_memory_debug_enabled()
+    assert nope.live_allocations() == []
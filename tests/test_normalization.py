@@ -0,0 +1,123 @@
+import pytest
+import numpy as np
+
+import nope
+
+TYPES_SET = (np.float32, np.float64)
+
+SHAPES_SET = ((1, ), (1000, ), (37, 70), (5, 3, 513), (4, 2049), (0, 7))
+
+
+def _softmax(x: np.ndarray) -> np.ndarray:
+    shifted = x - x.max(axis=-1, keepdims=True)
+    exponents = np.exp(shifted)
+    return exponents / exponents.sum(axis=-1, keepdims=True)
+
+
+def _log_softmax(x: np.ndarray) -> np.ndarray:
+    shifted = x - x.max(axis=-1, keepdims=True)
+    return shifted - np.log(np.exp(shifted).sum(axis=-1, keepdims=True))
+
+
+def _layer_norm(x: np.ndarray, gamma=None, beta=None, eps: float = 1e-5) -> np.ndarray:
+    mean = x.mean(axis=-1, keepdims=True)
+    result = (x - mean) / np.sqrt(x.var(axis=-1, keepdims=True) + eps)
+    if gamma is not None:
+        result = result * gamma
+    if beta is not None:
+        result = result + beta
+    return result
+
+
+def _tolerance(dtype) -> dict:
+    return {"rtol": 1e-5, "atol": 1e-5} if dtype == np.float32 else {"rtol": 1e-12}
+
+
+@pytest.mark.parametrize("dtype", TYPES_SET)
+@pytest.mark.parametrize("shape", SHAPES_SET)
+def test_softmax(dtype, shape) -> None:
+    x = np.random.default_rng(0).normal(scale=10, size=shape).astype(dtype)
+    expected = x.astype(np.float64)
+
+    np.testing.assert_allclose(nope.softmax(x), _softmax(expected), **_tolerance(dtype))
+    np.testing.assert_allclose(nope.log_softmax(x), _log_softmax(expected),
+                               **_tolerance(dtype))
+
+
+@pytest.mark.parametrize("dtype", TYPES_SET)
+@pytest.mark.parametrize("shape", SHAPES_SET)
+def test_layer_norm(dtype, shape) -> None:
+    rng = np.random.default_rng(1)
+    x = rng.normal(loc=100, size=shape).astype(dtype)
+    gamma = rng.uniform(0.5, 2, size=shape[-1]).astype(dtype)
+    beta = rng.normal(size=shape[-1]).astype(dtype)
+    expected = x.astype(np.float64)
+
+    np.testing.assert_allclose(nope.layer_norm(x, gamma, beta),
+                               _layer_norm(expected, gamma, beta), **_tolerance(dtype))
+    np.testing.assert_allclose(nope.layer_norm(x, beta=beta, eps=0.1),
+                               _layer_norm(expected, beta=beta, eps=0.1),
+                               **_tolerance(dtype))
+    np.testing.assert_allclose(nope.layer_norm(x), _layer_norm(expected),
+                               **_tolerance(dtype))
+
+
+@pytest.mark.parametrize("mean", (1e2, 1e4, 1e6))
+def test_layer_norm_large_mean(mean) -> None:
+    std = max(0.01, mean * 1e-6)
+    x = np.random.default_rng(4).normal(mean, std, size=(4, 1000)).astype(np.float32)
+
+    np.testing.assert_allclose(nope.layer_norm(x, eps=0.0),
+                               _layer_norm(x.astype(np.float64), eps=0.0), atol=1e-5)
+
+
+def test_strided_rows() -> None:
+    rng = np.random.default_rng(2)
+    x = rng.normal(size=(700, 30)).T
+    gamma = rng.normal(size=(30, 1))
+
+    np.testing.assert_allclose(nope.softmax(x), _softmax(x))
+    np.testing.assert_allclose(nope.softmax(x[:, ::3]), _softmax(x[:, ::3]))
+    np.testing.assert_allclose(nope.layer_norm(x, gamma), _layer_norm(x, gamma))
+
+    out = np.zeros((700, 30)).T
+    nope.log_softmax(x, out=nope.Tensor(out))
+    np.testing.assert_allclose(out, _log_softmax(x))
+    out = np.zeros((30, 700))
+    assert nope.layer_norm(x, gamma, out=out) is out
+    np.testing.assert_allclose(out, _layer_norm(x, gamma))
+
+
+def test_in_place() -> None:
+    base = np.random.default_rng(3).normal(size=(16, 300))
+
+    tensor = nope.Tensor(base.copy())
+    nope.softmax(tensor, out=tensor)
+    np.testing.assert_allclose(tensor, _softmax(base))
+
+    tensor = nope.Tensor(base.copy())
+    nope.layer_norm(tensor, out=tensor)
+    np.testing.assert_allclose(tensor, _layer_norm(base))
+
+
+def test_special_values() -> None:
+    x = np.array([[-np.inf, 0.0, np.inf], [-np.inf, 1.0, 2.0], [0.0, np.nan, 1.0]])
+    actual = np.asarray(nope.softmax(x))
+
+    assert np.isnan(actual[0]).all()
+    np.testing.assert_allclose(actual[1], _softmax(x[1]))
+    assert np.isnan(actual[2]).all()
+
+
+def test_errors() -> None:
+    x = np.zeros((3, 4), dtype=np.float32)
+    with pytest.raises(RuntimeError):
+        nope.softmax(np.zeros(4, dtype=np.int32))
+    with pytest.raises(RuntimeError):
+        nope.layer_norm(x, np.ones(4))
+    with pytest.raises(ValueError):
+        nope.log_softmax(np.array(1.0))
+    with pytest.raises(ValueError):
+        nope.layer_norm(x, beta=np.ones(3, dtype=np.float32))
+    with pytest.raises(ValueError):
+        nope.softmax(x, out=nope.Tensor(np.zeros((4, 3), dtype=np.float32)))
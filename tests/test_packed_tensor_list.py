@@ -0,0 +1,104 @@
+import pytest
+import numpy as np
+
+import nope
+
+
+def make_items(lengths, dtype=np.float32):
+    rng = np.random.default_rng(0)
+    return [rng.uniform(-10, 10, size=(length, 3)).astype(dtype)
+            for length in lengths]
+
+
+LENGTHS = (5, 0, 17, 1, 40000, 3)
+
+
+def test_items_are_views_of_packed_data() -> None:
+    items = make_items(LENGTHS)
+    packed = nope.PackedTensorList(items)
+    assert len(packed) == len(items)
+    assert packed.shapes == [item.shape for item in items]
+    assert packed.offsets == list(np.cumsum([0] + [item.size for item in items]))
+
+    data = np.asarray(packed.data)
+    np.testing.assert_array_equal(data,
+                                  np.concatenate([item.ravel() for item in items]))
+    for i, item in enumerate(items):
+        np.testing.assert_array_equal(np.asarray(packed[i]), item)
+    np.testing.assert_array_equal(np.asarray(packed[-1]), items[-1])
+
+    view = np.asarray(packed[0])
+    view[0, 0] = 42
+    assert np.asarray(packed.data)[0] == 42
+
+    with pytest.raises(IndexError):
+        packed[len(items)]
+
+
+def test_non_contiguous_items_are_packed() -> None:
+    base = np.arange(60, dtype=np.int64).reshape(6, 10)
+    items = [base[::2, 1::3], base[1:3, :].T]
+    packed = nope.PackedTensorList(items)
+    for i, item in enumerate(items):
+        np.testing.assert_array_equal(np.asarray(packed[i]), item)
+
+
+def test_pack_errors() -> None:
+    with pytest.raises(ValueError):
+        nope.PackedTensorList([np.zeros((2, 3)), np.zeros(4)])
+    with pytest.raises(RuntimeError):
+        nope.PackedTensorList([np.zeros(2, np.float32), np.zeros(2, np.float64)])
+
+
+@pytest.mark.parametrize("padding_value", (0, -1))
+def test_to_padded(padding_value: int) -> None:
+    rng = np.random.default_rng(1)
+    items = [rng.integers(0, 100, size=shape, dtype=np.int32)
+             for shape in ((2, 5), (4, 1), (0, 3), (3, 3))]
+    padded = np.asarray(nope.PackedTensorList(items).to_padded(padding_value))
+
+    expected = np.full((4, 4, 5), padding_value, dtype=np.int32)
+    for i, item in enumerate(items):
+        expected[i, :item.shape[0], :item.shape[1]] = item
+    np.testing.assert_array_equal(padded, expected)
+
+
+@pytest.mark.parametrize("dtype", (np.float32, np.float64, np.int32))
+def test_per_item_reductions(dtype) -> None:
+    items = make_items(LENGTHS, dtype)
+    packed = nope.PackedTensorList(items)
+    sums = np.asarray(packed.sum())
+    assert sums.dtype == (np.int64 if dtype == np.int32 else dtype)
+    np.testing.assert_allclose(sums, [item.sum(dtype=np.float64) for item in items],
+                               rtol=1e-6)
+    with pytest.raises(ValueError):
+        packed.max()
+
+    non_empty = nope.PackedTensorList([item for item in items if item.size])
+    np.testing.assert_array_equal(np.asarray(non_empty.max()),
+                                  [item.max() for item in items if item.size])
+    np.testing.assert_array_equal(np.asarray(non_empty.min()),
+                                  [item.min() for item in items if item.size])
+    np.testing.assert_allclose(np.asarray(non_empty.mean()),
+                               [item.mean(dtype=np.float64)
+                                for item in items if item.size],
+                               rtol=1e-6)
+
+
+def test_elementwise_operations_keep_layout() -> None:
+    items = make_items(LENGTHS)
+    packed = nope.PackedTensorList(items)
+    other = nope.PackedTensorList([item * 2 for item in items])
+
+    for actual, expected in ((packed + other, [a + a * 2 for a in items]),
+                             (packed - other, [a - a * 2 for a in items]),
+                             (packed * 0.5, [a * 0.5 for a in items]),
+                             (1 + packed, [a + 1 for a in items]),
+                             (packed.maximum(other), [np.maximum(a, a * 2)
+                                                      for a in items])):
+        assert actual.has_same_layout(packed)
+        for i, item in enumerate(expected):
+            np.testing.assert_allclose(np.asarray(actual[i]), item, rtol=1e-6)
+
+    with pytest.raises(ValueError):
+        packed + nope.PackedTensorList(make_items((1, 2)))
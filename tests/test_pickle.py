@@ -0,0 +1,57 @@
+import pickle
+
+import pytest
+import numpy as np
+
+import nope
+
+
+PROTOCOLS = tuple(range(2, pickle.HIGHEST_PROTOCOL + 1))
+
+
+@pytest.mark.parametrize("protocol", PROTOCOLS)
+@pytest.mark.parametrize("dtype", (np.int8, np.uint16, np.int64, np.float32,
+                                   np.float64, np.bool_))
+def test_round_trip(protocol: int, dtype: type) -> None:
+    array = (np.arange(60) % 7).astype(dtype).reshape(3, 4, 5)
+    restored = pickle.loads(pickle.dumps(nope.Tensor(array), protocol))
+    assert restored.dtype == nope.Tensor(array).dtype
+    np.testing.assert_array_equal(np.asarray(restored), array)
+
+
+@pytest.mark.parametrize("protocol", PROTOCOLS)
+def test_view_keeps_base_storage_and_strides(protocol: int) -> None:
+    base = nope.Tensor(np.arange(100, dtype=np.float32).reshape(10, 10))
+    view = base.as_strided([3, 4], [80, 12], 44)
+    restored = pickle.loads(pickle.dumps(view, protocol))
+    assert restored.shape == [3, 4]
+    assert restored.strides == [80, 12]
+    assert restored.storage_offset == 44
+    np.testing.assert_array_equal(np.asarray(restored), np.asarray(view))
+
+
+def test_out_of_band_buffers_are_not_copied() -> None:
+    tensor = nope.Tensor(np.zeros((256, 256), dtype=np.float64))
+    buffers = []
+    data = pickle.dumps(tensor, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 1
+    assert len(data) < 1024
+
+    restored = pickle.loads(data, buffers=buffers)
+    np.asarray(restored)[0, 0] = 42.0
+    assert np.asarray(tensor)[0, 0] == 42.0
+
+
+def test_negative_strides_keep_layout() -> None:
+    array = np.arange(12, dtype=np.int32).reshape(3, 4)[::-1, ::2]
+    tensor = nope.Tensor(array)
+    assert tensor.storage_offset == 32
+    restored = pickle.loads(pickle.dumps(tensor, protocol=5))
+    assert restored.strides == [-16, 8]
+    assert restored.storage_offset == 32
+    np.testing.assert_array_equal(np.asarray(restored), array)
+
+
+def test_data_type_round_trip() -> None:
+    for dtype in (nope.int8, nope.float64, nope.bool_):
+        assert pickle.loads(pickle.dumps(dtype)) == dtype
@@ -0,0 +1,186 @@
+import math
+import pickle
+
+import pytest
+import numpy as np
+
+import nope
+
+DTYPES = ((np.int8, nope.int8, 0), (np.uint8, nope.uint8, 128))
+
+
+def reference_quantize(values, scales, zero_points, dtype):
+    info = np.iinfo(dtype)
+    quantized = np.rint(values.astype(np.float64) / scales) + zero_points
+    return np.clip(quantized, info.min, info.max)
+
+
+def reference_dequantize(values, scales, zero_points):
+    return scales * (values.astype(np.float64) - zero_points)
+
+
+def assert_within_one(actual, expected) -> None:
+    assert np.abs(np.asarray(actual).astype(np.float64) - expected).max() <= 1
+
+
+@pytest.mark.parametrize("np_dtype,dtype,zero_point", DTYPES)
+def test_per_tensor_round_trip(np_dtype, dtype, zero_point) -> None:
+    params = nope.QuantizationParams.per_tensor(0.05, zero_point)
+    values = np.random.default_rng(0).normal(0, 3, size=(17, 33)).astype(np.float32)
+
+    quantized = nope.quantize(values, params, dtype)
+    assert quantized.dtype == dtype
+    assert quantized.quantization == params
+    assert_within_one(quantized, reference_quantize(values, 0.05, zero_point, np_dtype))
+
+    restored = np.asarray(nope.dequantize(quantized))
+    assert restored.dtype == np.float32
+    np.testing.assert_allclose(
+        restored,
+        reference_dequantize(np.asarray(quantized), 0.05, zero_point),
+        rtol=1e-6)
+
+
+@pytest.mark.parametrize("np_dtype,dtype,zero_point", DTYPES)
+def test_per_axis_quantization(np_dtype, dtype, zero_point) -> None:
+    scales = [0.01 * (c + 1) for c in range(5)]
+    zero_points = [zero_point + c - 2 for c in range(5)]
+    params = nope.QuantizationParams.per_axis(scales, zero_points, axis=1)
+    values = np.random.default_rng(1).normal(0, 1, size=(3, 5, 7))
+
+    quantized = nope.quantize(values, params, dtype)
+    channel_scales = np.array(scales).reshape(1, 5, 1)
+    channel_zero_points = np.array(zero_points).reshape(1, 5, 1)
+    assert_within_one(quantized, reference_quantize(values, channel_scales,
+                                                    channel_zero_points, np_dtype))
+    np.testing.assert_allclose(
+        np.asarray(nope.dequantize(quantized)),
+        reference_dequantize(np.asarray(quantized), channel_scales,
+                             channel_zero_points),
+        rtol=1e-6)
+
+
+@pytest.mark.parametrize("np_dtype,dtype,zero_point", DTYPES)
+@pytest.mark.parametrize("scales", ((0.1, 0.05, 0.12), (1.0, 1.0, 1.0),
+                                    (0.02, 0.3, 0.01)))
+def test_quantized_arithmetic(np_dtype, dtype, zero_point, scales) -> None:
+    lhs_scale, rhs_scale, out_scale = scales
+    info = np.iinfo(np_dtype)
+    rng = np.random.default_rng(2)
+    lhs = nope.Tensor(rng.integers(info.min, info.max + 1, size=(9, 1000),
+                                   dtype=np_dtype))
+    rhs = nope.Tensor(rng.integers(info.min, info.max + 1, size=(9, 1000),
+                                   dtype=np_dtype))
+    lhs.set_quantization(nope.QuantizationParams.per_tensor(lhs_scale, zero_point + 3))
+    rhs.set_quantization(nope.QuantizationParams.per_tensor(rhs_scale, zero_point - 5))
+    out_params = nope.QuantizationParams.per_tensor(out_scale, zero_point + 1)
+
+    lhs_real = reference_dequantize(np.asarray(lhs), lhs_scale, zero_point + 3)
+    rhs_real = reference_dequantize(np.asarray(rhs), rhs_scale, zero_point - 5)
+    total = nope.quantized_add(lhs, rhs, out_params)
+    assert total.quantization == out_params
+    assert_within_one(total, reference_quantize(lhs_real + rhs_real, out_scale,
+                                                zero_point + 1, np_dtype))
+    product = nope.quantized_mul(lhs, rhs, out_params)
+    assert_within_one(product, reference_quantize(lhs_real * rhs_real, out_scale,
+                                                  zero_point + 1, np_dtype))
+
+
+def round_half_away(value: float) -> int:
+    magnitude = int(math.floor(abs(value) + 0.5))
+    return magnitude if value >= 0 else -magnitude
+
+
+def requantized_add(lhs, rhs, lhs_params, rhs_params, out_params, dtype):
+    """16-bit fixed point multipliers with the largest shift keeping both of them
+    within 16 bits, the sum is shifted with rounding half up."""
+    (lhs_scale, lhs_zp), (rhs_scale, rhs_zp), (out_scale, out_zp) = (
+        lhs_params, rhs_params, out_params)
+    lhs_ratio = float(np.float32(lhs_scale)) / float(np.float32(out_scale))
+    rhs_ratio = float(np.float32(rhs_scale)) / float(np.float32(out_scale))
+    max_ratio = max(lhs_ratio, rhs_ratio)
+    shift = 0
+    while shift < 30 and round_half_away(math.ldexp(max_ratio, shift + 1)) <= 32767:
+        shift += 1
+    lhs_multiplier = round_half_away(math.ldexp(lhs_ratio, shift))
+    rhs_multiplier = round_half_away(math.ldexp(rhs_ratio, shift))
+    rounding = 1 << (shift - 1) if shift > 0 else 0
+    acc = (lhs_multiplier * (lhs.astype(np.int64) - lhs_zp)
+           + rhs_multiplier * (rhs.astype(np.int64) - rhs_zp) + rounding)
+    info = np.iinfo(dtype)
+    return np.clip((acc >> shift) + out_zp, info.min, info.max).astype(dtype)
+
+
+def requantized_mul(lhs, rhs, lhs_params, rhs_params, out_params, dtype):
+    """Exact product of zero point adjusted values scaled in single precision,
+    clamped to the result range and rounded to the nearest even."""
+    (lhs_scale, lhs_zp), (rhs_scale, rhs_zp), (out_scale, out_zp) = (
+        lhs_params, rhs_params, out_params)
+    scale = np.float32(float(np.float32(lhs_scale)) * float(np.float32(rhs_scale))
+                       / float(np.float32(out_scale)))
+    product = (lhs.astype(np.int32) - lhs_zp) * (rhs.astype(np.int32) - rhs_zp)
+    info = np.iinfo(dtype)
+    value = np.clip(product.astype(np.float32) * scale,
+                    np.float32(info.min - out_zp), np.float32(info.max - out_zp))
+    return (np.rint(value).astype(np.int32) + out_zp).astype(dtype)
+
+
+@pytest.mark.parametrize("np_dtype,dtype,zero_point", DTYPES)
+@pytest.mark.parametrize("scales", ((0.1, 0.05, 0.12), (1.0, 1.0, 1.0),
+                                    (0.02, 0.3, 0.01), (0.7, 0.003, 0.05)))
+@pytest.mark.parametrize("length", (1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 77, 1003))
+def test_quantized_arithmetic_is_exact(np_dtype, dtype, zero_point, scales,
+                                       length) -> None:
+    # Lengths cover vector bodies of every kernel width with and without tails
+    lhs_scale, rhs_scale, out_scale = scales
+    info = np.iinfo(np_dtype)
+    rng = np.random.default_rng(length)
+    lhs_values = rng.integers(info.min, info.max + 1, size=length, dtype=np_dtype)
+    rhs_values = rng.integers(info.min, info.max + 1, size=length, dtype=np_dtype)
+    params = ((lhs_scale, zero_point + 3), (rhs_scale, zero_point - 5),
+              (out_scale, zero_point + 1))
+    lhs = nope.Tensor(lhs_values)
+    rhs = nope.Tensor(rhs_values)
+    lhs.set_quantization(nope.QuantizationParams.per_tensor(*params[0]))
+    rhs.set_quantization(nope.QuantizationParams.per_tensor(*params[1]))
+    out_params = nope.QuantizationParams.per_tensor(*params[2])
+
+    np.testing.assert_array_equal(
+        np.asarray(nope.quantized_add(lhs, rhs, out_params)),
+        requantized_add(lhs_values, rhs_values, *params, np_dtype))
+    np.testing.assert_array_equal(
+        np.asarray(nope.quantized_mul(lhs, rhs, out_params)),
+        requantized_mul(lhs_values, rhs_values, *params, np_dtype))
+
+
+def test_quantization_validation() -> None:
+    tensor = nope.Tensor(np.zeros((3, 4), dtype=np.int8))
+    assert tensor.quantization is None
+    with pytest.raises(RuntimeError):
+        nope.Tensor(np.zeros(3, np.float32)).set_quantization(
+            nope.QuantizationParams.per_tensor(1.0))
+    with pytest.raises(IndexError):
+        tensor.set_quantization(nope.QuantizationParams.per_tensor(1.0, 200))
+    with pytest.raises(ValueError):
+        tensor.set_quantization(nope.QuantizationParams.per_axis([1, 2], [0, 0], 1))
+    with pytest.raises(ValueError):
+        tensor.set_quantization(nope.QuantizationParams.per_tensor(0.0))
+    with pytest.raises(ValueError):
+        nope.dequantize(tensor)
+
+    tensor.set_quantization(nope.QuantizationParams.per_tensor(1.0))
+    with pytest.raises(ValueError):
+        nope.quantized_add(tensor, tensor, nope.QuantizationParams.per_tensor(1e-6))
+    tensor.clear_quantization()
+    assert tensor.quantization is None
+
+
+@pytest.mark.parametrize("protocol", (2, pickle.HIGHEST_PROTOCOL))
+def test_pickle_keeps_quantization(protocol: int) -> None:
+    params = nope.QuantizationParams.per_axis([0.5, 0.25, 0.125], [1, 2, 3], 0)
+    assert pickle.loads(pickle.dumps(params, protocol)) == params
+
+    tensor = nope.quantize(np.ones((3, 2), np.float32), params, nope.uint8)
+    restored = pickle.loads(pickle.dumps(tensor, protocol))
+    assert restored.quantization == params
+    np.testing.assert_array_equal(np.asarray(restored), np.asarray(tensor))
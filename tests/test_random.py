@@ -0,0 +1,101 @@
+from __future__ import annotations
+
+import pytest
+import numpy as np
+
+import nope
+
+
+FLOAT_TYPES = (nope.float32, nope.float64)
+SHAPE = (301, 1001)
+
+
+@pytest.fixture
+def restore_num_threads():
+    num_threads = nope.get_num_threads()
+    yield
+    nope.set_num_threads(num_threads)
+
+
+@pytest.mark.parametrize("dtype", FLOAT_TYPES, ids=str)
+def test_uniform_range_and_moments(dtype: nope.TensorDataType) -> None:
+    values = np.asarray(nope.random.uniform(SHAPE, -2.0, 3.0, dtype, seed=1))
+    assert values.shape == SHAPE
+    assert values.min() >= -2.0 and values.max() < 3.0
+    assert abs(values.mean() - 0.5) < 0.02
+    assert abs(values.var() - 25.0 / 12.0) < 0.02
+
+
+@pytest.mark.parametrize("dtype", FLOAT_TYPES, ids=str)
+def test_normal_moments(dtype: nope.TensorDataType) -> None:
+    values = np.asarray(nope.random.normal(SHAPE, 1.0, 2.0, dtype, seed=2))
+    assert np.all(np.isfinite(values))
+    assert abs(values.mean() - 1.0) < 0.02
+    assert abs(values.std() - 2.0) < 0.02
+
+
+@pytest.mark.parametrize("dtype", (nope.int8, nope.uint16, nope.int64), ids=str)
+def test_randint_covers_range(dtype: nope.TensorDataType) -> None:
+    values = np.asarray(nope.random.randint(SHAPE, 0, 10, dtype, seed=3))
+    counts = np.bincount(values.ravel().astype(np.int64), minlength=10)
+    assert len(counts) == 10
+    np.testing.assert_allclose(counts / values.size, 0.1, atol=0.005)
+
+
+def test_uniform_excludes_high_after_rounding() -> None:
+    # Float32 spacing at 2**24 is 2, so unclamped values round up to high
+    values = np.asarray(nope.random.uniform(SHAPE, 2.0**24, 2.0**24 + 2,
+                                            nope.float32, seed=6))
+    assert values.max() < 2.0**24 + 2
+
+
+@pytest.mark.parametrize("high", (7, 3 * 2**30, 3 * 2**40))
+def test_randint_is_unbiased(high: int) -> None:
+    values = np.asarray(nope.random.randint(SHAPE, 0, high, nope.int64, seed=7))
+    assert values.min() >= 0 and values.max() < high
+    # Multiply-shift without rejection maps twice as many words to multiples
+    # of 3 for the large ranges
+    buckets = 7 if high == 7 else 3
+    counts = np.bincount(values.ravel() % buckets, minlength=buckets)
+    expected = values.size / buckets
+    chi_square = ((counts - expected)**2 / expected).sum()
+    # 0.999 quantile of chi-square distribution with 6 degrees of freedom bounds
+    # the smaller number of buckets too
+    assert chi_square < 22.46
+
+
+def test_randint_invalid_range() -> None:
+    with pytest.raises(IndexError):
+        nope.random.randint((10,), 5, 5)
+    with pytest.raises(IndexError):
+        nope.random.randint((10,), 0, 257, nope.uint8)
+    with pytest.raises(RuntimeError):
+        nope.random.uniform((10,), dtype=nope.int32)
+
+
+@pytest.mark.parametrize("generate", (
+    lambda: nope.random.uniform(SHAPE, seed=42),
+    lambda: nope.random.normal(SHAPE, dtype=nope.float64, seed=42),
+    lambda: nope.random.randint(SHAPE, -1000, 1000, seed=42),
+))
+def test_reproducible_for_any_thread_count(generate,
+                                           restore_num_threads) -> None:
+    nope.set_num_threads(1)
+    expected = np.asarray(generate())
+    for num_threads in (2, 3, 8):
+        nope.set_num_threads(num_threads)
+        np.testing.assert_array_equal(np.asarray(generate()), expected)
+
+
+def test_seeds_produce_different_values() -> None:
+    lhs = np.asarray(nope.random.uniform((1000,), seed=0))
+    rhs = np.asarray(nope.random.uniform((1000,), seed=1))
+    assert not np.array_equal(lhs, rhs)
+
+
+def test_inplace_fill_of_strided_tensor() -> None:
+    expected = np.asarray(nope.random.uniform((50, 40), seed=5))
+    array = np.zeros((40, 50), dtype=np.float32).T
+    tensor = nope.Tensor(array)
+    nope.random.uniform_(tensor, seed=5)
+    np.testing.assert_array_equal(np.asarray(tensor), expected)
@@ -0,0 +1,110 @@
+import multiprocessing
+
+import pytest
+import numpy as np
+
+import nope
+
+
+def _fill(tensor: nope.Tensor, value: float) -> None:
+    np.asarray(tensor)[...] = value
+
+
+def _produce(queue, shape) -> None:
+    tensor = nope.empty_shared(shape, nope.float64)
+    np.asarray(tensor)[...] = np.arange(np.prod(shape)).reshape(shape)
+    queue.put(tensor)
+    # Keep producer alive until the consumer maps the segment
+    queue.get()
+
+
+def _quantized() -> nope.Tensor:
+    values = np.linspace(-1.0, 1.0, 60, dtype=np.float32).reshape(6, 10)
+    params = nope.QuantizationParams.per_axis([0.01 * (i + 1) for i in range(6)],
+                                              list(range(-3, 3)), 0)
+    return nope.quantize(values, params, nope.int8)
+
+
+def _produce_quantized(queue) -> None:
+    queue.put(_quantized())
+    queue.get()
+
+
+@pytest.fixture(scope="module")
+def spawn_context():
+    return multiprocessing.get_context("spawn")
+
+
+def test_empty_shared() -> None:
+    tensor = nope.empty_shared((3, 4), nope.int32)
+    assert nope.is_shared_memory(tensor)
+    assert tensor.shape == [3, 4]
+    assert tensor.is_contiguous
+    assert not nope.is_shared_memory(nope.Tensor(np.zeros(3)))
+
+
+def test_to_shared_memory_copies_once() -> None:
+    array = np.arange(24, dtype=np.float32).reshape(4, 6).T
+    shared = nope.to_shared_memory(nope.Tensor(array))
+    assert nope.is_shared_memory(shared)
+    np.testing.assert_array_equal(np.asarray(shared), array)
+
+    same = nope.to_shared_memory(shared)
+    np.asarray(same)[0, 0] = -1
+    assert np.asarray(shared)[0, 0] == -1
+
+
+def test_child_writes_are_visible_in_parent(spawn_context) -> None:
+    tensor = nope.empty_shared((100, 10), nope.float32)
+    np.asarray(tensor)[...] = 0
+    process = spawn_context.Process(target=_fill, args=(tensor, 7.0))
+    process.start()
+    process.join()
+    assert process.exitcode == 0
+    assert np.all(np.asarray(tensor) == 7.0)
+
+
+def test_tensor_is_received_through_queue(spawn_context) -> None:
+    shape = (64, 32)
+    queue = spawn_context.Queue()
+    process = spawn_context.Process(target=_produce, args=(queue, shape))
+    process.start()
+    tensor = queue.get(timeout=60)
+    queue.put(None)
+    process.join()
+    assert nope.is_shared_memory(tensor)
+    np.testing.assert_array_equal(np.asarray(tensor),
+                                  np.arange(np.prod(shape)).reshape(shape))
+
+
+def test_views_keep_layout(spawn_context) -> None:
+    base = nope.empty_shared((10, 10), nope.int64)
+    values = np.asarray(base)
+    values[...] = 0
+    # Rows 2, 4, 6 and columns 1, 4, 7
+    view = base.as_strided([3, 3], [160, 24], 2 * 80 + 8)
+    process = spawn_context.Process(target=_fill, args=(view, 5))
+    process.start()
+    process.join()
+    expected = np.zeros((10, 10), dtype=np.int64)
+    expected[2:8:2, 1::3] = 5
+    np.testing.assert_array_equal(values, expected)
+
+
+def test_to_shared_memory_keeps_quantization() -> None:
+    tensor = _quantized()
+    shared = nope.to_shared_memory(tensor)
+    assert shared.quantization == tensor.quantization
+    np.testing.assert_array_equal(np.asarray(shared), np.asarray(tensor))
+
+
+def test_quantized_tensor_is_received_through_queue(spawn_context) -> None:
+    queue = spawn_context.Queue()
+    process = spawn_context.Process(target=_produce_quantized, args=(queue,))
+    process.start()
+    tensor = queue.get(timeout=60)
+    queue.put(None)
+    process.join()
+    expected = _quantized()
+    assert tensor.quantization == expected.quantization
+    np.testing.assert_array_equal(np.asarray(tensor), np.asarray(expected))
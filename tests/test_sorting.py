@@ -0,0 +1,93 @@
+from __future__ import annotations
+
+import pytest
+import numpy as np
+
+import nope
+
+
+VALUE_TYPES = (np.int8, np.uint16, np.int32, np.int64, np.float32, np.float64)
+SHAPES = ((1000,), (7, 300), (3, 4, 50))
+
+
+def make_tensor(shape: tuple[int, ...], dtype: type) -> np.ndarray:
+    rng = np.random.default_rng(42)
+    if np.issubdtype(dtype, np.floating):
+        return rng.normal(size=shape).astype(dtype)
+    info = np.iinfo(dtype)
+    return rng.integers(info.min, info.max, size=shape, dtype=dtype,
+                        endpoint=True)
+
+
+@pytest.mark.parametrize("dtype", VALUE_TYPES)
+@pytest.mark.parametrize("shape", SHAPES, ids=str)
+def test_sort_matches_numpy(dtype: type, shape: tuple[int, ...]) -> None:
+    src = make_tensor(shape, dtype)
+    for axis in range(-len(shape), len(shape)):
+        actual = np.asarray(nope.sort(nope.Tensor(src), axis))
+        np.testing.assert_array_equal(actual, np.sort(src, axis=axis))
+
+
+@pytest.mark.parametrize("dtype", VALUE_TYPES)
+@pytest.mark.parametrize("shape", SHAPES, ids=str)
+def test_argsort_is_stable(dtype: type, shape: tuple[int, ...]) -> None:
+    src = make_tensor(shape, dtype) % 7
+    actual = np.asarray(nope.argsort(nope.Tensor(src), -1))
+    np.testing.assert_array_equal(actual,
+                                  np.argsort(src, axis=-1, kind="stable"))
+
+
+def test_sort_descending() -> None:
+    src = make_tensor((5, 400), np.float32)
+    actual = np.asarray(nope.sort(nope.Tensor(src), 1, descending=True))
+    np.testing.assert_array_equal(actual, -np.sort(-src, axis=1))
+
+
+def test_sort_non_contiguous_axis() -> None:
+    src = make_tensor((300, 6), np.float64).T[:, ::2]
+    actual = np.asarray(nope.sort(nope.Tensor(src), 1))
+    np.testing.assert_array_equal(actual, np.sort(src, axis=1))
+
+
+def test_sort_puts_nan_last() -> None:
+    src = np.array([3.0, np.nan, -np.inf, 0.5, np.inf, -1.0], dtype=np.float32)
+    actual = np.asarray(nope.sort(nope.Tensor(src)))
+    np.testing.assert_array_equal(actual, np.sort(src))
+
+
+@pytest.mark.parametrize("dtype", (np.float32, np.float64))
+@pytest.mark.parametrize("size", (8, 600))
+def test_sort_keeps_signed_zeros_and_nan_payloads(dtype: type, size: int) -> None:
+    uint = np.uint32 if dtype == np.float32 else np.uint64
+    payload_nan = (np.array(np.nan, dtype=dtype).view(uint) | uint(5)).view(dtype)
+    special = np.array([-0.0, 0.0, -np.nan, payload_nan, 1.0, -0.0], dtype=dtype)
+    src = np.resize(special, size)
+
+    actual = np.asarray(nope.sort(nope.Tensor(src)))
+    np.testing.assert_array_equal(actual.view(uint),
+                                  np.sort(src, kind="stable").view(uint))
+
+    values, indices = nope.topk(nope.Tensor(src), 3, largest=False)
+    np.testing.assert_array_equal(np.asarray(values).view(uint),
+                                  src[np.asarray(indices)].view(uint))
+    assert np.signbit(np.asarray(values)).tolist() == [True, False, True]
+
+
+@pytest.mark.parametrize("k", (1, 5, 64, 1000))
+@pytest.mark.parametrize("largest", (True, False))
+def test_topk(k: int, largest: bool) -> None:
+    src = make_tensor((4, 1000), np.float32)
+    values, indices = nope.topk(nope.Tensor(src), k, -1, largest)
+
+    order = np.argsort(-src if largest else src, axis=-1, kind="stable")
+    expected_indices = order[:, :k]
+    np.testing.assert_array_equal(np.asarray(indices), expected_indices)
+    np.testing.assert_array_equal(
+        np.asarray(values), np.take_along_axis(src, expected_indices, axis=-1)
+    )
+
+
+def test_topk_rejects_too_large_k() -> None:
+    src = np.zeros((2, 3), dtype=np.float32)
+    with pytest.raises(IndexError):
+        nope.topk(nope.Tensor(src), 4)
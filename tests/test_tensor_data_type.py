@@ -1,4 +1,5 @@
 import pytest
+import numpy as np
 
 import nope
 
@@ -9,8 +10,11 @@ TENSOR_DATA_TYPE_NAMES = (
     "uint16",
     "int32",
     "uint32",
+    "int64",
+    "uint64",
     "float32",
-    "float64"
+    "float64",
+    "bool_"
 )
 
 
@@ -25,3 +29,22 @@ def test_tensor_data_type_is_available(type_name: str) -> None:
         f"Wrong type for {type_name}. Got: {type(dtype)}"
     assert dtype.size >= 1
     assert hasattr(dtype, "value")
+
+
+@pytest.mark.parametrize("lhs", TENSOR_DATA_TYPE_NAMES)
+@pytest.mark.parametrize("rhs", TENSOR_DATA_TYPE_NAMES)
+def test_promote_types_matches_numpy(lhs: str, rhs: str) -> None:
+    actual = nope.promote_types(getattr(nope, lhs), getattr(nope, rhs))
+    expected = np.promote_types(np.dtype(lhs), np.dtype(rhs))
+    expected_name = "bool_" if expected == np.bool_ else expected.name
+    assert actual == getattr(nope, expected_name), \
+        f"{lhs} and {rhs} are promoted to {actual}, expected: {expected}"
+
+
+@pytest.mark.parametrize("type_name", TENSOR_DATA_TYPE_NAMES)
+def test_tensor_from_buffer_has_matching_data_type(type_name: str) -> None:
+    array = np.zeros((2, 3), dtype=np.dtype(type_name))
+    tensor = nope.Tensor(array)
+    assert tensor.dtype == getattr(nope, type_name)
+    assert tensor.item_size == array.itemsize
+    assert np.asarray(tensor).dtype == array.dtype
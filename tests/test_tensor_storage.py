@@ -0,0 +1,25 @@
+import gc
+
+import pytest
+import numpy as np
+
+import nope
+
+
+@pytest.mark.parametrize("shape", ((1,), (3,), (17, 5), (64, 64), (1000, 3)))
+def test_owned_data_is_aligned(shape: tuple) -> None:
+    tensors = (nope.random.randint(shape, 0, 10, dtype=nope.int8, seed=1),
+               nope.random.uniform(shape, dtype=nope.float32, seed=1),
+               nope.random.uniform(shape, dtype=nope.float64, seed=1))
+    for tensor in tensors:
+        assert np.asarray(tensor).ctypes.data % 64 == 0
+
+
+def test_view_outlives_owning_tensor() -> None:
+    tensor = nope.random.uniform((8, 16), seed=3)
+    expected = np.asarray(tensor)[2:5, ::2].copy()
+    view = tensor.as_strided([3, 8], [64, 8], 2 * 64)
+    del tensor
+    gc.collect()
+    nope.random.uniform((8, 16), seed=4)
+    np.testing.assert_array_equal(np.asarray(view), expected)
@@ -0,0 +1,110 @@
+import pytest
+import numpy as np
+
+import nope
+
+TYPES_SET = (np.int8, np.uint8, np.int16, np.int32, np.uint32, np.int64, np.float32,
+             np.float64)
+
+SHAPES_SET = (
+    ((1000, ), (1000, ), (1000, )),
+    ((1000, ), (), (1000, )),
+    ((37, 70), (70, ), (37, 1)),
+    ((37, 70), (37, 1), ()),
+    ((5, 1, 33), (4, 33), (5, 4, 1)),
+    ((), (), ()),
+)
+
+
+@pytest.mark.parametrize("dtype", TYPES_SET)
+@pytest.mark.parametrize("shapes", SHAPES_SET)
+@pytest.mark.parametrize("mask_dtype", (np.bool_, np.uint8))
+def test_where(dtype, shapes, mask_dtype) -> None:
+    rng = np.random.default_rng(0)
+    mask = rng.integers(0, 3, size=shapes[0]).astype(mask_dtype)
+    a = rng.integers(-50, 50, size=shapes[1]).astype(dtype)
+    b = rng.integers(-50, 50, size=shapes[2]).astype(dtype)
+
+    np.testing.assert_array_equal(nope.where(mask, a, b), np.where(mask, a, b))
+
+
+@pytest.mark.parametrize("dtype", TYPES_SET)
+@pytest.mark.parametrize("shapes", SHAPES_SET)
+def test_clip(dtype, shapes) -> None:
+    rng = np.random.default_rng(1)
+    x = rng.integers(-100, 100, size=np.broadcast_shapes(*shapes)).astype(dtype)
+    lo = rng.integers(-60, 0, size=shapes[1]).astype(dtype)
+    hi = rng.integers(0, 60, size=shapes[2]).astype(dtype)
+
+    np.testing.assert_array_equal(nope.clip(x, lo, hi), np.clip(x, lo, hi))
+    np.testing.assert_array_equal(nope.clip(x, lo=lo), np.maximum(x, lo))
+    np.testing.assert_array_equal(nope.clip(x, hi=hi), np.minimum(x, hi))
+
+
+def test_clip_special_values() -> None:
+    x = np.array([np.nan, -np.inf, np.inf, 2.0, -3.0, 0.5], dtype=np.float32)
+    lo = np.array(-1.0, dtype=np.float32)
+    hi = np.array(1.0, dtype=np.float32)
+
+    np.testing.assert_array_equal(nope.clip(x, lo, hi), np.clip(x, lo, hi))
+
+    # NaN bounds are propagated, for contiguous and single value bounds
+    bounds = np.array([np.nan, -1.0, 1.0, np.nan, 0.0, 2.0], dtype=np.float32)
+    np.testing.assert_array_equal(nope.clip(x, bounds, hi), np.clip(x, bounds, hi))
+    np.testing.assert_array_equal(nope.clip(x, lo, bounds), np.clip(x, lo, bounds))
+    nan = np.array(np.nan, dtype=np.float32)
+    assert np.isnan(np.asarray(nope.clip(x, lo=nan))).all()
+    assert np.isnan(np.asarray(nope.clip(x, hi=nan))).all()
+
+    # Upper bound wins for empty ranges
+    np.testing.assert_array_equal(nope.clip(x[3:], np.array(5.0, dtype=np.float32), hi),
+                                  np.ones(3, dtype=np.float32))
+
+
+def test_out_and_in_place() -> None:
+    rng = np.random.default_rng(2)
+    base = rng.normal(size=(30, 40))
+    mask = rng.integers(0, 2, size=(40, 30)).astype(np.bool_)
+    b = np.zeros(30)
+
+    out = np.zeros((30, 40)).T
+    nope.where(mask, base.T, b, out=nope.Tensor(out))
+    np.testing.assert_array_equal(out, np.where(mask, base.T, b))
+
+    out = np.zeros((30, 40))
+    assert nope.clip(base, np.array(-0.5), np.array(0.5), out=out) is out
+    np.testing.assert_array_equal(out, np.clip(base, -0.5, 0.5))
+    assert nope.where(mask.T, base, np.array(0.0), out=out) is out
+    np.testing.assert_array_equal(out, np.where(mask.T, base, 0.0))
+
+    tensor = nope.Tensor(base.copy())
+    nope.clip(tensor, np.array(-0.5), np.array(0.5), out=tensor)
+    np.testing.assert_array_equal(tensor, np.clip(base, -0.5, 0.5))
+
+    tensor = nope.Tensor(base.copy())
+    nope.where(mask.T, tensor, np.array(0.0), out=tensor)
+    np.testing.assert_array_equal(tensor, np.where(mask.T, base, 0.0))
+
+
+def test_where_bool_values() -> None:
+    mask = np.array([True, False, True])
+    actual = np.asarray(
+        nope.where(mask, np.ones(3, dtype=np.bool_), np.zeros(1, dtype=np.bool_)))
+    assert actual.dtype == np.bool_
+    np.testing.assert_array_equal(actual, mask)
+
+
+def test_errors() -> None:
+    a = np.zeros(5, dtype=np.float32)
+    with pytest.raises(RuntimeError):
+        nope.where(np.ones(5, dtype=np.int32), a, a)
+    with pytest.raises(RuntimeError):
+        nope.where(np.ones(5, dtype=np.bool_), a, np.zeros(5))
+    with pytest.raises(ValueError):
+        nope.where(np.ones(4, dtype=np.bool_), a, a)
+    with pytest.raises(ValueError):
+        nope.clip(a)
+    with pytest.raises(RuntimeError):
+        nope.clip(a, np.zeros(5))
+    with pytest.raises(RuntimeError):
+        nope.clip(np.zeros(5, dtype=np.bool_), np.zeros(5, dtype=np.bool_))